@@ -5,6 +5,7 @@
 //
 
 #include "bytecode.h"
+#include "lzssvar.h"
 #include <vector>
 #include <cstdio>
 
@@ -46,7 +47,6 @@ private:
     static var_arg_printer print_arg (int arg) { return var_arg_printer (arg); }
 
     void lzss_unpack (sys::mapping::view<uint8_t>& output);
-    static void setup_lzss_frame (std::vector<uint8_t>& frame);
 };
 
 inline std::ostream& operator<< (std::ostream& os, const advb_reader::var_arg_printer& p)
@@ -76,7 +76,7 @@ unpack_script ()
     get_word();
     size_t unpacked_size = get_word();
     get_word();
-    sys::mapping::readwrite mem (sys::file_handle::invalid_handle(), sys::mapping::writeshare, unpacked_size);
+    sys::mapping::anonymous mem (unpacked_size);
     sys::mapping::view<uint8_t> unpacked (mem);
     lzss_unpack (unpacked);
     view.remap (mem, 0, unpacked_size);
@@ -305,65 +305,11 @@ get_string ()
     return arg;
 }
 
-void advb_reader::
-setup_lzss_frame (std::vector<uint8_t>& frame)
-{
-    frame.resize (0x1000);
-    size_t dst = 0;
-    for (int i = 0; i < 0x100; ++i)
-    {
-        for (int j = 0; j < 13; ++j)
-            frame[dst++] = i;
-    }
-    // 0xD00
-    for (int i = 0; i < 0x100; ++i)
-        frame[dst++] = i;
-    // 0xE00
-    for (int i = 0xFF; i >= 0; --i)
-        frame[dst++] = i;
-    // 0xF00
-    for (int i = 0; i < 0x80; ++i)
-        frame[dst++] = 0;
-    // 0xF80
-    for (int i = 0; i < 0x6E; ++i)
-        frame[dst++] = 0x20;
-}
-
 void advb_reader::
 lzss_unpack (sys::mapping::view<uint8_t>& output)
 {
-    std::vector<uint8_t> frame;
-    setup_lzss_frame (frame);
-    int frame_pos = 0xFEE;
-    const int frame_mask = 0xFFF;
-    size_t dst = 0;
-    uint8_t mask = 0;
-    uint8_t ctl;
-    while (pBytecode < view.end() && dst < output.size())
-    {
-        mask <<= 1;
-        if (!mask)
-        {
-            ctl = get_byte();
-            mask = 1;
-        }
-        if (ctl & mask)
-        {
-            output[dst++] = frame[frame_pos++ & frame_mask] = get_byte();
-        }
-        else
-        {
-            unsigned lo = get_byte();
-            unsigned hi = get_byte();
-            unsigned offset = (hi & 0xF0) << 4 | lo;
-            int count = std::min ((hi & 0xF) + 3, output.size() - dst);
-            while (count --> 0)
-            {
-                auto b = frame[offset++ & frame_mask];
-                output[dst++] = frame[frame_pos++ & frame_mask] = b;
-            }
-        }
-    }
+    bin::lzss_decoder<bin::advc_lzss> lzss (pBytecode, view.end() - pBytecode);
+    lzss.decode (output.data(), output.size());
 }
 
 int wmain (int argc, wchar_t* argv[])
@@ -5,6 +5,7 @@
 //
 
 #include "bytecode.h"
+#include "prsdec.h"
 #include <vector>
 #include <map>
 #include <cstdio>
@@ -91,7 +92,7 @@ unpack_script ()
     size_t packed_size = get_word();
     if (packed_size != view.size()-4)
         throw std::runtime_error ("invalid PRS script.");
-    sys::mapping::readwrite mem (sys::file_handle::invalid_handle(), sys::mapping::writeshare, unpacked_size);
+    sys::mapping::anonymous mem (unpacked_size);
     sys::mapping::view<uint8_t> unpacked (mem);
     prs_unpack (unpacked);
     view.remap (mem, 0, unpacked_size);
@@ -1033,47 +1034,8 @@ process_text ()
 void adviz_reader::
 prs_unpack (sys::mapping::view<uint8_t>& output)
 {
-    size_t dst = 0;
-    uint16_t mask = 0;
-    uint16_t ctl = 0;
-    while (pBytecode < view.end() && dst < output.size())
-    {
-        mask >>= 1;
-        if (!mask)
-        {
-            ctl = get_word();
-            mask = 0x8000;
-        }
-        if (!(ctl & mask))
-        {
-            output[dst++] = get_byte();
-        }
-        else
-        {
-            uint8_t byte = get_byte();
-            size_t count, off;
-            if (byte & 1)
-            {
-                byte >>= 1;
-                count = (byte >> 4) + 2;
-                off = (byte & 0xF) + 1;
-            }
-            else
-            {
-                size_t ax = get_byte() << 7 | byte >> 1;
-                count = ((ax >> 10) & 0x3F) + 2;
-                off = (ax & 0x3FF) + 1;
-            }
-            if (off >= dst)
-                throw std::runtime_error ("invalid compressed file");
-            count = std::min (count, output.size() - dst);
-            while (count --> 0)
-            {
-                output[dst] = output[dst-off];
-                ++dst;
-            }
-        }
-    }
+    bin::prs_decoder prs (pBytecode, view.end() - pBytecode);
+    prs.decode (output.data(), output.size());
 }
 
 int wmain (int argc, wchar_t* argv[])
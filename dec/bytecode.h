@@ -116,21 +116,28 @@ enum logging
     ll_none
 };
 
-class bytecode_reader
+// basic_bytecode_reader<CountPolicy>
+// CountPolicy selects reference counting of the script mapping, decompilers
+// that never share the script with other threads could use sys::plain_count.
+
+template <class CountPolicy = sys::atomic_count>
+class basic_bytecode_reader
 {
 protected:
-    sys::mapping::const_view<uint8_t> view;
+    typedef sys::mapping::basic_map_base<CountPolicy> map_type;
+
+    sys::mapping::const_view<uint8_t, CountPolicy> view;
     const uint8_t*              pBytecodeStart;
     const uint8_t*              pBytecode;
     logging                     m_log_level;
 
 protected:
-    bytecode_reader ()
+    basic_bytecode_reader ()
         : pBytecodeStart (nullptr)
         , m_log_level (ll_debug)
     { }
 
-    bytecode_reader (sys::mapping::map_base& in)
+    basic_bytecode_reader (map_type& in)
         : view (in)
         , pBytecodeStart (view.data())
         , m_log_level (ll_debug)
@@ -143,7 +150,7 @@ public:
         return do_run();
     }
 
-    void init (sys::mapping::map_base& in)
+    void init (map_type& in)
     {
         view.remap (in);
     }
@@ -230,4 +237,6 @@ protected:
     }
 };
 
+typedef basic_bytecode_reader<> bytecode_reader;
+
 #endif /* BYTECODE_H */
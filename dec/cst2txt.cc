@@ -8,8 +8,8 @@
 #include <fstream>
 #include <iomanip>
 #include <vector>
-#include <zlib.h>
 #include "sysmemmap.h"
+#include "zio.h"
 
 #pragma pack(push,1)
 struct CstHeader
@@ -65,27 +65,6 @@ extract_script (const uint8_t* src, size_t src_size, std::ostream& out)
     }
 }
 
-void
-uncompress_cst (const uint8_t* src, size_t src_size, std::vector<uint8_t>& out, size_t out_size)
-{
-    z_stream stream = { 0 };
-    stream.next_in = const_cast<uint8_t*> (src);
-    stream.avail_in = src_size;
-    out.resize (out_size);
-
-    int err = inflateInit (&stream);
-    if (err != Z_OK)
-        throw std::runtime_error ("zlib initialization error");
-
-    stream.next_out = out.data();
-    stream.avail_out = out.size();
-    err = inflate (&stream, Z_NO_FLUSH);
-    inflateEnd (&stream);
-
-    if (Z_STREAM_ERROR == err)
-        throw std::runtime_error ("invalid compressed stream");
-}
-
 int main (int argc, char* argv[])
 try
 {
@@ -106,7 +85,8 @@ try
     {
         size_t unpacked_size = *(const uint32_t*)&view[12];
         size_t packed_size = std::min<size_t> (*(const uint32_t*)&view[8], view.size()-0x10);
-        uncompress_cst (view.data()+0x10, packed_size, unpacked_cst, unpacked_size);
+        unpacked_cst.resize (unpacked_size);
+        unpacked_cst.resize (zio::inflate_to (view.data()+0x10, packed_size, unpacked_cst.data(), unpacked_size));
         cst_data = unpacked_cst.data();
         cst_size = unpacked_cst.size();
     }
@@ -35,7 +35,11 @@ private:
     }
 };
 
-class adv_bytecode_reader : public bytecode_reader
+// script is parsed by the main thread only, no need for atomic refcounting
+typedef basic_bytecode_reader<sys::plain_count> adv_reader_base;
+typedef sys::mapping::basic_readwrite<sys::plain_count> adv_script_map;
+
+class adv_bytecode_reader : public adv_reader_base
 {
     typedef fs::path::string_type   path_string_type;
     typedef std::ctype<path_string_type::value_type> facet_type;
@@ -52,19 +56,19 @@ class adv_bytecode_reader : public bytecode_reader
 
 public:
     adv_bytecode_reader ()
-        : bytecode_reader ()
+        : adv_reader_base ()
         , m_ctype (std::use_facet<facet_type> (std::locale()))
     { }
 
     // opcode D5 performs bytecode decryption in-place, hence readwrite requirement
-    adv_bytecode_reader (sys::mapping::readwrite& in)
-        : bytecode_reader (in)
+    adv_bytecode_reader (adv_script_map& in)
+        : adv_reader_base (in)
         , m_ctype (std::use_facet<facet_type> (std::locale()))
     { }
 
-    void init (sys::mapping::readwrite& in)
+    void init (adv_script_map& in)
     {
-        bytecode_reader::init (in);
+        adv_reader_base::init (in);
     }
 
 private:
@@ -73,7 +77,7 @@ private:
     const uint8_t* init () override
     {
         m_eof_opcode_reached = false;
-        return bytecode_reader::init();
+        return adv_reader_base::init();
     }
 
     int current_pos () const { return pBytecode - view.data(); }
@@ -2833,7 +2837,7 @@ int wmain (int argc, wchar_t* argv[])
         {
             if (0 == std::wcscmp (argv[argn], argv[last_arg]))
                 break;
-            sys::mapping::readwrite start (argv[argn], sys::mapping::writecopy);
+            adv_script_map start (argv[argn], sys::mapping::writecopy);
             reader.init (start);
             if (!reader.run())
             {
@@ -2842,7 +2846,7 @@ int wmain (int argc, wchar_t* argv[])
             }
             ++argn;
         }
-        sys::mapping::readwrite in (argv[argn], sys::mapping::writecopy);
+        adv_script_map in (argv[argn], sys::mapping::writecopy);
         reader.init (in);
         reader.set_log_level (log_level);
         return reader.run() ? 0 : 1;
@@ -0,0 +1,59 @@
+// -*- C++ -*-
+//! \file       unprs.cc
+//! \date       2026 Oct 16
+//! \brief      decompress PRS-compressed ADVIZ scripts.
+//
+
+#include "sysmemmap.h"
+#include "prsdec.h"
+#include <cstdio>
+#include <cwchar>
+#include <fstream>
+#include <vector>
+
+int wmain (int argc, wchar_t* argv[])
+{
+    bool raw = argc > 1 && 0 == std::wcscmp (argv[1], L"-r");
+    int argn = raw ? 2 : 1;
+    if (argc - argn < 2)
+    {
+        std::puts ("usage: unprs [-r] INPUT OUTPUT\n"
+                   "    -r  input is raw PRS stream without ADVIZ header");
+        return 0;
+    }
+    try
+    {
+        sys::mapping::readonly in (argv[argn]);
+        sys::mapping::const_view<uint8_t> view (in);
+        std::vector<uint8_t> output;
+        if (raw)
+        {
+            bin::prs_decompress (view.data(), view.size(), output);
+        }
+        else
+        {
+            // 16-bit unpacked size followed by 16-bit packed size
+            if (view.size() < 4)
+                throw std::runtime_error ("invalid PRS script");
+            size_t unpacked_size = view[0] | view[1] << 8;
+            size_t packed_size = view[2] | view[3] << 8;
+            if (packed_size != view.size() - 4)
+                throw std::runtime_error ("invalid PRS script");
+            output.resize (unpacked_size);
+            output.resize (bin::prs_decompress (view.data()+4, packed_size, output.data(), output.size()));
+        }
+        std::ofstream out (argv[argn+1], std::ios::out|std::ios::binary|std::ios::trunc);
+        if (!out)
+        {
+            std::fprintf (stderr, "%S: error opening output file\n", argv[argn+1]);
+            return 1;
+        }
+        out.write (reinterpret_cast<const char*> (output.data()), output.size());
+        return 0;
+    }
+    catch (std::exception& X)
+    {
+        std::fprintf (stderr, "%S: %s\n", argv[argn], X.what());
+        return 1;
+    }
+}
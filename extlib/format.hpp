@@ -3,8 +3,9 @@
  * Created:     Fri Jul 13 12:08:57 2007
  * Description: formatting of arguments according to printf-like format-string.
  *
- * format keeps compiled format specifications in static hash_map.
- * if format called more than once for the same string, compiled object is used.
+ * if EXT_FORMAT_USE_TABLE is defined, format keeps compiled format specifications
+ * in bounded per-thread cache.  if format called more than once for the same
+ * string, compiled object is used.
  *
  * Copyright (C) 2007 ****************
  *
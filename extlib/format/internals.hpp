@@ -10,15 +10,9 @@
 #define EXT_FORMAT_INTERNALS_HPP
 
 #include "format/forward.hpp"
-#ifndef EXT_FORMAT_USE_TABLE
-#include "format/table.hpp"
-#endif
 #include "atomic.hpp"		// for ext::atomic_swap
 #include <locale>
 #include <vector>
-#ifdef EXT_MT
-#include <boost/thread/mutex.hpp>
-#endif
 
 namespace ext {
 
@@ -222,6 +216,22 @@ public: // methods
 
     static unsigned set_default_exceptions (unsigned newexcept);
 
+    // cache_stats -- counters of compiled formats cache
+
+    struct cache_stats
+    {
+	unsigned long	hits;		// format strings found in cache
+	unsigned long	misses;		// format strings compiled from scratch
+	unsigned long	evictions;	// entries replaced by newer formats
+	size_t		size;		// number of occupied entries
+	size_t		capacity;	// maximum number of entries
+    };
+
+    // format_cache_stats()
+    // Returns: counters of compiled formats cache used by the calling thread.
+    // All counters are zero if formats are compiled without cache.
+    static cache_stats format_cache_stats ();
+
 protected: // types
 
     // comp_format -- compiled format object representation
@@ -242,14 +252,54 @@ protected: // types
     class format_parser;
 
 #ifdef EXT_FORMAT_USE_TABLE
-    typedef hash_map<istring_type, comp_format>	map_type;
-    struct format_table
+    // format_cache -- bounded cache of compiled formats.
+    // 2-way set associative table indexed by hash of format string contents.
+    // Each thread owns its cache, so lookups take no locks, and compiled objects
+    // are shared with format objects through shared_ptr.
+
+    class format_cache
     {
-	map_type		map;
-#ifdef EXT_MT
-	boost::mutex		mutex;
-#endif
+    public:
+	enum { set_count = 128, way_count = 2, capacity = set_count * way_count };
+
+	format_cache () : m_hits (0), m_misses (0), m_evictions (0)
+	    {
+		for (size_t i = 0; i < set_count; ++i)
+		    m_victim[i] = 0;
+	    }
+
+	// format_cache::find (SPEC_STR, HASH)
+	// Returns: compiled format corresponding to SPEC_STR or null pointer.
+	shared_ptr<comp_format> find (const istring_type& spec_str, size_t hash);
+
+	// format_cache::insert (SPEC_STR, HASH, FORMAT)
+	// Effects: put compiled FORMAT into cache, replacing least recently used
+	// entry in the set.
+	void insert (const istring_type& spec_str, size_t hash,
+		     const shared_ptr<comp_format>& format);
+
+	cache_stats stats () const;
+
+	static size_t hash_value (const istring_type& str);
+
+    private:
+	struct entry
+	{
+	    size_t			hash;
+	    istring_type		key;
+	    shared_ptr<comp_format>	format;
+
+	    entry () : hash (0) { }
+	};
+
+	entry		m_table[set_count][way_count];
+	unsigned char	m_victim[set_count];	// way to be replaced next
+	unsigned long	m_hits, m_misses, m_evictions;
     };
+
+    // cache()
+    // Returns: reference to compiled formats cache of the calling thread.
+    static format_cache& cache ();
 #endif // EXT_FORMAT_USE_TABLE
 
 protected: // methods
@@ -334,12 +384,6 @@ protected: // data
     // running threads.         XXX consider make this variable thread-local
     static atomic_type		s_default_exceptions;
 
-#ifdef EXT_FORMAT_USE_TABLE
-    // format keeps compiled format specifications in this static hash_map.
-    // Access to map is serialized between threads if EXT_MT preprocessor symbol is
-    // defined during compilation.
-    static format_table		s_table;	// table of used formats
-#endif
 };
 
 // ---------------------------------------------------------------------------
@@ -434,11 +478,6 @@ void format_spec<Ch,Tr,Al>:: compute_states (const std::ctype<Ch>& ct)
 template <class Ch, class Tr, class Al>
 atomic_type format_base<Ch,Tr,Al>::s_default_exceptions;
 
-#ifdef EXT_FORMAT_USE_TABLE
-template <class Ch, class Tr, class Al>
-typename format_base<Ch,Tr,Al>::format_table format_base<Ch,Tr,Al>::s_table;
-#endif
-
 template <class Ch, class Tr, class Al>
 format_base<Ch,Tr,Al>::format_base ()
     : m_oss(), m_state0 (m_oss)
@@ -538,6 +577,98 @@ void format_base<Ch,Tr,Al>::end_put ()
     m_state0.apply_on (m_oss);
 }
 
+#ifdef EXT_FORMAT_USE_TABLE
+
+// format::cache()
+// format keeps compiled format specifications in a per-thread cache if EXT_MT
+// preprocessor symbol is defined during compilation, and in a single static cache
+// otherwise.
+
+template <class Ch, class Tr, class Al>
+typename format_base<Ch,Tr,Al>::format_cache& format_base<Ch,Tr,Al>::cache ()
+{
+#ifdef EXT_MT
+    static thread_local format_cache s_cache;
+#else
+    static format_cache s_cache;
+#endif
+    return s_cache;
+}
+
+template <class Ch, class Tr, class Al>
+size_t format_base<Ch,Tr,Al>::format_cache::hash_value (const istring_type& str)
+{
+    size_t h = 0xdeadbeef;
+    const char_type* const end = str.data() + str.size();
+    for (const char_type* ptr = str.data(); ptr != end; ++ptr)
+	h = h*33 + traits_type::to_int_type (*ptr);
+    return h;
+}
+
+template <class Ch, class Tr, class Al>
+shared_ptr<typename format_base<Ch,Tr,Al>::comp_format>
+format_base<Ch,Tr,Al>::format_cache::find (const istring_type& spec_str, size_t hash)
+{
+    const size_t set = hash % set_count;
+    for (size_t way = 0; way < way_count; ++way)
+    {
+	const entry& e = m_table[set][way];
+	if (e.hash != hash || !e.format || e.key.size() != spec_str.size())
+	    continue;
+	// key is immutable and kept alive by the cache, so same pointer means same
+	// contents.
+	if (e.key.data() == spec_str.data()
+	    || 0 == traits_type::compare (e.key.data(), spec_str.data(), spec_str.size()))
+	{
+	    m_victim[set] = static_cast<unsigned char> (way ^ 1);
+	    ++m_hits;
+	    return e.format;
+	}
+    }
+    ++m_misses;
+    return shared_ptr<comp_format>();
+}
+
+template <class Ch, class Tr, class Al>
+void format_base<Ch,Tr,Al>::format_cache::
+insert (const istring_type& spec_str, size_t hash, const shared_ptr<comp_format>& format)
+{
+    const size_t set = hash % set_count;
+    const size_t way = m_victim[set];
+    entry& e = m_table[set][way];
+    if (e.format)
+	++m_evictions;
+    e.hash = hash;
+    e.key = spec_str;
+    e.format = format;
+    m_victim[set] = static_cast<unsigned char> (way ^ 1);
+}
+
+template <class Ch, class Tr, class Al>
+typename format_base<Ch,Tr,Al>::cache_stats
+format_base<Ch,Tr,Al>::format_cache::stats () const
+{
+    cache_stats st = { m_hits, m_misses, m_evictions, 0, capacity };
+    for (size_t set = 0; set < set_count; ++set)
+	for (size_t way = 0; way < way_count; ++way)
+	    if (m_table[set][way].format)
+		++st.size;
+    return st;
+}
+
+#endif // EXT_FORMAT_USE_TABLE
+
+template <class Ch, class Tr, class Al>
+typename format_base<Ch,Tr,Al>::cache_stats format_base<Ch,Tr,Al>::format_cache_stats ()
+{
+#ifdef EXT_FORMAT_USE_TABLE
+    return cache().stats();
+#else
+    cache_stats st = { 0, 0, 0, 0, 0 };
+    return st;
+#endif
+}
+
 // format::parse (SPEC_STR)
 // Effects: find compiled format specification corresponding to SPEC_STR and
 // initalize members accordingly.
@@ -553,36 +684,19 @@ void format_base<Ch,Tr,Al>:: parse (const istring_type& spec_str)
 	parser.compile (spec_str, m_format_compiled);
 	m_format = &m_format_compiled;
 #else // EXT_FORMAT_USE_TABLE
-#ifdef EXT_MT
-	boost::mutex::scoped_try_lock lock (s_table.mutex);
-	if (lock.owns_lock())
-	{
-#endif
-	    typename map_type::iterator it = s_table.map.find (spec_str);
-	    if (it == s_table.map.end())
-	    {
-		// it's cheaper to insert empty comp_format object and erase it on error,
-		// than insert fully initialized comp_format in case of success.
-		it = s_table.map.insert (std::make_pair (spec_str, comp_format())).first;
-		try {
-		    format_parser parser (this, arg_mark);
-		    parser.compile (spec_str, it->second);
-		} catch (...) {
-		    s_table.map.erase (it);
-		    throw;
-		}
-	    }
-	    m_format = &it->second;
-#ifdef EXT_MT
-	}
-	else // don't wait for lock, compile from scratch
+	format_cache& table = cache();
+	const size_t hash = format_cache::hash_value (spec_str);
+	m_format_allocated = table.find (spec_str, hash);
+	if (!m_format_allocated)
 	{
+	    // compile into separate object, so that cache isn't touched on error.
+	    shared_ptr<comp_format> comp (new comp_format);
 	    format_parser parser (this, arg_mark);
-	    m_format_allocated.reset (new comp_format);
-	    parser.compile (spec_str, *m_format_allocated);
-	    m_format = m_format_allocated.get();
+	    parser.compile (spec_str, *comp);
+	    table.insert (spec_str, hash, comp);
+	    m_format_allocated.swap (comp);
 	}
-#endif
+	m_format = m_format_allocated.get();
 #endif // EXT_FORMAT_USE_TABLE
     }
 }
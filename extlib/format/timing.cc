@@ -15,6 +15,9 @@
 #include <limits>
 #include <iostream>
 #include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 #ifdef _MSC_VER
 #define COMPILER_NAME	"Microsoft C/C++ Compiler"
@@ -118,6 +121,44 @@ void test_dummy_format ()
     f.str();
 }
 
+// format_worker (ITERATIONS, STATS)
+// Effects: format ITERATIONS lines into null stream owned by the calling thread.
+
+void format_worker (int iterations, ext::format::cache_stats* stats)
+{
+    nullbuf null;
+    std::ostream out (&null);
+    for (int i = 0; i < iterations; ++i)
+	out << ext::format("%-20s %10.5g %10.5g %10.5g\n") %desc %x %y %z;
+    *stats = ext::format::format_cache_stats();
+}
+
+// test_threads (COUNT)
+// Effects: run format_worker in COUNT threads simultaneously and report formats
+// per second of wall time.
+
+void test_threads (unsigned count)
+{
+    std::vector<std::thread> threads;
+    std::vector<ext::format::cache_stats> stats (count, ext::format::cache_stats());
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+	threads.emplace_back (format_worker, DEFAULT_ITERATIONS, &stats[i]);
+    for (auto& t : threads)
+	t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    unsigned long hits = 0, misses = 0;
+    for (const auto& st : stats)
+    {
+	hits += st.hits;
+	misses += st.misses;
+    }
+    const double total = double (DEFAULT_ITERATIONS) * count;
+    std::clog << ext::format("%2u threads %10.3g s %12.0f fmt/s  cache %lu/%lu\n")
+	%count %elapsed.count() %(total / elapsed.count()) %hits %misses;
+}
+
 std::string base_name (std::string name)
 {
     size_t pos = name.find_last_of ("/\\");
@@ -151,6 +192,12 @@ try
 //    std::clog << ext::format("%-20s %.3g s\n") %"test_long_stream" %t4;
     std::clog << ext::format("%-20s %.3g s\n") %"test_long_format" %t2;
 //    std::clog << ext::format("%-20s %.3g s\n") %"test_long_boost"  %t3;
+
+    unsigned max_threads = argc > 1 ? std::atoi (argv[1]) : std::thread::hardware_concurrency();
+    if (!max_threads)
+	max_threads = 1;
+    for (unsigned n = 1; n <= max_threads; ++n)
+	test_threads (n);
     return EXIT_SUCCESS;
 }
 catch (std::exception& X)
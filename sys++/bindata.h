@@ -40,6 +40,24 @@
 #include <intrin.h>		// MS Visual C intinsic functions
 #endif
 #include <algorithm>		// for std::iter_swap
+#include <cstring>		// for std::memmove
+
+#if defined(__AVX2__)
+#   define SYSPP_AVX2 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#   define SYSPP_SSSE3 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define SYSPP_SSE2 1
+#endif
+#if SYSPP_AVX2
+#include <immintrin.h>
+#elif SYSPP_SSSE3
+#include <tmmintrin.h>
+#elif SYSPP_SSE2
+#include <emmintrin.h>
+#endif
 
 #if defined(__BYTE_ORDER__) && defined (__ORDER_LITTLE_ENDIAN__)
 #   if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
@@ -409,6 +427,189 @@ inline uint64_t endian_swap<uint64_t>::operator() (uint64_t x) const
 { return swap_qword (x); }
 #endif
 
+// ---------------------------------------------------------------------------
+// bulk conversion
+
+namespace detail
+{
+    // conversion_kind<Converter>::value tells what Converter does with the
+    // elements on the target architecture.
+
+    enum { convert_generic, convert_copy, convert_swap };
+
+    template <class Converter>
+    struct conversion_kind
+    { static const int value = convert_generic; };
+
+    template <typename IntT>
+    struct conversion_kind< endian_swap<IntT> >
+    { static const int value = sizeof(IntT) > 1? convert_swap: convert_copy; };
+
+    template <typename IntT>
+    struct conversion_kind< litendian_convert<IntT> >
+    {
+#if SYSPP_BIGENDIAN
+	static const int value = sizeof(IntT) > 1? convert_swap: convert_copy;
+#else
+	static const int value = convert_copy;
+#endif
+    };
+
+    template <typename IntT>
+    struct conversion_kind< bigendian_convert<IntT> >
+    {
+#if SYSPP_BIGENDIAN
+	static const int value = convert_copy;
+#else
+	static const int value = sizeof(IntT) > 1? convert_swap: convert_copy;
+#endif
+    };
+
+    template <size_t N> struct uint_of_size;
+    template <> struct uint_of_size<2> { typedef uint16_t type; };
+    template <> struct uint_of_size<4> { typedef uint32_t type; };
+    template <> struct uint_of_size<8> { typedef uint64_t type; };
+
+#if SYSPP_SSSE3
+    // shuffle mask that reverses bytes within every N-byte element
+
+    template <size_t N> __m128i swap_mask ();
+
+    template <> inline __m128i swap_mask<2> ()
+    { return _mm_setr_epi8 (1,0, 3,2, 5,4, 7,6, 9,8, 11,10, 13,12, 15,14); }
+
+    template <> inline __m128i swap_mask<4> ()
+    { return _mm_setr_epi8 (3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12); }
+
+    template <> inline __m128i swap_mask<8> ()
+    { return _mm_setr_epi8 (7,6,5,4,3,2,1,0, 15,14,13,12,11,10,9,8); }
+
+#elif SYSPP_SSE2
+    // without byte shuffle, words are reordered first and then bytes within
+    // each word are swapped by shifts.
+
+    template <size_t N> __m128i sse2_swap (__m128i v);
+
+    template <> inline __m128i sse2_swap<2> (__m128i v)
+    { return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8)); }
+
+    template <> inline __m128i sse2_swap<4> (__m128i v)
+    {
+	v = _mm_shufflelo_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1));
+	v = _mm_shufflehi_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1));
+	return sse2_swap<2> (v);
+    }
+
+    template <> inline __m128i sse2_swap<8> (__m128i v)
+    { return sse2_swap<4> (_mm_shuffle_epi32 (v, _MM_SHUFFLE (2, 3, 0, 1))); }
+#endif
+
+    // swap_range (SRC, DST, COUNT)
+    // reverse bytes in COUNT elements of SRC and store them into DST.  vector
+    // part is selected at compile time, remaining elements are swapped one by
+    // one.
+
+    template <typename UIntT>
+    void swap_range (const UIntT* src, UIntT* dst, size_t count)
+    {
+	const size_t N = sizeof(UIntT);
+	size_t i = 0;
+#if SYSPP_AVX2
+	const __m256i mask256 = _mm256_broadcastsi128_si256 (swap_mask<N>());
+	for (; i + 32/N <= count; i += 32/N)
+	{
+	    __m256i v = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i));
+	    _mm256_storeu_si256 (reinterpret_cast<__m256i*> (dst + i), _mm256_shuffle_epi8 (v, mask256));
+	}
+#endif
+#if SYSPP_SSSE3
+	const __m128i mask = swap_mask<N>();
+	for (; i + 16/N <= count; i += 16/N)
+	{
+	    __m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+	    _mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i), _mm_shuffle_epi8 (v, mask));
+	}
+#elif SYSPP_SSE2
+	for (; i + 16/N <= count; i += 16/N)
+	{
+	    __m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+	    _mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i), sse2_swap<N> (v));
+	}
+#endif
+	endian_swap<UIntT> swap;
+	for (; i < count; ++i)
+	    dst[i] = swap (src[i]);
+    }
+
+    template <int Kind> struct conversion_tag { };
+
+    template <class Converter, typename T>
+    inline void convert_range (const T* src, T* dst, size_t count, Converter cvt,
+			       conversion_tag<convert_generic>)
+    { std::transform (src, src + count, dst, cvt); }
+
+    template <class Converter, typename T>
+    inline void convert_range (const T* src, T* dst, size_t count, Converter,
+			       conversion_tag<convert_copy>)
+    {
+	if (src != dst)
+	    std::memmove (dst, src, count * sizeof(T));
+    }
+
+    template <class Converter, typename T>
+    inline void convert_range (const T* src, T* dst, size_t count, Converter,
+			       conversion_tag<convert_swap>)
+    {
+	typedef typename uint_of_size<sizeof(T)>::type uint_type;
+	swap_range (reinterpret_cast<const uint_type*> (src),
+		    reinterpret_cast<uint_type*> (dst), count);
+    }
+} // namespace detail
+
+/// convert_range<Converter> (SRC, DST, COUNT)
+///
+/// Effects: applies Converter to COUNT elements at SRC and stores results into
+/// DST, same as std::transform (SRC, SRC+COUNT, DST, Converter()).  byte
+/// swapping converters (endian_swap, litendian_convert and bigendian_convert of
+/// 16, 32 and 64-bit integers) are vectorized.  SRC and DST either must be the
+/// same or must not overlap.
+
+template <class Converter>
+inline void convert_range (const typename Converter::argument_type* src,
+			   typename Converter::argument_type* dst, size_t count)
+{
+    detail::convert_range (src, dst, count, Converter(),
+			   detail::conversion_tag<detail::conversion_kind<Converter>::value>());
+}
+
+/// convert_range<Converter> (DATA, COUNT)
+///
+/// Effects: converts COUNT elements at DATA in place.
+
+template <class Converter>
+inline void convert_range (typename Converter::argument_type* data, size_t count)
+{
+    convert_range<Converter> (data, data, count);
+}
+
+} // namespace bin
+
+namespace sys { namespace mapping {
+    template <class T, class CountPolicy> class view;
+} }
+
+namespace bin {
+
+/// convert_range<Converter> (VIEW)
+///
+/// Effects: converts elements of writable memory mapped VIEW in place.
+
+template <class Converter, class CountPolicy>
+inline void convert_range (sys::mapping::view<typename Converter::argument_type, CountPolicy>& view)
+{
+    convert_range<Converter> (view.data(), view.data(), view.size());
+}
+
 // ---------------------------------------------------------------------------
 // bit scan functions
 
@@ -0,0 +1,256 @@
+// -*- C++ -*-
+//! \file       bitreader.h
+//! \date       2026 Oct 16
+//! \brief      bit stream reader with 64-bit accumulator.
+//
+
+#ifndef SYS_BITREADER_H
+#define SYS_BITREADER_H
+
+#include "bindata.h"
+#include <stdexcept>
+#include <cstring>
+
+namespace bin {
+
+/// bit order policies for bit_reader.
+/// msb_first: bits are taken starting from the most significant bit of each
+///            input unit.
+/// lsb_first: bits are taken starting from the least significant bit.
+
+struct msb_first { };
+struct lsb_first { };
+
+namespace detail
+{
+    inline uint64_t load_qword_le (const uint8_t* src)
+    {
+	int64_t qw;
+	std::memcpy (&qw, src, sizeof(qw));
+	return little_qword (qw);
+    }
+
+    // bit_unit<Order, Width>
+    // loads input units of Width bits stored in little-endian byte order.
+    // load() returns one unit, load_qword() returns eight bytes rearranged so
+    // that bits that come first in the stream are at the position where
+    // accumulator expects them: at the top for msb_first, at the bottom for
+    // lsb_first.
+
+    template <class Order, unsigned Width> struct bit_unit;
+
+    template <unsigned Width>
+    struct bit_unit<lsb_first, Width>
+    {
+	static uint32_t load (const uint8_t* src)
+	{
+	    uint32_t unit = 0;
+	    for (unsigned i = 0; i < Width/8; ++i)
+		unit |= static_cast<uint32_t> (src[i]) << (i * 8);
+	    return unit;
+	}
+	static uint64_t load_qword (const uint8_t* src)
+	    { return load_qword_le (src); }
+    };
+
+    template <>
+    struct bit_unit<msb_first, 8>
+    {
+	static uint32_t load (const uint8_t* src) { return *src; }
+	static uint64_t load_qword (const uint8_t* src)
+	    { return swap_qword (load_qword_le (src)); }
+    };
+
+    template <>
+    struct bit_unit<msb_first, 16>
+    {
+	static uint32_t load (const uint8_t* src) { return src[0] | src[1] << 8; }
+	static uint64_t load_qword (const uint8_t* src)
+	{
+	    uint64_t qw = load_qword_le (src);
+	    qw = qw >> 32 | qw << 32;
+	    return (qw & 0x0000FFFF0000FFFFull) << 16 | (qw >> 16 & 0x0000FFFF0000FFFFull);
+	}
+    };
+
+    template <>
+    struct bit_unit<msb_first, 32>
+    {
+	static uint32_t load (const uint8_t* src)
+	    { return src[0] | src[1] << 8 | src[2] << 16 | static_cast<uint32_t> (src[3]) << 24; }
+	static uint64_t load_qword (const uint8_t* src)
+	{
+	    uint64_t qw = load_qword_le (src);
+	    return qw >> 32 | qw << 32;
+	}
+    };
+} // namespace detail
+
+/// \class bin::bit_reader
+///
+/// reads bit fields from memory buffer.  input is consumed in units of
+/// RefillWidth bits (8, 16 or 32) stored in little-endian byte order, bits
+/// within each unit are taken according to Order policy.  for example,
+/// bit_reader<msb_first, 16> reads 16-bit words and takes bits starting from
+/// bit 15, as many japanese compressors do.
+///
+/// up to 64 bits are kept in the accumulator, so input bounds are checked once
+/// per refill rather than on every bit.  peek() and consume() perform no checks
+/// at all; decoders that know the longest code they need call ensure() before
+/// decoding a symbol and then look up bits without branches.  bits past the
+/// end of input are read as zeroes.
+
+template <class Order = msb_first, unsigned RefillWidth = 8>
+class bit_reader
+{
+public:
+    /// max_peek
+    /// number of bits that are guaranteed to be available after successful
+    /// refill.
+
+    SYSPP_static_constexpr unsigned max_peek = 64 - RefillWidth + 1;
+
+    bit_reader (const uint8_t* begin, const uint8_t* end)
+	: m_src (begin), m_end (end), m_bits (0), m_count (0)
+	{ }
+
+    /// refill()
+    ///
+    /// Effects: loads whole input units into accumulator until it holds at
+    /// least max_peek bits or input is exhausted.
+
+    void refill ()
+	{
+	    if (m_end - m_src >= 8)
+	    {
+		const unsigned units = (64 - m_count) / RefillWidth;
+		if (!units)
+		    return;
+		const uint64_t qw = unit_type::load_qword (m_src);
+		// bits loaded past the last whole unit are the stream bits that
+		// will be loaded at the same position by the next refill, so
+		// they're left in place.
+		insert (qw);
+		m_count += units * RefillWidth;
+		m_src += units * (RefillWidth / 8);
+	    }
+	    else
+	    {
+		while (m_count <= 64 - RefillWidth && m_end - m_src >= int (RefillWidth / 8))
+		{
+		    insert_unit (unit_type::load (m_src));
+		    m_count += RefillWidth;
+		    m_src += RefillWidth / 8;
+		}
+	    }
+	}
+
+    /// ensure (N)
+    ///
+    /// Effects: refills accumulator if it holds less than N bits.
+    /// Returns: true if at least N bits are available.  N should not exceed
+    ///          max_peek.
+
+    bool ensure (unsigned n)
+	{
+	    if (m_count < n)
+		refill();
+	    return m_count >= n;
+	}
+
+    /// peek (N)
+    ///
+    /// Returns: next N bits of the stream, first bit being the most significant
+    /// for msb_first and the least significant for lsb_first order.  N should
+    /// not exceed 32 and the number of available bits.
+
+    uint32_t peek (unsigned n) const
+	{ return peek (n, Order()); }
+
+    /// consume (N)
+    ///
+    /// Effects: drops N bits from the accumulator.
+
+    void consume (unsigned n)
+	{
+	    consume (n, Order());
+	    m_count -= n;
+	}
+
+    /// get_bits (N)
+    ///
+    /// Returns: next N bits of the stream, 0 < N <= 32.
+    /// Throws: std::runtime_error if input is exhausted.
+
+    uint32_t get_bits (unsigned n)
+	{
+	    if (!ensure (n))
+		throw std::runtime_error ("end of stream");
+	    uint32_t bits = peek (n);
+	    consume (n);
+	    return bits;
+	}
+
+    int get_bit ()
+	{
+	    return get_bits (1);
+	}
+
+    /// align()
+    ///
+    /// Effects: skips the rest of partially consumed input unit.
+
+    void align ()
+	{
+	    consume (m_count % RefillWidth);
+	}
+
+    /// position()
+    ///
+    /// Returns: pointer to the first input unit that wasn't consumed yet.
+    /// meaningful after align().
+
+    const uint8_t* position () const
+	{ return m_src - m_count / 8; }
+
+    /// bits_left()
+    ///
+    /// Returns: number of bits that could still be read.
+
+    size_t bits_left () const
+	{ return (m_end - m_src) * 8 + m_count; }
+
+private:
+    typedef detail::bit_unit<Order, RefillWidth> unit_type;
+
+    // valid bits are kept at the top of the accumulator for msb_first order,
+    // and at the bottom for lsb_first.
+
+    uint32_t peek (unsigned n, msb_first) const
+	{ return static_cast<uint32_t> (m_bits >> (63 - n) >> 1); }
+
+    uint32_t peek (unsigned n, lsb_first) const
+	{ return static_cast<uint32_t> (m_bits & ((uint64_t (1) << n) - 1)); }
+
+    void consume (unsigned n, msb_first) { m_bits <<= n; }
+    void consume (unsigned n, lsb_first) { m_bits >>= n; }
+
+    void insert (uint64_t qw) { insert (qw, Order()); }
+    void insert (uint64_t qw, msb_first) { m_bits |= qw >> m_count; }
+    void insert (uint64_t qw, lsb_first) { m_bits |= qw << m_count; }
+
+    void insert_unit (uint32_t unit) { insert_unit (unit, Order()); }
+    void insert_unit (uint32_t unit, msb_first)
+	{ m_bits |= uint64_t (unit) << (64 - RefillWidth - m_count); }
+    void insert_unit (uint32_t unit, lsb_first)
+	{ m_bits |= uint64_t (unit) << m_count; }
+
+    const uint8_t*	m_src;
+    const uint8_t*	m_end;
+    uint64_t		m_bits;
+    unsigned		m_count;	// number of valid bits in m_bits
+};
+
+} // namespace bin
+
+#endif /* SYS_BITREADER_H */
@@ -0,0 +1,226 @@
+// -*- C++ -*-
+//! \file       huffman.h
+//! \date       2026 Oct 16
+//! \brief      table-driven decoder for Huffman trees stored as node arrays.
+//
+
+#ifndef SYS_HUFFMAN_H
+#define SYS_HUFFMAN_H
+
+#include "bitreader.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace bin {
+
+/// \class bin::huffman_table
+///
+/// decodes symbols of a binary code tree in which every node is identified by
+/// its index and leaf index is the decoded symbol, as trees serialized by most
+/// japanese compressors are.
+///
+/// codes up to PrimaryBits long are decoded with a single lookup in the
+/// primary table, longer codes continue through secondary tables of up to
+/// SecondaryBits each.  when bit_reader can't provide enough bits for a table
+/// lookup near the end of input, tree is walked one bit at a time.
+///
+/// Order should match the order of bit_reader used with decode().
+
+template <class Order = msb_first, unsigned PrimaryBits = 10, unsigned SecondaryBits = 6>
+class huffman_table
+{
+public:
+    huffman_table () : m_root (0), m_primary_bits (0) { }
+
+    /// build (ROOT, NODE_COUNT, CHILD, IS_LEAF)
+    ///
+    /// Effects: builds tables for tree with ROOT node.  CHILD (NODE, BIT)
+    /// returns index of NODE child that corresponds to BIT, IS_LEAF (NODE)
+    /// returns true for leaf nodes.  all node indices are less than NODE_COUNT.
+    /// Throws: std::runtime_error if tree refers to nodes outside of range,
+    /// contains cycles or its root is a leaf.
+
+    template <class Child, class IsLeaf>
+    void build (int root, size_t node_count, Child child, IsLeaf is_leaf);
+
+    /// decode (BITS)
+    ///
+    /// Returns: next symbol from bit stream BITS.
+    /// Throws: std::runtime_error if input is exhausted in the middle of code.
+
+    template <class BitReader>
+    int decode (BitReader& bits) const
+	{
+	    const entry* table = m_table.data();
+	    unsigned width = m_primary_bits;
+	    int node = m_root;
+	    for (;;)
+	    {
+		if (!bits.ensure (width))
+		    return decode_slow (bits, node);
+		const entry& e = table[bits.peek (width)];
+		if (!e.bits)
+		{
+		    bits.consume (e.length);
+		    return e.value;
+		}
+		bits.consume (width);
+		table = m_table.data() + e.value;
+		width = e.bits;
+		node = e.node;
+	    }
+	}
+
+    /// max_length()
+    ///
+    /// Returns: length of the longest code.
+
+    unsigned max_length () const { return m_depth.empty() ? 0 : m_depth[m_root]; }
+
+private:
+    // leaf: value is symbol, length is number of bits within current table.
+    // link: value is offset of secondary table, bits is its index width,
+    // node is the tree node secondary table starts from.
+    struct entry
+    {
+	int		value;
+	uint8_t		length;
+	uint8_t		bits;
+	uint16_t	node;
+    };
+
+    // tables larger than this are produced only by trees that share subtrees.
+    enum { max_table_size = 1 << 20 };
+
+    unsigned tree_depth (int node);
+    void fill (size_t base, unsigned width, int node, unsigned length, unsigned code);
+    void set_entries (size_t base, unsigned width, unsigned length, unsigned code, const entry& e);
+
+    static void invalid_tree ()
+	{ throw std::runtime_error ("invalid Huffman tree"); }
+
+    // decode_slow (BITS, NODE)
+    // walks the tree from NODE one bit at a time.
+
+    template <class BitReader>
+    int decode_slow (BitReader& bits, int node) const
+	{
+	    do
+		node = m_child[2 * node + bits.get_bit()];
+	    while (!m_leaf[node]);
+	    return node;
+	}
+
+    unsigned code_index (unsigned code, unsigned length, unsigned width, unsigned i, msb_first) const
+	{ return code << (width - length) | i; }
+    unsigned code_index (unsigned code, unsigned length, unsigned, unsigned i, lsb_first) const
+	{ return code | i << length; }
+    unsigned append_bit (unsigned code, unsigned, unsigned bit, msb_first) const
+	{ return code << 1 | bit; }
+    unsigned append_bit (unsigned code, unsigned length, unsigned bit, lsb_first) const
+	{ return code | bit << length; }
+
+    int			m_root;
+    unsigned		m_primary_bits;
+    std::vector<entry>	m_table;
+    std::vector<int>	m_child;	// two children for each node
+    std::vector<char>	m_leaf;
+    std::vector<unsigned> m_depth;	// height of subtree, 0 for leaves
+};
+
+template <class Order, unsigned PrimaryBits, unsigned SecondaryBits>
+template <class Child, class IsLeaf>
+void huffman_table<Order, PrimaryBits, SecondaryBits>::
+build (int root, size_t node_count, Child child, IsLeaf is_leaf)
+{
+    if (root < 0 || static_cast<size_t> (root) >= node_count || node_count > 0xFFFF)
+	invalid_tree();
+    m_root = root;
+    m_child.assign (2 * node_count, -1);
+    m_leaf.assign (node_count, 0);
+    for (size_t node = 0; node < node_count; ++node)
+    {
+	m_leaf[node] = is_leaf (node);
+	if (!m_leaf[node])
+	{
+	    m_child[2 * node]     = child (node, 0);
+	    m_child[2 * node + 1] = child (node, 1);
+	}
+    }
+    if (m_leaf[root])
+	invalid_tree();
+    m_depth.assign (node_count, ~0u);
+    unsigned depth = tree_depth (root);
+
+    m_primary_bits = std::min<unsigned> (PrimaryBits, depth);
+    m_table.assign (size_t (1) << m_primary_bits, entry());
+    fill (0, m_primary_bits, root, 0, 0);
+}
+
+// tree_depth (NODE)
+// Returns: height of subtree rooted at NODE, checks that subtree is valid.
+// nodes that are being visited are marked with ~1u.
+
+template <class Order, unsigned PrimaryBits, unsigned SecondaryBits>
+unsigned huffman_table<Order, PrimaryBits, SecondaryBits>::
+tree_depth (int node)
+{
+    if (node < 0 || static_cast<size_t> (node) >= m_leaf.size())
+	invalid_tree();
+    unsigned& depth = m_depth[node];
+    if (~1u == depth)
+	invalid_tree();
+    if (depth != ~0u)
+	return depth;
+    if (m_leaf[node])
+	return depth = 0;
+    depth = ~1u;
+    unsigned left = tree_depth (m_child[2 * node]);
+    unsigned right = tree_depth (m_child[2 * node + 1]);
+    return m_depth[node] = 1 + std::max (left, right);
+}
+
+template <class Order, unsigned PrimaryBits, unsigned SecondaryBits>
+void huffman_table<Order, PrimaryBits, SecondaryBits>::
+set_entries (size_t base, unsigned width, unsigned length, unsigned code, const entry& e)
+{
+    for (unsigned i = 0; i < 1u << (width - length); ++i)
+	m_table[base + code_index (code, length, width, i, Order())] = e;
+}
+
+// fill (BASE, WIDTH, NODE, LENGTH, CODE)
+// fills entries of table at BASE with index WIDTH bits wide for codes that
+// start with CODE of LENGTH bits leading to NODE.
+
+template <class Order, unsigned PrimaryBits, unsigned SecondaryBits>
+void huffman_table<Order, PrimaryBits, SecondaryBits>::
+fill (size_t base, unsigned width, int node, unsigned length, unsigned code)
+{
+    if (m_leaf[node])
+    {
+	entry e = { node, static_cast<uint8_t> (length), 0, 0 };
+	set_entries (base, width, length, code, e);
+    }
+    else if (length == width)
+    {
+	unsigned sub_width = std::min<unsigned> (SecondaryBits, m_depth[node]);
+	size_t offset = m_table.size();
+	if (offset + (size_t (1) << sub_width) > max_table_size)
+	    invalid_tree();
+	m_table.resize (offset + (size_t (1) << sub_width));
+	entry e = { static_cast<int> (offset), static_cast<uint8_t> (width),
+		    static_cast<uint8_t> (sub_width), static_cast<uint16_t> (node) };
+	set_entries (base, width, length, code, e);
+	fill (offset, sub_width, node, 0, 0);
+    }
+    else
+    {
+	fill (base, width, m_child[2 * node],     length + 1, append_bit (code, length, 0, Order()));
+	fill (base, width, m_child[2 * node + 1], length + 1, append_bit (code, length, 1, Order()));
+    }
+}
+
+} // namespace bin
+
+#endif /* SYS_HUFFMAN_H */
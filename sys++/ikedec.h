@@ -0,0 +1,284 @@
+// -*- C++ -*-
+//! \file       ikedec.h
+//! \date       2026 Oct 16
+//! \brief      decoder for 'ike' compressed files.
+//
+
+#ifndef SYS_IKEDEC_H
+#define SYS_IKEDEC_H
+
+#include "bindata.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace bin {
+
+namespace detail {
+
+// ike_bits
+// control bits are taken from 16-bit little-endian words starting from the
+// least significant bit, while literal bytes are read from the same stream.
+// next word is fetched as soon as the last bit of the current one is used up,
+// so its position depends on bytes read before that moment.  that rules out
+// refilling ahead of time, instead peek() combines remaining bits of the
+// current word with the word that would be fetched next.
+
+class ike_bits
+{
+public:
+    ike_bits (const uint8_t* src, const uint8_t* end)
+	: m_src (src), m_end (end)
+	{ fetch(); }
+
+    /// peek()
+    /// Returns: next 17 bits at least, first bit in the lowest position.  bits
+    /// past the end of input are zeroes.
+
+    uint32_t peek () const
+	{
+	    uint32_t next = m_end - m_src >= 2 ? m_src[0] | m_src[1] << 8 : 0;
+	    return m_bits | next << m_left;
+	}
+
+    /// consume (N)
+    /// Effects: drops N bits, N <= 16.
+    /// Throws: std::runtime_error if the next word is needed and input is
+    /// exhausted.
+
+    void consume (unsigned n)
+	{
+	    if (n < m_left)
+	    {
+		m_bits >>= n;
+		m_left -= n;
+	    }
+	    else
+	    {
+		n -= m_left;
+		fetch();
+		m_bits >>= n;
+		m_left -= n;
+	    }
+	}
+
+    unsigned get_bit ()
+	{
+	    unsigned bit = m_bits & 1;
+	    consume (1);
+	    return bit;
+	}
+
+    uint8_t read_byte ()
+	{
+	    if (m_src == m_end)
+		end_of_stream();
+	    return *m_src++;
+	}
+
+private:
+    void fetch ()
+	{
+	    if (m_end - m_src < 2)
+		end_of_stream();
+	    m_bits = m_src[0] | m_src[1] << 8;
+	    m_left = 16;
+	    m_src += 2;
+	}
+
+    static void end_of_stream ()
+	{ throw std::runtime_error ("end of stream"); }
+
+    const uint8_t*	m_src;
+    const uint8_t*	m_end;
+    uint32_t		m_bits;		// unused bits of the current word
+    unsigned		m_left;		// number of unused bits, never zero
+};
+
+// ike_tables
+// prefix codes that follow offset byte of long match.  both tables are
+// indexed by upcoming bits and give number of bits the prefix takes.
+
+struct ike_tables
+{
+    struct offset_entry { int16_t delta; uint8_t length; };
+    struct count_entry { uint16_t count; uint8_t length; };	// count 0 means byte + 17
+
+    offset_entry	offset[0x100];
+    count_entry		count[0x200];
+
+    ike_tables ()
+	{
+	    for (unsigned bits = 0; bits < 0x100; ++bits)
+		offset[bits] = make_offset (bits);
+	    for (unsigned bits = 0; bits < 0x200; ++bits)
+		count[bits] = make_count (bits);
+	}
+
+    static const ike_tables& instance ()
+	{
+	    static const ike_tables tables;
+	    return tables;
+	}
+
+private:
+    static offset_entry make_offset (unsigned bits)
+	{
+	    unsigned length = 0;
+	    auto bit = [&] { return bits >> length++ & 1; };
+	    int delta = 0, shift = 0;
+	    if (!bit())
+		shift += 0x100;
+	    if (!bit())
+	    {
+		delta -= 0x200;
+		if (!bit())
+		{
+		    shift <<= 1;
+		    if (!bit())
+			shift += 0x100;
+		    delta -= 0x200;
+		    if (!bit())
+		    {
+			shift <<= 1;
+			if (!bit())
+			    shift += 0x100;
+			delta -= 0x400;
+			if (!bit())
+			{
+			    delta -= 0x800;
+			    shift <<= 1;
+			    if (!bit())
+				shift += 0x100;
+			}
+		    }
+		}
+	    }
+	    offset_entry e = { static_cast<int16_t> (delta - shift), static_cast<uint8_t> (length) };
+	    return e;
+	}
+
+    static count_entry make_count (unsigned bits)
+	{
+	    unsigned length = 0;
+	    auto bit = [&] { return bits >> length++ & 1; };
+	    unsigned count;
+	    if (bit())
+		count = 3;
+	    else if (bit())
+		count = 4;
+	    else if (bit())
+		count = 5;
+	    else if (bit())
+		count = 6;
+	    else if (bit())
+		count = bit() ? 8 : 7;
+	    else if (bit())
+		count = 0;
+	    else
+	    {
+		count = 9;
+		if (bit())
+		    count = 13;
+		if (bit())
+		    count += 2;
+		if (bit())
+		    count++;
+	    }
+	    count_entry e = { static_cast<uint16_t> (count), static_cast<uint8_t> (length) };
+	    return e;
+	}
+};
+
+} // namespace detail
+
+/// ike_unpacked_size (HEADER)
+///
+/// Returns: unpacked size stored in 13-byte header of 'ike' file.
+
+inline size_t ike_unpacked_size (const uint8_t* header)
+{
+    return header[11] + ((header[12] + (header[10] >> 2 << 8)) << 8);
+}
+
+/// ike_decompress (INPUT, INPUT_SIZE, OUTPUT, OUTPUT_SIZE)
+///
+/// Effects: decodes 'ike' file INPUT of INPUT_SIZE bytes, including header,
+/// into buffer OUTPUT.  decoding stops after OUTPUT_SIZE bytes or at the end
+/// marker.
+/// Returns: number of bytes written.
+/// Throws: std::runtime_error if input is exhausted or match refers before
+/// the start of output.
+
+inline size_t ike_decompress (const uint8_t* input, size_t input_size, uint8_t* output, size_t output_size)
+{
+    if (input_size < 13)
+	throw std::runtime_error ("end of stream");
+    const detail::ike_tables& tables = detail::ike_tables::instance();
+    detail::ike_bits bits (input + 13, input + input_size);
+    size_t dst = 0;
+    while (dst < output_size)
+    {
+	if (bits.get_bit())
+	{
+	    output[dst++] = bits.read_byte();
+	    continue;
+	}
+	bool long_match = bits.get_bit();
+	int offset = bits.read_byte() | -0x100;
+	size_t count;
+	if (long_match)
+	{
+	    const auto& o = tables.offset[bits.peek() & 0xFF];
+	    bits.consume (o.length);
+	    offset += o.delta;
+	    const auto& c = tables.count[bits.peek() & 0x1FF];
+	    bits.consume (c.length);
+	    count = c.count ? c.count : bits.read_byte() + 17;
+	}
+	else
+	{
+	    uint32_t code = bits.peek();
+	    if (code & 1)
+	    {
+		bits.consume (4);
+		code = ~code;
+		offset -= 0x100 + (code << 9 & 0x400) + (code << 7 & 0x200) + (code << 5 & 0x100);
+	    }
+	    else
+	    {
+		bits.consume (1);
+		if (-1 == offset)
+		{
+		    if (!bits.get_bit())
+			break;
+		    continue;
+		}
+	    }
+	    count = 2;
+	}
+	size_t distance = -offset;
+	if (distance > dst)
+	    throw std::runtime_error ("invalid compressed stream");
+	count = std::min (count, output_size - dst);
+	uint8_t* out = output + dst;
+	const uint8_t* src = out - distance;
+	dst += count;
+	if (distance >= 8 && output_size - dst >= 8)
+	{
+	    // copy may overrun by up to 7 bytes, which are within output
+	    for (size_t i = 0; i < count; i += 8)
+		std::memcpy (out + i, src + i, 8);
+	}
+	else
+	{
+	    while (count --> 0)
+		*out++ = *src++;
+	}
+    }
+    return dst;
+}
+
+} // namespace bin
+
+#endif /* SYS_IKEDEC_H */
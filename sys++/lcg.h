@@ -0,0 +1,109 @@
+// -*- C++ -*-
+//! \file       lcg.h
+//! \date       2026 Oct 16
+//! \brief      linear congruential generators with skip-ahead.
+//
+// keystreams of many script ciphers are produced by generators like
+// x = A*x + C modulo 2^32.  any number of steps of such generator is itself
+// an affine map, that is computed by repeated squaring, so decryption could
+// start anywhere in the stream.
+
+#ifndef SYS_LCG_H
+#define SYS_LCG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace bin {
+
+/// \struct bin::lcg_step
+///
+/// affine map x -> a*x + c modulo 2^N, where N is the width of UIntT.
+
+template <typename UIntT>
+struct lcg_step
+{
+    static_assert (std::is_unsigned<UIntT>::value && sizeof(UIntT) >= sizeof(unsigned),
+		   "lcg_step requires unsigned type not narrower than unsigned int");
+
+    UIntT	a;
+    UIntT	c;
+
+    UIntT operator() (UIntT x) const { return a * x + c; }
+};
+
+/// lcg_jump (A, C, N)
+///
+/// Returns: map equivalent to N consecutive steps x -> A*x + C.  computed in
+/// O(log N) multiplications.
+
+template <typename UIntT>
+lcg_step<UIntT> lcg_jump (UIntT a, UIntT c, uint64_t n)
+{
+    lcg_step<UIntT> acc = { 1, 0 };
+    // powers of the same map commute, so order of composition doesn't matter
+    while (n)
+    {
+	if (n & 1)
+	{
+	    acc.a = a * acc.a;
+	    acc.c = a * acc.c + c;
+	}
+	c = (a + 1) * c;
+	a = a * a;
+	n >>= 1;
+    }
+    return acc;
+}
+
+/// lcg_jump (STEP, N)
+///
+/// Returns: map equivalent to N consecutive applications of STEP.
+
+template <typename UIntT>
+lcg_step<UIntT> lcg_jump (const lcg_step<UIntT>& step, uint64_t n)
+{
+    return lcg_jump (step.a, step.c, n);
+}
+
+/// lcg_bytes (STEP, X, DST, SIZE)
+///
+/// Effects: stores low bytes of SIZE consecutive states X, STEP(X), ... into
+/// DST and advances X past them.
+///
+/// low byte of state depends on low bits of previous state only, so
+/// sixteen interleaved 16-bit generators, each jumping 16 steps at once,
+/// produce the same bytes without carrying a dependency from one byte to the
+/// next; compilers turn the lane loop into vector multiplies.
+
+template <typename UIntT>
+void lcg_bytes (const lcg_step<UIntT>& step, UIntT& x, uint8_t* dst, size_t size)
+{
+    enum { lanes = 16 };
+    const lcg_step<UIntT> jump = lcg_jump (step, lanes);
+    const unsigned a = static_cast<uint16_t> (jump.a), c = static_cast<uint16_t> (jump.c);
+    uint16_t lane[lanes];
+    UIntT s = x;
+    for (int k = 0; k < lanes; ++k)
+    {
+	lane[k] = static_cast<uint16_t> (s);
+	s = step (s);
+    }
+    size_t i = 0;
+    for (; i + lanes <= size; i += lanes)
+    {
+	for (int k = 0; k < lanes; ++k)
+	{
+	    dst[i+k] = static_cast<uint8_t> (lane[k]);
+	    lane[k] = static_cast<uint16_t> (a * lane[k] + c);
+	}
+    }
+    for (int k = 0; i < size; ++i, ++k)
+	dst[i] = static_cast<uint8_t> (lane[k]);
+    x = lcg_jump (step, size) (x);
+}
+
+} // namespace bin
+
+#endif /* SYS_LCG_H */
@@ -0,0 +1,441 @@
+// -*- C++ -*-
+//! \file       lzssdec.h
+//! \date       2026 Oct 16
+//! \brief      parameterized LZSS decoder writing into contiguous memory.
+//
+
+#ifndef SYS_LZSSDEC_H
+#define SYS_LZSSDEC_H
+
+#include "bitreader.h"		// for bin::msb_first, bin::lsb_first
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+namespace bin {
+
+/// \struct bin::lzss_params
+///
+/// describes LZSS variant.  variants that differ from classic Okumura scheme
+/// derive from this structure and hide members they change.  decoders keep a
+/// copy of Params, so variants known only at run time could make init_pos,
+/// init_frame and decode_ref non-static.
+///
+/// frame_size:  size of the sliding frame, power of two.
+/// init_pos:    frame position where the first byte of output is placed.
+/// flag_order:  order in which flag bits are taken from control byte,
+///              msb_first or lsb_first.  set bit denotes literal byte.
+/// init_frame:  fills frame of frame_size bytes before decoding.
+/// decode_ref:  extracts frame offset and byte count from two bytes of match
+///              reference.
+///
+/// lzss_encoder also uses
+/// min_match, max_match: range of byte counts that match reference can hold.
+/// encode_ref:  stores frame offset and byte count into two bytes of match
+///              reference, inverse of decode_ref.
+
+template <unsigned FrameSize = 0x1000, unsigned InitPos = 0xFEE, class Order = lsb_first>
+struct lzss_params
+{
+    SYSPP_static_constexpr unsigned frame_size = FrameSize;
+    SYSPP_static_constexpr unsigned init_pos = InitPos;
+    typedef Order flag_order;
+
+    static void init_frame (uint8_t* frame)
+	{ std::memset (frame, 0, frame_size); }
+
+    SYSPP_static_constexpr unsigned min_match = 3;
+    SYSPP_static_constexpr unsigned max_match = 18;
+
+    // 12-bit offset, 4-bit count biased by 3
+    static void decode_ref (unsigned lo, unsigned hi, unsigned& offset, unsigned& count)
+	{
+	    offset = (hi & 0xF0) << 4 | lo;
+	    count = (hi & 0xF) + 3;
+	}
+    static void encode_ref (unsigned offset, unsigned count, uint8_t* ref)
+	{
+	    ref[0] = static_cast<uint8_t> (offset);
+	    ref[1] = static_cast<uint8_t> ((offset >> 4 & 0xF0) | (count - 3));
+	}
+};
+
+/// \class bin::lzss_decoder
+///
+/// decodes LZSS stream described by Params into caller-supplied memory.
+///
+/// the frame is never materialized.  every match reference is translated into
+/// distance back from the current output position and copied from the output
+/// itself, while initial frame contents are kept as a virtual prefix that
+/// precedes the first output byte.  matches that are far enough from the
+/// current position are copied eight bytes at a time.
+///
+/// decoding may be suspended when output is full and resumed later with more
+/// output space, see decode (ORIGIN, DST, DST_END).  likewise, when input is
+/// exhausted, decoding may be resumed with the next chunk of input passed to
+/// feed(); match reference split between chunks is kept in between.
+
+template <class Params>
+class lzss_decoder
+{
+public:
+    typedef Params params_type;
+
+    SYSPP_static_constexpr unsigned frame_size = Params::frame_size;
+    SYSPP_static_constexpr unsigned frame_mask = frame_size - 1;
+
+    lzss_decoder (const uint8_t* src, size_t src_size, const Params& params = Params())
+	: m_params (params), m_src (src), m_src_end (src + src_size)
+	, m_ctl (empty_flags (flag_order()))
+	, m_total (0), m_pending (0), m_distance (0), m_partial (-1)
+	{
+	    m_params.init_frame (m_prefix);
+	    // arrange frame so that byte preceding the first output byte is the
+	    // last one in prefix.
+	    std::rotate (m_prefix, m_prefix + (m_params.init_pos & frame_mask), m_prefix + frame_size);
+	}
+
+    /// decode (DST, DST_SIZE)
+    ///
+    /// Effects: decodes stream into buffer DST of DST_SIZE bytes.
+    /// Returns: number of bytes written.
+
+    size_t decode (uint8_t* dst, size_t dst_size)
+	{ return decode (dst, dst, dst + dst_size) - dst; }
+
+    /// decode (ORIGIN, DST, DST_END)
+    ///
+    /// Effects: continues decoding into [DST, DST_END) until input is exhausted
+    /// or output is full.  ORIGIN points to the first byte of output preceding
+    /// DST; either it is the very first output byte or there are at least
+    /// frame_size bytes of previous output between ORIGIN and DST.  up to 7
+    /// bytes past the returned pointer may be overwritten with garbage.
+    /// Returns: pointer past the last byte written.
+
+    uint8_t* decode (uint8_t* origin, uint8_t* dst, uint8_t* const dst_end);
+
+    /// feed (SRC, SRC_SIZE)
+    ///
+    /// Effects: replaces remaining input with SRC_SIZE bytes at SRC, which
+    /// continue the stream.  should be called when decode() stops short of
+    /// output end, i.e. when previous input is exhausted.
+
+    void feed (const uint8_t* src, size_t src_size)
+	{
+	    m_src = src;
+	    m_src_end = src + src_size;
+	}
+
+    /// done()
+    ///
+    /// Returns: true if the whole input has been decoded.  incomplete match
+    /// reference at the end of input is ignored.
+
+    bool done () const { return !m_pending && m_src == m_src_end; }
+
+    /// total()
+    ///
+    /// Returns: number of bytes decoded so far.
+
+    size_t total () const { return m_total; }
+
+private:
+    typedef typename Params::flag_order flag_order;
+
+    // control byte is kept with a sentinel bit, so that it is reloaded when
+    // only the sentinel remains.
+
+    static unsigned empty_flags (lsb_first) { return 1; }
+    static unsigned empty_flags (msb_first) { return 0x80000000u; }
+    bool is_empty (lsb_first) const { return 1 == m_ctl; }
+    bool is_empty (msb_first) const { return 0x80000000u == m_ctl; }
+    void load_flags (unsigned ctl, lsb_first) { m_ctl = ctl | 0x100; }
+    void load_flags (unsigned ctl, msb_first) { m_ctl = ctl << 24 | 0x800000; }
+    bool next_flag (lsb_first)
+	{
+	    bool bit = m_ctl & 1;
+	    m_ctl >>= 1;
+	    return bit;
+	}
+    bool next_flag (msb_first)
+	{
+	    bool bit = (m_ctl & 0x80000000u) != 0;
+	    m_ctl <<= 1;
+	    return bit;
+	}
+
+    uint8_t* start_match (unsigned lo, unsigned hi, uint8_t* origin, uint8_t* dst, uint8_t* dst_end);
+    uint8_t* copy_match (uint8_t* origin, uint8_t* dst, uint8_t* dst_end);
+
+    Params		m_params;
+    const uint8_t*	m_src;
+    const uint8_t*	m_src_end;
+    unsigned		m_ctl;		// control bits with sentinel
+    size_t		m_total;	// number of bytes written
+    unsigned		m_pending;	// bytes of match left when output was full
+    unsigned		m_distance;	// distance to the source of pending match
+    int			m_partial;	// first byte of reference cut by end of input, or -1
+    uint8_t		m_prefix[frame_size];
+};
+
+template <class Params>
+uint8_t* lzss_decoder<Params>::
+decode (uint8_t* origin, uint8_t* dst, uint8_t* const dst_end)
+{
+    if (m_pending)
+	dst = copy_match (origin, dst, dst_end);
+    else if (m_partial >= 0 && dst != dst_end)
+    {
+	if (m_src == m_src_end)
+	    return dst;
+	unsigned lo = m_partial;
+	m_partial = -1;
+	dst = start_match (lo, *m_src++, origin, dst, dst_end);
+    }
+    while (dst != dst_end)
+    {
+	if (is_empty (flag_order()))
+	{
+	    if (m_src == m_src_end)
+		break;
+	    unsigned ctl = *m_src++;
+	    // run of eight literals
+	    if (0xFF == ctl && m_src_end - m_src >= 8 && dst_end - dst >= 8)
+	    {
+		std::memcpy (dst, m_src, 8);
+		m_src += 8;
+		dst += 8;
+		m_total += 8;
+		continue;
+	    }
+	    load_flags (ctl, flag_order());
+	}
+	// flag is left in place until there's input for it
+	if (m_src == m_src_end)
+	    break;
+	if (next_flag (flag_order()))
+	{
+	    *dst++ = *m_src++;
+	    ++m_total;
+	}
+	else
+	{
+	    if (m_src_end - m_src < 2)
+	    {
+		m_partial = *m_src++;
+		break;
+	    }
+	    dst = start_match (m_src[0], m_src[1], origin, dst, dst_end);
+	    m_src += 2;
+	}
+    }
+    return dst;
+}
+
+template <class Params>
+inline uint8_t* lzss_decoder<Params>::
+start_match (unsigned lo, unsigned hi, uint8_t* origin, uint8_t* dst, uint8_t* dst_end)
+{
+    unsigned offset, count;
+    m_params.decode_ref (lo, hi, offset, count);
+    const unsigned frame_pos = (m_params.init_pos + m_total) & frame_mask;
+    m_distance = (frame_pos - offset) & frame_mask;
+    if (!m_distance)
+	m_distance = frame_size;
+    m_pending = count;
+    return copy_match (origin, dst, dst_end);
+}
+
+template <class Params>
+uint8_t* lzss_decoder<Params>::
+copy_match (uint8_t* origin, uint8_t* dst, uint8_t* const dst_end)
+{
+    unsigned count = std::min<size_t> (m_pending, dst_end - dst);
+    m_pending -= count;
+    m_total += count;
+    const size_t history = dst - origin;
+    if (m_distance > history)
+    {
+	// source starts within initial frame
+	const uint8_t* src = m_prefix + frame_size - (m_distance - history);
+	unsigned prefix_count = std::min<size_t> (count, m_distance - history);
+	dst = std::copy_n (src, prefix_count, dst);
+	count -= prefix_count;
+	if (!count)
+	    return dst;
+    }
+    const uint8_t* src = dst - m_distance;
+    if (m_distance >= 8 && static_cast<size_t> (dst_end - dst) >= count + 7)
+    {
+	// every eight bytes read are already written, and the overrun past the
+	// end of match is overwritten by subsequent output.
+	for (unsigned i = 0; i < count; i += 8)
+	    std::memcpy (dst + i, src + i, 8);
+	dst += count;
+    }
+    else if (1 == m_distance)
+    {
+	std::memset (dst, *src, count);
+	dst += count;
+    }
+    else
+    {
+	while (count --> 0)
+	    *dst++ = *src++;
+    }
+    return dst;
+}
+
+/// lzss_decompress<Params> (SRC, SRC_SIZE, DST, DST_SIZE)
+///
+/// Effects: decodes SRC_SIZE bytes of stream SRC into buffer DST.
+/// Returns: number of bytes written into DST, at most DST_SIZE.
+
+template <class Params>
+size_t lzss_decompress (const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size)
+{
+    lzss_decoder<Params> lzss (src, src_size);
+    return lzss.decode (dst, dst_size);
+}
+
+/// \class bin::lzss_push_decoder
+///
+/// decodes LZSS stream that arrives in chunks of arbitrary size, such as reads
+/// from a pipe, using constant memory.  output is handed to a sink in blocks
+/// as soon as it is decoded; the last frame of output is kept as match
+/// history.
+
+template <class Params>
+class lzss_push_decoder
+{
+public:
+    explicit lzss_push_decoder (size_t block_size = 0x10000)
+	: m_lzss (nullptr, 0), m_buffer (history + block_size), m_pos (0)
+	{ }
+
+    explicit lzss_push_decoder (const Params& params, size_t block_size = 0x10000)
+	: m_lzss (nullptr, 0, params), m_buffer (history + block_size), m_pos (0)
+	{ }
+
+    /// push (SRC, SRC_SIZE, SINK)
+    ///
+    /// Effects: decodes SRC_SIZE bytes of stream SRC, that continue previously
+    /// pushed input.  all decoded output is passed to SINK (DATA, SIZE), which
+    /// may be called several times.
+
+    template <class Sink>
+    void push (const uint8_t* src, size_t src_size, Sink sink);
+
+    /// total()
+    ///
+    /// Returns: number of bytes decoded so far.
+
+    size_t total () const { return m_lzss.total(); }
+
+private:
+    enum { history = Params::frame_size };
+
+    lzss_decoder<Params> m_lzss;
+    std::vector<uint8_t> m_buffer;
+    size_t		m_pos;		// end of decoded output within m_buffer
+};
+
+template <class Params>
+template <class Sink>
+void lzss_push_decoder<Params>::
+push (const uint8_t* src, size_t src_size, Sink sink)
+{
+    uint8_t* const origin = m_buffer.data();
+    uint8_t* const end = origin + m_buffer.size();
+    m_lzss.feed (src, src_size);
+    for (;;)
+    {
+	uint8_t* start = origin + m_pos;
+	uint8_t* dst = m_lzss.decode (origin, start, end);
+	if (dst != start)
+	    sink (start, static_cast<size_t> (dst - start));
+	m_pos = dst - origin;
+	if (dst != end)
+	    break;
+	// keep the last frame of output as match history
+	std::memmove (origin, end - history, history);
+	m_pos = history;
+    }
+}
+
+/// lzss_decompress<Params> (SRC, SRC_SIZE, OUT)
+///
+/// Effects: decodes SRC_SIZE bytes of stream SRC into output stream OUT, for
+/// callers that don't know unpacked size in advance.
+/// Returns: number of bytes written.
+
+template <class Params>
+size_t lzss_decompress (const uint8_t* src, size_t src_size, std::ostream& out)
+{
+    lzss_push_decoder<Params> lzss;
+    lzss.push (src, src_size, [&out] (const uint8_t* data, size_t size) {
+	out.write (reinterpret_cast<const char*> (data), size);
+    });
+    return lzss.total();
+}
+
+// encrypted input is decrypted in chunks of this size into a buffer on the
+// stack, that stays in cache while decoder reads it.
+
+enum { lzss_filter_chunk = 0x4000 };
+
+/// lzss_decompress<Params> (SRC, SRC_SIZE, DST, DST_SIZE, FILTER)
+///
+/// Effects: decodes SRC_SIZE bytes of encrypted stream SRC into buffer DST.
+/// FILTER (DATA, SIZE, OFFSET) decrypts in place SIZE bytes of input at DATA
+/// that were copied from OFFSET within SRC.  SRC itself is not modified, so
+/// it could be read-only mapping.
+/// Returns: number of bytes written into DST, at most DST_SIZE.
+
+template <class Params, class Filter>
+size_t lzss_decompress (const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size,
+			Filter filter)
+{
+    uint8_t chunk[lzss_filter_chunk];
+    lzss_decoder<Params> lzss (nullptr, 0);
+    uint8_t* out = dst;
+    uint8_t* const end = dst + dst_size;
+    for (size_t pos = 0; pos < src_size && out != end; pos += lzss_filter_chunk)
+    {
+	size_t n = std::min<size_t> (lzss_filter_chunk, src_size - pos);
+	std::memcpy (chunk, src + pos, n);
+	filter (chunk, n, pos);
+	lzss.feed (chunk, n);
+	out = lzss.decode (dst, out, end);
+    }
+    return out - dst;
+}
+
+/// lzss_decompress<Params> (SRC, SRC_SIZE, OUT, FILTER)
+///
+/// Effects: decodes SRC_SIZE bytes of encrypted stream SRC into output stream
+/// OUT, FILTER is the same as above.
+/// Returns: number of bytes written.
+
+template <class Params, class Filter>
+size_t lzss_decompress (const uint8_t* src, size_t src_size, std::ostream& out, Filter filter)
+{
+    uint8_t chunk[lzss_filter_chunk];
+    lzss_push_decoder<Params> lzss;
+    auto sink = [&out] (const uint8_t* data, size_t size) {
+	out.write (reinterpret_cast<const char*> (data), size);
+    };
+    for (size_t pos = 0; pos < src_size; pos += lzss_filter_chunk)
+    {
+	size_t n = std::min<size_t> (lzss_filter_chunk, src_size - pos);
+	std::memcpy (chunk, src + pos, n);
+	filter (chunk, n, pos);
+	lzss.push (chunk, n, sink);
+    }
+    return lzss.total();
+}
+
+} // namespace bin
+
+#endif /* SYS_LZSSDEC_H */
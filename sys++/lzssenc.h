@@ -0,0 +1,352 @@
+// -*- C++ -*-
+//! \file       lzssenc.h
+//! \date       2026 Oct 16
+//! \brief      LZSS encoder producing streams for lzss_decoder.
+//
+
+#ifndef SYS_LZSSENC_H
+#define SYS_LZSSENC_H
+
+#include "lzssdec.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace bin {
+
+/// \class bin::lzss_encoder
+///
+/// encodes data into LZSS stream described by Params, see lzss_params.  in
+/// addition to decoder parameters, encoder uses min_match, max_match and
+/// encode_ref members.
+///
+/// matches are searched with hash chains over the last frame of input,
+/// initial frame contents are searched as well.  match distance is limited by
+/// frame_size - max_match, as original LZSS encoder does, so output could be
+/// read by decoders that use frame as a ring buffer with lookahead.
+///
+/// levels:
+///   greedy:  takes the longest match found at each position.
+///   lazy:    defers a match if the next position has a longer one.
+///   optimal: chooses literals and matches minimizing encoded size.
+///
+/// encoder object keeps its tables between calls, so reusing it for many
+/// inputs saves allocations.  it's not thread safe, threads should use
+/// separate objects.
+
+template <class Params>
+class lzss_encoder
+{
+public:
+    enum level_type { greedy, lazy, optimal };
+
+    SYSPP_static_constexpr unsigned frame_size = Params::frame_size;
+    SYSPP_static_constexpr unsigned window_size = Params::frame_size - Params::max_match;
+    SYSPP_static_constexpr unsigned min_match = Params::min_match < 3 ? 3 : Params::min_match;
+    SYSPP_static_constexpr unsigned max_match = Params::max_match;
+
+    explicit lzss_encoder (level_type level = lazy)
+	: m_level (level), m_head (hash_size), m_prev (frame_size)
+	{ }
+
+    level_type level () const { return m_level; }
+
+    /// encode (SRC, SRC_SIZE, OUTPUT)
+    ///
+    /// Effects: appends encoded contents of SRC_SIZE bytes pointed to by SRC
+    /// to OUTPUT.
+    /// Returns: number of bytes appended.
+
+    size_t encode (const uint8_t* src, size_t src_size, std::vector<uint8_t>& output);
+
+private:
+    struct match_type
+    {
+	unsigned length;
+	unsigned distance;
+    };
+
+    enum { hash_bits = 14, hash_size = 1 << hash_bits, nil = -1 };
+
+    // positions below are indexes into m_data, where input is preceded by
+    // frame_size bytes of initial frame.
+
+    unsigned hash (size_t pos) const
+	{
+	    const uint8_t* p = &m_data[pos];
+	    uint32_t v = p[0] | p[1] << 8 | p[2] << 16;
+	    return (v * 2654435761u) >> (32 - hash_bits);
+	}
+
+    void insert (size_t pos)
+	{
+	    unsigned h = hash (pos);
+	    m_prev[pos & (frame_size-1)] = m_head[h];
+	    m_head[h] = static_cast<int> (pos);
+	}
+
+    unsigned match_length (size_t src, size_t pos, unsigned limit) const;
+    match_type find_match (size_t pos, size_t end, unsigned depth) const;
+
+    void put_literal (size_t pos);
+    void put_match (size_t pos, const match_type& match);
+
+    void encode_greedy (size_t end, unsigned depth);
+    void encode_lazy (size_t end, unsigned depth);
+    void encode_optimal (size_t end, unsigned depth);
+
+    void set_flag (unsigned flag, lsb_first) { (*m_output)[m_ctl_pos] |= flag << m_ctl_bit; }
+    void set_flag (unsigned flag, msb_first) { (*m_output)[m_ctl_pos] |= flag << (7 - m_ctl_bit); }
+    void put_flag (unsigned flag);
+
+    level_type			m_level;
+    std::vector<int>		m_head;
+    std::vector<int>		m_prev;
+    std::vector<uint8_t>	m_data;
+    std::vector<uint8_t>	m_lengths;	// optimal parse: longest match at position
+    std::vector<uint16_t>	m_distances;
+    std::vector<uint32_t>	m_cost;
+    std::vector<uint8_t>*	m_output;
+    size_t			m_ctl_pos;	// position of current control byte
+    unsigned			m_ctl_bit;	// number of flags in current control byte
+};
+
+template <class Params>
+size_t lzss_encoder<Params>::
+encode (const uint8_t* src, size_t src_size, std::vector<uint8_t>& output)
+{
+    const size_t start_size = output.size();
+    m_output = &output;
+    m_ctl_bit = 8;
+
+    // initial frame arranged as it would precede output, followed by input
+    // and padding for word-wise comparisons.
+    m_data.resize (frame_size + src_size + 8);
+    Params::init_frame (&m_data[0]);
+    std::rotate (&m_data[0], &m_data[Params::init_pos & (frame_size-1)], &m_data[frame_size]);
+    if (src_size)
+	std::memcpy (&m_data[frame_size], src, src_size);
+    std::memset (&m_data[frame_size + src_size], 0, 8);
+
+    std::fill (m_head.begin(), m_head.end(), int (nil));
+    for (size_t pos = frame_size - window_size; pos < frame_size; ++pos)
+	insert (pos);
+
+    const size_t end = frame_size + src_size;
+    switch (m_level)
+    {
+    case greedy:	encode_greedy (end, 16); break;
+    case lazy:		encode_lazy (end, 64); break;
+    case optimal:	encode_optimal (end, 1024); break;
+    }
+    return output.size() - start_size;
+}
+
+template <class Params>
+unsigned lzss_encoder<Params>::
+match_length (size_t src, size_t pos, unsigned limit) const
+{
+    const uint8_t* s = &m_data[src];
+    const uint8_t* p = &m_data[pos];
+    unsigned length = 0;
+    while (length < limit)
+    {
+	uint64_t a, b;
+	std::memcpy (&a, s + length, 8);
+	std::memcpy (&b, p + length, 8);
+	if (uint64_t diff = little_qword (a ^ b))
+	{
+	    unsigned n = 0;
+	    while (!(diff & 0xFF))
+	    {
+		diff >>= 8;
+		++n;
+	    }
+	    length += n;
+	    break;
+	}
+	length += 8;
+    }
+    return std::min (length, limit);
+}
+
+template <class Params>
+typename lzss_encoder<Params>::match_type lzss_encoder<Params>::
+find_match (size_t pos, size_t end, unsigned depth) const
+{
+    match_type best = { 0, 0 };
+    const unsigned limit = static_cast<unsigned> (std::min<size_t> (size_t (max_match), end - pos));
+    if (limit < min_match)
+	return best;
+    const size_t low = pos - window_size;
+    int cand = m_head[hash (pos)];
+    while (cand != nil && static_cast<size_t> (cand) >= low && depth--)
+    {
+	// quick reject on the byte that would extend the best match
+	if (m_data[cand + best.length] == m_data[pos + best.length])
+	{
+	    unsigned length = match_length (cand, pos, limit);
+	    if (length > best.length)
+	    {
+		best.length = length;
+		best.distance = static_cast<unsigned> (pos - cand);
+		if (length == limit)
+		    break;
+	    }
+	}
+	cand = m_prev[cand & (frame_size-1)];
+    }
+    if (best.length < min_match)
+	best.length = 0;
+    return best;
+}
+
+template <class Params>
+void lzss_encoder<Params>::
+put_flag (unsigned flag)
+{
+    if (8 == m_ctl_bit)
+    {
+	m_ctl_pos = m_output->size();
+	m_output->push_back (0);
+	m_ctl_bit = 0;
+    }
+    if (flag)
+	set_flag (flag, typename Params::flag_order());
+    ++m_ctl_bit;
+}
+
+template <class Params>
+void lzss_encoder<Params>::
+put_literal (size_t pos)
+{
+    put_flag (1);
+    m_output->push_back (m_data[pos]);
+}
+
+template <class Params>
+void lzss_encoder<Params>::
+put_match (size_t pos, const match_type& match)
+{
+    put_flag (0);
+    // frame position of the first byte to copy
+    unsigned offset = (Params::init_pos + pos - frame_size - match.distance) & (frame_size-1);
+    uint8_t ref[2];
+    Params::encode_ref (offset, match.length, ref);
+    m_output->insert (m_output->end(), ref, ref+2);
+}
+
+template <class Params>
+void lzss_encoder<Params>::
+encode_greedy (size_t end, unsigned depth)
+{
+    size_t pos = frame_size;
+    while (pos < end)
+    {
+	match_type match = find_match (pos, end, depth);
+	size_t next = pos + (match.length ? match.length : 1);
+	if (match.length)
+	    put_match (pos, match);
+	else
+	    put_literal (pos);
+	for (; pos < next; ++pos)
+	    if (pos + 3 <= end)
+		insert (pos);
+    }
+}
+
+template <class Params>
+void lzss_encoder<Params>::
+encode_lazy (size_t end, unsigned depth)
+{
+    size_t pos = frame_size;
+    match_type match = find_match (pos, end, depth);
+    while (pos < end)
+    {
+	if (pos + 3 <= end)
+	    insert (pos);
+	if (!match.length)
+	{
+	    put_literal (pos++);
+	    if (pos < end)
+		match = find_match (pos, end, depth);
+	    continue;
+	}
+	match_type next = { 0, 0 };
+	if (match.length < max_match && pos + 1 < end)
+	    next = find_match (pos + 1, end, depth);
+	if (next.length > match.length)
+	{
+	    put_literal (pos++);
+	    match = next;
+	    continue;
+	}
+	put_match (pos, match);
+	const size_t stop = pos + match.length;
+	while (++pos < stop)
+	    if (pos + 3 <= end)
+		insert (pos);
+	if (pos < end)
+	    match = find_match (pos, end, depth);
+    }
+}
+
+template <class Params>
+void lzss_encoder<Params>::
+encode_optimal (size_t end, unsigned depth)
+{
+    // literal takes flag bit and a byte, match takes flag bit and two bytes,
+    // so any match length up to the longest one costs the same.  longest
+    // matches are collected for every position, then the cheapest path to the
+    // end is found backwards.
+    const size_t count = end - frame_size;
+    m_lengths.assign (count, 0);
+    m_distances.resize (count);
+    for (size_t i = 0; i < count; ++i)
+    {
+	const size_t pos = frame_size + i;
+	match_type match = find_match (pos, end, depth);
+	m_lengths[i] = static_cast<uint8_t> (match.length);
+	m_distances[i] = static_cast<uint16_t> (match.distance);
+	if (pos + 3 <= end)
+	    insert (pos);
+    }
+    const uint32_t literal_cost = 9, match_cost = 17;
+    m_cost.assign (count + 1, 0);
+    for (size_t i = count; i-- > 0; )
+    {
+	uint32_t best = literal_cost + m_cost[i+1];
+	unsigned best_length = 1;
+	for (unsigned length = min_match; length <= m_lengths[i]; ++length)
+	{
+	    uint32_t cost = match_cost + m_cost[i+length];
+	    if (cost < best)
+	    {
+		best = cost;
+		best_length = length;
+	    }
+	}
+	m_cost[i] = best;
+	// reuse length table to remember chosen step
+	m_lengths[i] = static_cast<uint8_t> (best_length);
+    }
+    for (size_t i = 0; i < count; )
+    {
+	const size_t pos = frame_size + i;
+	if (1 == m_lengths[i])
+	{
+	    put_literal (pos);
+	    ++i;
+	}
+	else
+	{
+	    match_type match = { m_lengths[i], m_distances[i] };
+	    put_match (pos, match);
+	    i += match.length;
+	}
+    }
+}
+
+} // namespace bin
+
+#endif /* SYS_LZSSENC_H */
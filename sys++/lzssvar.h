@@ -0,0 +1,90 @@
+// -*- C++ -*-
+//! \file       lzssvar.h
+//! \date       2026 Oct 16
+//! \brief      LZSS variants used by the tools.
+//
+
+#ifndef SYS_LZSSVAR_H
+#define SYS_LZSSVAR_H
+
+#include "lzssdec.h"
+
+namespace bin {
+
+// every variant below describes both decoder and encoder side of the scheme,
+// see lzss_params.
+
+/// \typedef bin::classic_lzss
+///
+/// classic Okumura LZSS.
+
+typedef lzss_params<> classic_lzss;
+
+/// \struct bin::bcs_lzss
+///
+/// TanukiSoft BCS, same as classic LZSS except that match length is stored
+/// inverted.
+
+struct bcs_lzss : lzss_params<>
+{
+    static void decode_ref (unsigned lo, unsigned hi, unsigned& offset, unsigned& count)
+	{
+	    offset = (hi & 0xF0) << 4 | lo;
+	    count = 3 + (~hi & 0xF);
+	}
+    static void encode_ref (unsigned offset, unsigned count, uint8_t* ref)
+	{
+	    ref[0] = static_cast<uint8_t> (offset);
+	    ref[1] = static_cast<uint8_t> ((offset >> 4 & 0xF0) | (~(count - 3) & 0xF));
+	}
+};
+
+/// \struct bin::ps2_lzss
+///
+/// PS2A scripts, 2K frame, 11-bit offset and 5-bit count biased by 2.
+
+struct ps2_lzss : lzss_params<0x800, 0x7DF>
+{
+    SYSPP_static_constexpr unsigned min_match = 2;
+    SYSPP_static_constexpr unsigned max_match = 33;
+
+    static void decode_ref (unsigned lo, unsigned hi, unsigned& offset, unsigned& count)
+	{
+	    offset = lo | (hi & 0xE0) << 3;
+	    count = (hi & 0x1F) + 2;
+	}
+    static void encode_ref (unsigned offset, unsigned count, uint8_t* ref)
+	{
+	    ref[0] = static_cast<uint8_t> (offset);
+	    ref[1] = static_cast<uint8_t> ((offset >> 3 & 0xE0) | (count - 2));
+	}
+};
+
+/// \struct bin::advc_lzss
+///
+/// ADVB/ADVC scripts by Discovery, classic LZSS with frame pre-seeded by byte
+/// runs and sequences.
+
+struct advc_lzss : lzss_params<>
+{
+    static void init_frame (uint8_t* frame)
+	{
+	    lzss_params::init_frame (frame);
+	    size_t dst = 0;
+	    for (int i = 0; i < 0x100; ++i)
+		for (int j = 0; j < 13; ++j)
+		    frame[dst++] = i;
+	    // 0xD00
+	    for (int i = 0; i < 0x100; ++i)
+		frame[dst++] = i;
+	    // 0xE00
+	    for (int i = 0xFF; i >= 0; --i)
+		frame[dst++] = i;
+	    // 0xF00 is zero-filled, followed by 0x6E spaces at 0xF80
+	    std::memset (frame+0xF80, 0x20, 0x6E);
+	}
+};
+
+} // namespace bin
+
+#endif /* SYS_LZSSVAR_H */
@@ -0,0 +1,78 @@
+// -*- C++ -*-
+//! \file       parallel.h
+//! \date       2026 Oct 16
+//! \brief      split processing of memory range between threads.
+//
+
+#ifndef SYS_PARALLEL_H
+#define SYS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace sys {
+
+/// parallel (SIZE, THREADS, CHUNK_SIZE, FUNC)
+///
+/// Effects: splits range [0, SIZE) into chunks of CHUNK_SIZE bytes, the last
+/// one may be shorter, and calls FUNC (POS, COUNT) for every chunk from
+/// THREADS threads including the calling one, zero selects number of CPUs.
+/// chunks are picked by threads in order, as they become free.  FUNC is called
+/// concurrently and should not throw.
+
+template <class Func>
+void parallel (size_t size, unsigned threads, size_t chunk_size, Func func)
+{
+    const size_t chunk_count = (size + chunk_size - 1) / chunk_size;
+    if (!threads)
+	threads = std::thread::hardware_concurrency();
+    threads = static_cast<unsigned> (std::max<size_t> (1, std::min<size_t> (threads, chunk_count)));
+    std::atomic<size_t> next_chunk (0);
+    auto worker = [&] {
+	size_t n;
+	while ((n = next_chunk++) < chunk_count)
+	{
+	    size_t pos = n * chunk_size;
+	    func (pos, std::min (chunk_size, size - pos));
+	}
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+	pool.emplace_back (worker);
+    worker();
+    for (auto& t : pool)
+	t.join();
+}
+
+/// threads_option (ARGC, ARGV, ARGN)
+///
+/// Effects: if ARGV[ARGN] is "-j" followed by a number, advances ARGN past
+/// both arguments.
+/// Returns: number of threads for parallel(), zero if option is absent.
+/// Throws: std::invalid_argument if number is missing or malformed.
+
+template <typename CharT>
+unsigned threads_option (int argc, CharT* argv[], int& argn)
+{
+    if (argn >= argc || '-' != argv[argn][0] || 'j' != argv[argn][1] || 0 != argv[argn][2])
+	return 0;
+    if (argn + 1 >= argc || !argv[argn+1][0])
+	throw std::invalid_argument ("-j option requires number of threads");
+    unsigned threads = 0;
+    for (const CharT* p = argv[argn+1]; *p; ++p)
+    {
+	if (*p < '0' || *p > '9' || threads > 0xFFFF)
+	    throw std::invalid_argument ("invalid number of threads");
+	threads = threads * 10 + (*p - '0');
+    }
+    argn += 2;
+    return threads;
+}
+
+} // namespace sys
+
+#endif /* SYS_PARALLEL_H */
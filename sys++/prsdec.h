@@ -0,0 +1,255 @@
+// -*- C++ -*-
+//! \file       prsdec.h
+//! \date       2026 Oct 16
+//! \brief      PRS decoder used by ADVIZ engine scripts.
+//
+
+#ifndef SYS_PRSDEC_H
+#define SYS_PRSDEC_H
+
+#include "bindata.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace bin {
+
+/// \class bin::prs_decoder
+///
+/// stream consists of 16-bit little-endian control words, each followed by 16
+/// tokens.  control bits are taken from the most significant one; clear bit
+/// denotes literal byte, set bit denotes back reference:
+///
+///   xxxx yyy1             count = xxxx + 2, distance = yyyy + 1
+///   xxxx xyyy yyyy yyy0   count = xxxxx + 2, distance = y + 1 (up to 1024)
+///
+/// the second byte of long reference holds the upper bits.
+///
+/// when both input and output have room for a whole group of 16 tokens,
+/// the group is decoded without bounds checks; otherwise each token is checked.
+/// decoding may be suspended when output is full and resumed later, see
+/// decode (ORIGIN, DST, DST_END).
+
+class prs_decoder
+{
+public:
+    prs_decoder (const uint8_t* src, size_t src_size)
+	: m_src (src), m_src_end (src + src_size)
+	, m_ctl (0), m_bits (0), m_pending (0), m_distance (0)
+	{ }
+
+    /// decode (DST, DST_SIZE)
+    ///
+    /// Effects: decodes stream into buffer DST of DST_SIZE bytes.
+    /// Returns: number of bytes written.
+    /// Throws: std::runtime_error if stream is invalid.
+
+    size_t decode (uint8_t* dst, size_t dst_size)
+	{ return decode (dst, dst, dst + dst_size) - dst; }
+
+    /// decode (ORIGIN, DST, DST_END)
+    ///
+    /// Effects: continues decoding into [DST, DST_END) until input is exhausted
+    /// or output is full.  ORIGIN points to the first byte of output.  up to 7
+    /// bytes past the returned pointer may be overwritten with garbage.
+    /// Returns: pointer past the last byte written.
+    /// Throws: std::runtime_error if stream is invalid.
+
+    uint8_t* decode (uint8_t* origin, uint8_t* dst, uint8_t* const dst_end);
+
+    /// done()
+    ///
+    /// Returns: true if the whole input has been decoded.
+
+    bool done () const { return !m_pending && m_src == m_src_end; }
+
+private:
+    // longest token takes 2 bytes of input and produces 33 bytes of output.
+    SYSPP_static_constexpr unsigned max_count = 33;
+    SYSPP_static_constexpr unsigned group_input = 2 + 16 * 2;
+    SYSPP_static_constexpr unsigned group_output = 16 * max_count + 8;
+
+    uint8_t* decode_group (uint8_t* origin, uint8_t* dst);
+    uint8_t* copy_match (uint8_t* dst, unsigned count, unsigned distance);
+
+    static void invalid_stream ()
+	{ throw std::runtime_error ("invalid compressed stream"); }
+
+    // decode_ref (SRC, COUNT, DISTANCE)
+    // Returns: pointer past the reference.
+
+    static const uint8_t* decode_ref (const uint8_t* src, unsigned& count, unsigned& distance)
+	{
+	    unsigned code = *src++;
+	    if (code & 1)
+	    {
+		count = (code >> 5) + 2;
+		distance = (code >> 1 & 0xF) + 1;
+	    }
+	    else
+	    {
+		code = *src++ << 7 | code >> 1;
+		count = (code >> 10 & 0x1F) + 2;
+		distance = (code & 0x3FF) + 1;
+	    }
+	    return src;
+	}
+
+    const uint8_t*	m_src;
+    const uint8_t*	m_src_end;
+    unsigned		m_ctl;		// current control word
+    unsigned		m_bits;		// number of unused bits in m_ctl
+    unsigned		m_pending;	// bytes of match left when output was full
+    unsigned		m_distance;	// distance to the source of pending match
+};
+
+inline uint8_t* prs_decoder::
+copy_match (uint8_t* dst, unsigned count, unsigned distance)
+{
+    const uint8_t* src = dst - distance;
+    if (distance >= 8)
+    {
+	// caller guarantees room for overrun
+	for (unsigned i = 0; i < count; i += 8)
+	    std::memcpy (dst + i, src + i, 8);
+	return dst + count;
+    }
+    else if (1 == distance)
+    {
+	std::memset (dst, *src, count);
+	return dst + count;
+    }
+    while (count --> 0)
+	*dst++ = *src++;
+    return dst;
+}
+
+// decode_group (ORIGIN, DST)
+// decodes 16 tokens of the current control word, input and output bounds
+// should be checked by caller.
+
+inline uint8_t* prs_decoder::
+decode_group (uint8_t* origin, uint8_t* dst)
+{
+    unsigned ctl = m_src[0] | m_src[1] << 8;
+    const uint8_t* src = m_src + 2;
+    for (unsigned mask = 0x8000; mask != 0; mask >>= 1)
+    {
+	if (!(ctl & mask))
+	{
+	    *dst++ = *src++;
+	    continue;
+	}
+	unsigned count, distance;
+	src = decode_ref (src, count, distance);
+	if (distance >= static_cast<size_t> (dst - origin))
+	    invalid_stream();
+	dst = copy_match (dst, count, distance);
+    }
+    m_src = src;
+    return dst;
+}
+
+inline uint8_t* prs_decoder::
+decode (uint8_t* origin, uint8_t* dst, uint8_t* const dst_end)
+{
+    if (m_pending)
+    {
+	unsigned count = std::min<size_t> (m_pending, dst_end - dst);
+	m_pending -= count;
+	while (count --> 0)
+	{
+	    *dst = dst[-static_cast<ptrdiff_t> (m_distance)];
+	    ++dst;
+	}
+    }
+    while (dst != dst_end)
+    {
+	if (!m_bits)
+	{
+	    if (m_src_end - m_src >= static_cast<ptrdiff_t> (group_input)
+		&& dst_end - dst >= static_cast<ptrdiff_t> (group_output))
+	    {
+		dst = decode_group (origin, dst);
+		continue;
+	    }
+	    if (m_src == m_src_end)
+		break;
+	    if (m_src_end - m_src < 2)
+		invalid_stream();
+	    m_ctl = m_src[0] | m_src[1] << 8;
+	    m_src += 2;
+	    m_bits = 16;
+	}
+	--m_bits;
+	if (m_src == m_src_end)
+	{
+	    m_bits = 0;
+	    break;
+	}
+	if (!(m_ctl >> m_bits & 1))
+	{
+	    *dst++ = *m_src++;
+	    continue;
+	}
+	if (!(*m_src & 1) && m_src_end - m_src < 2)
+	    invalid_stream();
+	unsigned count, distance;
+	m_src = decode_ref (m_src, count, distance);
+	if (distance >= static_cast<size_t> (dst - origin))
+	    invalid_stream();
+	if (count > static_cast<size_t> (dst_end - dst))
+	{
+	    m_pending = count - static_cast<unsigned> (dst_end - dst);
+	    m_distance = distance;
+	    count = static_cast<unsigned> (dst_end - dst);
+	}
+	// no room for overrun here, copy byte by byte
+	while (count --> 0)
+	{
+	    *dst = dst[-static_cast<ptrdiff_t> (distance)];
+	    ++dst;
+	}
+    }
+    return dst;
+}
+
+/// prs_decompress (SRC, SRC_SIZE, DST, DST_SIZE)
+///
+/// Effects: decodes SRC_SIZE bytes of stream SRC into buffer DST.
+/// Returns: number of bytes written into DST, at most DST_SIZE.
+/// Throws: std::runtime_error if stream is invalid.
+
+inline size_t prs_decompress (const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size)
+{
+    prs_decoder prs (src, src_size);
+    return prs.decode (dst, dst_size);
+}
+
+/// prs_decompress (SRC, SRC_SIZE, OUTPUT)
+///
+/// Effects: decodes SRC_SIZE bytes of stream SRC, replacing contents of
+/// OUTPUT, for callers that don't know unpacked size in advance.
+/// Returns: number of bytes written.
+
+inline size_t prs_decompress (const uint8_t* src, size_t src_size, std::vector<uint8_t>& output)
+{
+    prs_decoder prs (src, src_size);
+    output.resize (std::max<size_t> (src_size * 4, 0x1000));
+    size_t size = 0;
+    for (;;)
+    {
+	uint8_t* origin = output.data();
+	size = prs.decode (origin, origin + size, origin + output.size()) - origin;
+	if (size != output.size() || prs.done())
+	    break;
+	output.resize (size * 2);
+    }
+    output.resize (size);
+    return size;
+}
+
+} // namespace bin
+
+#endif /* SYS_PRSDEC_H */
@@ -36,26 +36,71 @@
 
 namespace sys {
 
+// counting policies -------------------------------------------------------
+//
+//  atomic_count is safe to use when references to the same object are copied
+//  and destroyed by several threads.  plain_count updates counter without bus
+//  locking and is only suitable for objects that never leave single thread.
+//  both policies keep counter in the same storage, so objects have the same
+//  layout regardless of the policy.
+
+struct atomic_count
+{
+    typedef sys::atomic_counter counter_type;
+
+    static void increment (counter_type& count) { sys::atomic_increment (count); }
+    static bool decrement (counter_type& count) { return sys::atomic_decrement (count); }
+    static void set (counter_type& count, long value) { count.store (value); }
+    static long get (const counter_type& count) { return sys::atomic_get (count); }
+};
+
+struct plain_count
+{
+    typedef sys::atomic_counter counter_type;
+
+    static void increment (counter_type& count)
+	{ count.store (count.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    static bool decrement (counter_type& count)
+	{
+	    atomic_type value = count.load (std::memory_order_relaxed) - 1;
+	    count.store (value, std::memory_order_relaxed);
+	    return 0 == value;
+	}
+    static void set (counter_type& count, long value)
+	{ count.store (value, std::memory_order_relaxed); }
+    static long get (const counter_type& count)
+	{ return count.load (std::memory_order_relaxed); }
+};
+
 class SYSPP_DLLIMPORT refcount_base
 {
-    mutable volatile sys::atomic_type ref_count;
+    mutable sys::atomic_counter ref_count;
 
-    template<typename T> friend class refcount_ptr;
+    template<typename T, class P> friend class refcount_ptr;
 
 public:
     refcount_base() : ref_count(0) { }
+
+    // copy of the object is not referenced by anyone
+    refcount_base (const refcount_base&) : ref_count(0) { }
+    refcount_base& operator= (const refcount_base&) { return *this; }
 };
 
 //  refcount_ptr  ------------------------------------------------------------
 //
 //  Requirements: For ptr of type T*, ptr->ref_count must be initialized to 0
+//
+//  CountPolicy defines how reference counter is updated, objects derived from
+//  refcount_base could be referenced by pointers with any policy.  when
+//  the same object is referenced from several threads, all pointers to it
+//  should use atomic_count.
 
-template<typename T>
+template<typename T, class CountPolicy = atomic_count>
 class SYSPP_DLLIMPORT refcount_ptr
 {
     T*		ptr;
 
-    template<typename U> friend class refcount_ptr;
+    template<typename U, class P> friend class refcount_ptr;
 
 public:
     typedef T element_type;
@@ -63,10 +108,10 @@ public:
     // XXX enabled implicit conversion
     //
     /*explicit*/ refcount_ptr (T* p = 0) : ptr (p)
-       	{ if (ptr) sys::atomic_add (ptr->ref_count, 1); }
+       	{ if (ptr) CountPolicy::increment (ptr->ref_count); }
 
     refcount_ptr (const refcount_ptr& other) : ptr (other.ptr)
-       	{ if (ptr) sys::atomic_add (ptr->ref_count, 1); }
+       	{ if (ptr) CountPolicy::increment (ptr->ref_count); }
 
     refcount_ptr (refcount_ptr&& other) : ptr (other.ptr)
         { other.ptr = 0; }
@@ -74,11 +119,11 @@ public:
     ~refcount_ptr () { dispose(); }
 
     template<typename U>
-    refcount_ptr (const refcount_ptr<U>& r) : ptr (r.ptr)
-       	{ if (ptr) sys::atomic_add (ptr->ref_count, 1); }
+    refcount_ptr (const refcount_ptr<U, CountPolicy>& r) : ptr (r.ptr)
+       	{ if (ptr) CountPolicy::increment (ptr->ref_count); }
 
     template<typename U>
-    refcount_ptr (refcount_ptr<U>&& other) : ptr (other.ptr)
+    refcount_ptr (refcount_ptr<U, CountPolicy>&& other) : ptr (other.ptr)
         { other.ptr = 0; }
 
 #if SYSPP_REFCOUNT_PTR_USE_AUTO_PTR
@@ -86,7 +131,7 @@ public:
     refcount_ptr (std::auto_ptr<U>& r)
        	{
 	    ptr = r.release();
-	    if (ptr) sys::atomic_swap (ptr->ref_count, 1);
+	    if (ptr) CountPolicy::set (ptr->ref_count, 1);
 	}
 
     template<typename U>
@@ -94,7 +139,7 @@ public:
        	{
 	    dispose();
 	    ptr = r.release();
-	    if (ptr) sys::atomic_swap (ptr->ref_count, 1);
+	    if (ptr) CountPolicy::set (ptr->ref_count, 1);
 	    return *this;
 	}
 #endif // SYSPP_REFCOUNT_PTR_USE_AUTO_PTR
@@ -117,14 +162,14 @@ public:
         }
 
     template<typename U>
-    refcount_ptr& operator= (const refcount_ptr<U>& r)
+    refcount_ptr& operator= (const refcount_ptr<U, CountPolicy>& r)
 	{
 	    share (r.ptr);
 	    return *this;
 	}
 
     template<typename U>
-    refcount_ptr& operator= (refcount_ptr<U>&& r)
+    refcount_ptr& operator= (refcount_ptr<U, CountPolicy>&& r)
         {
 	    if (ptr != r.ptr)
 	    {
@@ -151,15 +196,15 @@ public:
 
     bool operator! () const { return ptr == 0; }
 
-    long use_count () const { return ptr ? ptr->ref_count : 0; }
-    bool unique () const { return ptr && ptr->ref_count == 1; }
+    long use_count () const { return ptr ? CountPolicy::get (ptr->ref_count) : 0; }
+    bool unique () const { return ptr && CountPolicy::get (ptr->ref_count) == 1; }
 
-    void swap (refcount_ptr<T>& other) { std::swap (ptr, other.ptr); }
+    void swap (refcount_ptr& other) { std::swap (ptr, other.ptr); }
 
 private:
     void dispose ()
 	{
-	    if (ptr && sys::atomic_add (ptr->ref_count, -1) == 1)
+	    if (ptr && CountPolicy::decrement (ptr->ref_count))
 		delete ptr;
 	}
 
@@ -169,27 +214,27 @@ private:
 	    {
 		dispose();
 		ptr = other;
-		if (ptr) sys::atomic_add (ptr->ref_count, 1);
+		if (ptr) CountPolicy::increment (ptr->ref_count);
 	    }
 	}
 };
 
-template<typename T1, typename T2>
-inline bool operator== (const refcount_ptr<T1>& lhs, const refcount_ptr<T2>& rhs)
+template<typename T1, typename T2, class P1, class P2>
+inline bool operator== (const refcount_ptr<T1, P1>& lhs, const refcount_ptr<T2, P2>& rhs)
 {
     return lhs.get() == rhs.get();
 }
 
-template<typename T1, typename T2>
-inline bool operator!= (const refcount_ptr<T1>& lhs, const refcount_ptr<T2>& rhs)
+template<typename T1, typename T2, class P1, class P2>
+inline bool operator!= (const refcount_ptr<T1, P1>& lhs, const refcount_ptr<T2, P2>& rhs)
 {
     return lhs.get() != rhs.get();
 }
 
 // get_pointer() enables boost::mem_fn to recognize refcount_ptr
 
-template <typename T>
-inline T* get_pointer (const refcount_ptr<T>& p)
+template <typename T, class P>
+inline T* get_pointer (const refcount_ptr<T, P>& p)
 {
     return p.get();
 }
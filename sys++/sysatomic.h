@@ -28,9 +28,7 @@
 #define SYSATOMIC_HPP
 
 #include "bindata.h"
-#if SYSPP_MSC
-#include <intrin.h>
-#endif
+#include <atomic>
 
 namespace sys {
 
@@ -40,139 +38,47 @@ typedef long atomic_type;
 typedef bin::int32_t atomic_type;
 #endif
 
-// perform an atomic addition and return initial value.
-
-atomic_type atomic_add (volatile atomic_type& value, atomic_type increment);
-
-// atomically replace value with replacement, return previous value
-
-atomic_type atomic_swap (volatile atomic_type& value, atomic_type replacement);
-
-// atomically read value
-
-atomic_type atomic_get (volatile atomic_type& value);
-
-// ---------------------------------------------------------------------------
-// implementation
-
-#if SYSPP_CLANG || SYSPP_GNUC && __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4
-
-inline atomic_type atomic_add (volatile atomic_type& value, atomic_type increment)
-{
-    return __sync_fetch_and_add (&value, increment);
-}
-
-inline atomic_type atomic_swap (volatile atomic_type& value, atomic_type replacement)
-{
-    return __sync_lock_test_and_set (&value, replacement);
-}
-
-inline atomic_type atomic_get (volatile atomic_type& value)
-{
-    return __sync_val_compare_and_swap (&value, 0, 0);
-}
-
-#elif SYSPP_GNUC && defined(__i386__)
-
-inline atomic_type atomic_add (volatile atomic_type& value, atomic_type increment)
-{
-    atomic_type result;
-    __asm__ __volatile__ (
-	"lock\n\t"
-	"xadd	%1, %0"
-	: "+m" (value), "=r" (result)
-	: "1"  (increment)
-    );
-    return result;
-}
-
-inline atomic_type atomic_swap (volatile atomic_type& value, atomic_type replacement)
-{
-    atomic_type result;
-    __asm__ __volatile__ (
-	"lock\n\t"
-	"xchg	%1, %0"
-	: "+m" (value), "=r" (result)
-	: "1"  (replacement)
-    );
-    return result;
-}
-
-inline atomic_type atomic_get (volatile atomic_type& value)
-{
-    atomic_type result;
-    __asm__ __volatile__ (
-        "xor	%%eax, %%eax\n\t"
-	"lock\n\t"
-	"cmpxchg	%1, %0"
-	: "+m" (value), "=a" (result)
-    );
-    return result;
-}
-
-#elif SYSPP_MSC
-
-inline atomic_type atomic_add (volatile atomic_type& value, atomic_type increment)
-{
-    return _InterlockedExchangeAdd (&value, increment);
-}
+typedef std::atomic<atomic_type> atomic_counter;
 
-inline atomic_type atomic_swap (volatile atomic_type& value, atomic_type replacement)
-{
-    return _InterlockedExchange (&value, replacement);
-}
+// perform an atomic addition and return initial value.
 
-inline atomic_type atomic_get (volatile atomic_type& value)
+inline atomic_type atomic_add (atomic_counter& value, atomic_type increment)
 {
-    return _InterlockedCompareExchange (&value, 0, 0);
+    return value.fetch_add (increment);
 }
 
-#elif defined(_WIN32)
-
-extern "C" atomic_type __stdcall InterlockedExchangeAdd (volatile atomic_type*, atomic_type);
-extern "C" atomic_type __stdcall InterlockedExchange (volatile atomic_type*, atomic_type);
-extern "C" atomic_type __stdcall InterlockedCompareExchange (volatile atomic_type*, atomic_type, atomic_type);
+// atomically replace value with replacement, return previous value
 
-inline atomic_type atomic_add (volatile atomic_type& value, atomic_type increment)
+inline atomic_type atomic_swap (atomic_counter& value, atomic_type replacement)
 {
-    return InterlockedExchangeAdd (&value, increment);
+    return value.exchange (replacement);
 }
 
-inline atomic_type atomic_swap (volatile atomic_type& value, atomic_type replacement)
-{
-    return InterlockedExchange (&value, replacement);
-}
+// atomically read value
 
-inline atomic_type atomic_get (volatile atomic_type& value)
+inline atomic_type atomic_get (const atomic_counter& value)
 {
-    return InterlockedCompareExchange (&value, 0, 0);
+    return value.load();
 }
 
-#else
-
-#warning Unknown environment -- atomic functions are not thread-safe
+// reference counter primitives.  new reference is always made from an existing
+// one, so increment needs no ordering.  decrement that releases the last
+// reference has to see all writes made through other references before the
+// object is destroyed.
 
-inline atomic_type atomic_add (volatile atomic_type& value, atomic_type increment)
+inline void atomic_increment (atomic_counter& value)
 {
-    atomic_type previous = value;
-    value += increment;
-    return previous;
+    value.fetch_add (1, std::memory_order_relaxed);
 }
 
-inline atomic_type atomic_swap (volatile atomic_type& value, atomic_type replacement)
-{
-    atomic_type previous = value;
-    value = replacement;
-    return previous;
-}
+// atomic_decrement (VALUE)
+// Returns: true if VALUE dropped to zero.
 
-inline atomic_type atomic_get (volatile atomic_type& value)
+inline bool atomic_decrement (atomic_counter& value)
 {
-    return value;
+    return 1 == value.fetch_sub (1, std::memory_order_acq_rel);
 }
 
-#endif
-
 } // namespace sys
 
 #endif /* SYSATOMIC_HPP */
@@ -0,0 +1,673 @@
+// -*- C++ -*-
+//! \file       sysbatch.cc
+//! \date       2026 Oct 16
+//! \brief      read multiple files concurrently.
+//
+
+#include "sysbatch.h"
+#include "sysfs.h"
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <stdexcept>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <errno.h>
+#endif
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#endif
+
+namespace sys {
+
+const size_t batch_reader::default_max_read_size;
+
+// --- backend_impl ----------------------------------------------------------
+
+class batch_reader::backend_impl
+{
+public:
+    virtual ~backend_impl () { }
+
+    virtual bool next (item& result) = 0;
+
+    virtual backend_type type () const = 0;
+};
+
+void batch_reader::
+attach (mapping::map_base& map, mapping::detail::map_impl* impl)
+{
+    map.impl.reset (impl);
+}
+
+#ifdef _WIN32
+
+int batch_reader::
+read_file (const native_string& filename, mapping::readwrite& data)
+{
+    sys::file_handle file (::CreateFileW (filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+					  NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL));
+    if (!file)
+	return ::GetLastError();
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx (file, &size))
+	return ::GetLastError();
+    return load (file, size.QuadPart, data);
+}
+
+int batch_reader::
+load (sys::raw_handle file, mapping::off_type size, mapping::readwrite& data)
+try
+{
+    if (size > mapping::off_type (default_max_read_size))
+    {
+	data.open (file, mapping::writecopy, size);
+	return 0;
+    }
+    const size_t length = static_cast<size_t> (size);
+    std::unique_ptr<mapping::detail::buffer_impl> buffer (
+	new mapping::detail::buffer_impl (length, FILE_MAP_COPY));
+    char* const dst = buffer->data();
+    size_t pos = 0;
+    while (pos < length)
+    {
+	DWORD got;
+	if (!::ReadFile (file, dst + pos, static_cast<DWORD> (length - pos), &got, NULL))
+	    return ::GetLastError();
+	if (!got)
+	    break;
+	pos += got;
+    }
+    attach (data, buffer.release());
+    return 0;
+}
+catch (sys::generic_error& X)
+{
+    return X.get_error_code();
+}
+catch (std::bad_alloc&)
+{
+    return ERROR_NOT_ENOUGH_MEMORY;
+}
+
+#else
+
+int batch_reader::
+read_file (const native_string& filename, mapping::readwrite& data)
+{
+    sys::file_handle file (::open (filename.c_str(), O_RDONLY|O_CLOEXEC));
+    if (!file)
+	return errno;
+    struct stat st;
+    if (-1 == ::fstat (file, &st))
+	return errno;
+    return load (file, st.st_size, data);
+}
+
+int batch_reader::
+load (sys::raw_handle file, mapping::off_type size, mapping::readwrite& data)
+try
+{
+    if (size > mapping::off_type (default_max_read_size))
+    {
+	data.open (file, mapping::writecopy, size);
+	return 0;
+    }
+    const size_t length = static_cast<size_t> (size);
+    std::unique_ptr<mapping::detail::buffer_impl> buffer (
+	new mapping::detail::buffer_impl (length, mapping::copy));
+    char* const dst = buffer->data();
+    size_t pos = 0;
+    while (pos < length)
+    {
+	ssize_t got = ::pread (file, dst + pos, length - pos, pos);
+	if (got < 0)
+	{
+	    if (EINTR == errno)
+		continue;
+	    return errno;
+	}
+	if (!got)
+	    break;	// file was truncated meanwhile, the rest is zero-filled
+	pos += got;
+    }
+    attach (data, buffer.release());
+    return 0;
+}
+catch (sys::generic_error& X)
+{
+    return X.get_error_code();
+}
+catch (std::bad_alloc&)
+{
+    return ENOMEM;
+}
+
+#endif /* _WIN32 */
+
+// --- pool_backend ----------------------------------------------------------
+// worker threads pick files by the shared counter and queue read contents.
+// number of queued items is bounded, so that the caller that processes files
+// slower than they're read doesn't end up with the whole batch in memory.
+
+class batch_reader::pool_backend : public backend_impl
+{
+public:
+    pool_backend (const std::vector<native_string>& names, unsigned concurrency)
+	: m_names (names), m_next (0), m_delivered (0)
+	, m_max_ready (2 * concurrency), m_stop (false)
+	{
+	    m_workers.reserve (concurrency);
+	    for (unsigned i = 0; i < concurrency; ++i)
+		m_workers.emplace_back (&pool_backend::run, this);
+	}
+
+    ~pool_backend ()
+	{
+	    {
+		std::lock_guard<std::mutex> lock (m_mutex);
+		m_stop = true;
+	    }
+	    m_space.notify_all();
+	    for (auto& worker : m_workers)
+		worker.join();
+	}
+
+    bool next (item& result)
+	{
+	    if (m_delivered == m_names.size())
+		return false;
+	    std::unique_lock<std::mutex> lock (m_mutex);
+	    m_ready_cond.wait (lock, [this] { return !m_ready.empty(); });
+	    result = std::move (m_ready.front());
+	    m_ready.pop_front();
+	    lock.unlock();
+	    m_space.notify_one();
+	    ++m_delivered;
+	    return true;
+	}
+
+    backend_type type () const { return threads; }
+
+private:
+    void run ()
+	{
+	    for (;;)
+	    {
+		const size_t index = m_next++;
+		if (index >= m_names.size())
+		    break;
+		item file;
+		file.index = index;
+		file.error = read_file (m_names[index], file.data);
+
+		std::unique_lock<std::mutex> lock (m_mutex);
+		m_space.wait (lock, [this] { return m_stop || m_ready.size() < m_max_ready; });
+		if (m_stop)
+		    break;
+		m_ready.push_back (std::move (file));
+		lock.unlock();
+		m_ready_cond.notify_one();
+	    }
+	}
+
+    const std::vector<native_string>&	m_names;
+    std::vector<std::thread>		m_workers;
+    std::atomic<size_t>			m_next;
+    size_t				m_delivered;
+    const size_t			m_max_ready;
+    std::deque<item>			m_ready;
+    std::mutex				m_mutex;
+    std::condition_variable		m_ready_cond;
+    std::condition_variable		m_space;
+    bool				m_stop;
+};
+
+#ifdef __linux__
+
+// --- uring_backend ---------------------------------------------------------
+// every file goes through OPENAT and STATX submitted together, followed by
+// READ into the buffer of the file size.  rings are driven from next() on the
+// caller thread, so no locking is required.  liburing is not required either,
+// ring is set up through raw system calls.
+
+class batch_reader::uring_backend : public backend_impl
+{
+public:
+    uring_backend (const std::vector<native_string>& names, unsigned concurrency);
+    ~uring_backend ();
+
+    bool next (item& result);
+
+    backend_type type () const { return uring; }
+
+private:
+    enum op_type { op_open, op_stat, op_read };
+
+    struct request
+    {
+	size_t		index;
+	int		fd;
+	int		pending;	// number of operations in flight
+	int		error;
+	size_t		done;
+	struct statx	stx;
+	std::unique_ptr<mapping::detail::buffer_impl>	buffer;
+    };
+
+    io_uring_sqe* get_sqe (unsigned slot, op_type op);
+    void submit_and_wait (unsigned wait_nr);
+    void reap ();
+    void start (unsigned slot, size_t index);
+    void complete (unsigned slot, op_type op, int res);
+    void submit_read (unsigned slot);
+    void finish (unsigned slot);
+    void map_rings (const io_uring_params& params);
+    void unmap_rings ();
+
+    const std::vector<native_string>&	m_names;
+    std::vector<request>		m_requests;
+    std::vector<unsigned>		m_free;
+    std::deque<item>			m_ready;
+    size_t				m_next;
+    unsigned				m_active;
+
+    sys::file_handle	m_ring;
+    void*		m_sq_ptr;
+    size_t		m_sq_size;
+    void*		m_cq_ptr;
+    size_t		m_cq_size;
+    io_uring_sqe*	m_sqes;
+    size_t		m_sqes_size;
+    unsigned*		m_sq_tail;
+    unsigned*		m_sq_mask;
+    unsigned*		m_sq_array;
+    unsigned*		m_cq_head;
+    unsigned*		m_cq_tail;
+    unsigned*		m_cq_mask;
+    io_uring_cqe*	m_cqes;
+    unsigned		m_sq_local_tail;
+    unsigned		m_to_submit;
+};
+
+batch_reader::uring_backend::
+uring_backend (const std::vector<native_string>& names, unsigned concurrency)
+    : m_names (names), m_requests (concurrency), m_next (0), m_active (0)
+    , m_sq_ptr (MAP_FAILED), m_cq_ptr (MAP_FAILED), m_sqes (static_cast<io_uring_sqe*> (MAP_FAILED))
+    , m_sq_local_tail (0), m_to_submit (0)
+{
+    // every file has at most two operations in flight
+    io_uring_params params;
+    std::memset (&params, 0, sizeof(params));
+    m_ring.reset (static_cast<int> (::syscall (__NR_io_uring_setup, 2 * concurrency, &params)));
+    if (!m_ring)
+	SYS_THROW_SYSTEM_ERROR();
+    // current file position for reads appeared along with OPENAT and STATX
+    if (!(params.features & IORING_FEAT_RW_CUR_POS))
+    {
+	errno = ENOSYS;
+	SYS_THROW_SYSTEM_ERROR();
+    }
+    try
+    {
+	map_rings (params);
+    }
+    catch (...)
+    {
+	unmap_rings();
+	throw;
+    }
+    m_sq_local_tail = *m_sq_tail;
+
+    m_free.reserve (concurrency);
+    for (unsigned i = concurrency; i-- > 0; )
+	m_free.push_back (i);
+}
+
+batch_reader::uring_backend::
+~uring_backend ()
+{
+    // kernel may still write into request buffers
+    try
+    {
+	while (m_active)
+	{
+	    submit_and_wait (1);
+	    reap();
+	}
+    }
+    catch (...) { }
+    unmap_rings();
+}
+
+void batch_reader::uring_backend::
+map_rings (const io_uring_params& params)
+{
+    m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+	m_sq_size = m_cq_size = std::max (m_sq_size, m_cq_size);
+    m_sq_ptr = ::mmap (0, m_sq_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+		       m_ring, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == m_sq_ptr)
+	SYS_THROW_SYSTEM_ERROR();
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+	m_cq_ptr = m_sq_ptr;
+    else
+    {
+	m_cq_ptr = ::mmap (0, m_cq_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+			   m_ring, IORING_OFF_CQ_RING);
+	if (MAP_FAILED == m_cq_ptr)
+	    SYS_THROW_SYSTEM_ERROR();
+    }
+    m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    m_sqes = static_cast<io_uring_sqe*> (::mmap (0, m_sqes_size, PROT_READ|PROT_WRITE,
+						  MAP_SHARED|MAP_POPULATE, m_ring, IORING_OFF_SQES));
+    if (MAP_FAILED == m_sqes)
+	SYS_THROW_SYSTEM_ERROR();
+
+    char* const sq = static_cast<char*> (m_sq_ptr);
+    m_sq_tail  = reinterpret_cast<unsigned*> (sq + params.sq_off.tail);
+    m_sq_mask  = reinterpret_cast<unsigned*> (sq + params.sq_off.ring_mask);
+    m_sq_array = reinterpret_cast<unsigned*> (sq + params.sq_off.array);
+    char* const cq = static_cast<char*> (m_cq_ptr);
+    m_cq_head  = reinterpret_cast<unsigned*> (cq + params.cq_off.head);
+    m_cq_tail  = reinterpret_cast<unsigned*> (cq + params.cq_off.tail);
+    m_cq_mask  = reinterpret_cast<unsigned*> (cq + params.cq_off.ring_mask);
+    m_cqes     = reinterpret_cast<io_uring_cqe*> (cq + params.cq_off.cqes);
+}
+
+void batch_reader::uring_backend::
+unmap_rings ()
+{
+    if (MAP_FAILED != static_cast<void*> (m_sqes))
+	::munmap (m_sqes, m_sqes_size);
+    if (MAP_FAILED != m_cq_ptr && m_cq_ptr != m_sq_ptr)
+	::munmap (m_cq_ptr, m_cq_size);
+    if (MAP_FAILED != m_sq_ptr)
+	::munmap (m_sq_ptr, m_sq_size);
+}
+
+bool batch_reader::uring_backend::
+next (item& result)
+{
+    while (m_ready.empty())
+    {
+	while (!m_free.empty() && m_next < m_names.size())
+	{
+	    unsigned slot = m_free.back();
+	    m_free.pop_back();
+	    start (slot, m_next++);
+	}
+	if (!m_active)
+	    return false;
+	submit_and_wait (1);
+	reap();
+    }
+    result = std::move (m_ready.front());
+    m_ready.pop_front();
+    return true;
+}
+
+io_uring_sqe* batch_reader::uring_backend::
+get_sqe (unsigned slot, op_type op)
+{
+    // ring is never overrun since number of operations in flight is limited
+    // by the number of request slots.
+    const unsigned index = m_sq_local_tail & *m_sq_mask;
+    io_uring_sqe* sqe = &m_sqes[index];
+    std::memset (sqe, 0, sizeof(*sqe));
+    sqe->user_data = (static_cast<__u64> (slot) << 2) | op;
+    m_sq_array[index] = index;
+    ++m_sq_local_tail;
+    ++m_to_submit;
+    return sqe;
+}
+
+void batch_reader::uring_backend::
+submit_and_wait (unsigned wait_nr)
+{
+    __atomic_store_n (m_sq_tail, m_sq_local_tail, __ATOMIC_RELEASE);
+    long rc = ::syscall (__NR_io_uring_enter, static_cast<int> (m_ring), m_to_submit,
+			 wait_nr, IORING_ENTER_GETEVENTS, NULL, 0);
+    if (rc < 0)
+    {
+	if (EINTR == errno || EAGAIN == errno || EBUSY == errno)
+	    return;
+	SYS_THROW_SYSTEM_ERROR();
+    }
+    m_to_submit -= static_cast<unsigned> (rc);
+}
+
+void batch_reader::uring_backend::
+reap ()
+{
+    unsigned head = *m_cq_head;
+    const unsigned tail = __atomic_load_n (m_cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail)
+    {
+	const io_uring_cqe& cqe = m_cqes[head & *m_cq_mask];
+	complete (static_cast<unsigned> (cqe.user_data >> 2),
+		  static_cast<op_type> (cqe.user_data & 3), cqe.res);
+	++head;
+    }
+    __atomic_store_n (m_cq_head, head, __ATOMIC_RELEASE);
+}
+
+void batch_reader::uring_backend::
+start (unsigned slot, size_t index)
+{
+    request& req = m_requests[slot];
+    req.index = index;
+    req.fd = -1;
+    req.pending = 2;
+    req.error = 0;
+    req.done = 0;
+    req.buffer.reset();
+    ++m_active;
+
+    const char* name = m_names[index].c_str();
+    io_uring_sqe* sqe = get_sqe (slot, op_open);
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = reinterpret_cast<__u64> (name);
+    sqe->open_flags = O_RDONLY|O_CLOEXEC;
+
+    sqe = get_sqe (slot, op_stat);
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = reinterpret_cast<__u64> (name);
+    sqe->len = STATX_SIZE;
+    sqe->off = reinterpret_cast<__u64> (&req.stx);
+}
+
+void batch_reader::uring_backend::
+complete (unsigned slot, op_type op, int res)
+{
+    request& req = m_requests[slot];
+    if (op_read == op)
+    {
+	if (res < 0)
+	{
+	    if (-EINTR == res || -EAGAIN == res)
+		submit_read (slot);
+	    else
+	    {
+		req.error = -res;
+		finish (slot);
+	    }
+	    return;
+	}
+	req.done += res;
+	if (res && req.done < req.stx.stx_size)
+	    submit_read (slot);
+	else
+	    finish (slot);	// short file is zero-filled
+	return;
+    }
+    if (res < 0)
+    {
+	if (!req.error)
+	    req.error = -res;
+    }
+    else if (op_open == op)
+	req.fd = res;
+    if (--req.pending)
+	return;
+
+    if (req.error)
+	finish (slot);
+    else if (req.stx.stx_size > default_max_read_size || !req.stx.stx_size)
+    {
+	// huge files are mapped, empty ones are delivered as empty buffers
+	item file;
+	file.index = req.index;
+	file.error = load (req.fd, req.stx.stx_size, file.data);
+	::close (req.fd);
+	m_ready.push_back (std::move (file));
+	m_free.push_back (slot);
+	--m_active;
+    }
+    else
+    {
+	try
+	{
+	    req.buffer.reset (new mapping::detail::buffer_impl (req.stx.stx_size, mapping::copy));
+	}
+	catch (std::bad_alloc&)
+	{
+	    req.error = ENOMEM;
+	    finish (slot);
+	    return;
+	}
+	submit_read (slot);
+    }
+}
+
+void batch_reader::uring_backend::
+submit_read (unsigned slot)
+{
+    request& req = m_requests[slot];
+    req.pending = 1;
+    io_uring_sqe* sqe = get_sqe (slot, op_read);
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = req.fd;
+    sqe->addr = reinterpret_cast<__u64> (req.buffer->data() + req.done);
+    sqe->len = static_cast<__u32> (req.stx.stx_size - req.done);
+    sqe->off = req.done;
+}
+
+void batch_reader::uring_backend::
+finish (unsigned slot)
+{
+    request& req = m_requests[slot];
+    if (-1 != req.fd)
+	::close (req.fd);
+    item file;
+    file.index = req.index;
+    file.error = req.error;
+    if (!req.error)
+	attach (file.data, req.buffer.release());
+    req.buffer.reset();
+    m_ready.push_back (std::move (file));
+    m_free.push_back (slot);
+    --m_active;
+}
+
+#else
+
+class batch_reader::uring_backend : public backend_impl
+{
+public:
+    uring_backend (const std::vector<native_string>&, unsigned)
+	{ throw std::runtime_error ("batch_reader: io_uring is not supported on this system"); }
+
+    bool next (item&) { return false; }
+
+    backend_type type () const { return uring; }
+};
+
+#endif /* __linux__ */
+
+// --- batch_reader ----------------------------------------------------------
+
+batch_reader::
+batch_reader (const std::vector<std::string>& filenames, backend_type backend, unsigned concurrency)
+{
+#ifdef _WIN32
+    m_names.resize (filenames.size());
+    for (size_t i = 0; i < filenames.size(); ++i)
+	sys::mbstowcs (filenames[i], m_names[i]);
+#else
+    m_names = filenames;
+#endif
+    init (backend, concurrency);
+}
+
+batch_reader::
+batch_reader (const std::vector<std::wstring>& filenames, backend_type backend, unsigned concurrency)
+{
+#ifdef _WIN32
+    m_names = filenames;
+#else
+    m_names.resize (filenames.size());
+    for (size_t i = 0; i < filenames.size(); ++i)
+	sys::wcstombs (filenames[i].c_str(), m_names[i]);
+#endif
+    init (backend, concurrency);
+}
+
+batch_reader::
+~batch_reader ()
+{
+}
+
+void batch_reader::
+init (backend_type backend, unsigned concurrency)
+{
+    if (!concurrency)
+    {
+	if (uring == backend || auto_select == backend)
+	    concurrency = 64;
+	else
+	    concurrency = std::max (2u, 2 * std::thread::hardware_concurrency());
+    }
+    if (concurrency > m_names.size())
+	concurrency = std::max<unsigned> (1, static_cast<unsigned> (m_names.size()));
+
+    if (threads != backend)
+    {
+	try
+	{
+	    m_impl.reset (new uring_backend (m_names, concurrency));
+	    return;
+	}
+	catch (std::exception&)
+	{
+	    if (uring == backend)
+		throw;
+	}
+	concurrency = std::min<unsigned> (concurrency, std::max (2u, 2 * std::thread::hardware_concurrency()));
+    }
+    m_impl.reset (new pool_backend (m_names, concurrency));
+}
+
+bool batch_reader::
+next (item& result)
+{
+    return m_impl->next (result);
+}
+
+batch_reader::backend_type batch_reader::
+backend () const
+{
+    return m_impl->type();
+}
+
+} // namespace sys
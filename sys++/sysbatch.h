@@ -0,0 +1,114 @@
+// -*- C++ -*-
+//! \file       sysbatch.h
+//! \date       2026 Oct 16
+//! \brief      read multiple files concurrently.
+//
+
+#ifndef SYSBATCH_H
+#define SYSBATCH_H
+
+#include "sysmemmap.h"
+#include <vector>
+#include <memory>
+
+namespace sys {
+
+/// \class sys::batch_reader
+///
+/// reads list of files concurrently and yields their contents in completion
+/// order.  on Linux open, statx and read requests for all files are submitted
+/// through io_uring, elsewhere (or when io_uring is not available) files are
+/// read by the pool of worker threads.  files larger than max_read_size are
+/// mapped instead of being read.
+///
+/// contents of each file is delivered as sys::mapping::readwrite object in
+/// copy-on-write mode, so it could be either viewed through const_view or
+/// decrypted in place through view, exactly like a file opened with
+/// sys::mapping::writecopy.
+///
+/// typical usage:
+///
+///     sys::batch_reader batch (filenames);
+///     sys::batch_reader::item file;
+///     while (batch.next (file))
+///     {
+///         if (file.error) ...
+///         sys::mapping::const_view<uint8_t> view (file.data);
+///         process (filenames[file.index], view);
+///     }
+
+class SYSPP_DLLIMPORT batch_reader
+{
+public:
+    enum backend_type
+    {
+        auto_select,	// io_uring where available, worker threads otherwise
+        uring,		// io_uring only, fails if not available
+        threads,	// worker threads
+    };
+
+    struct item
+    {
+        size_t                      index;  // position in the list of filenames
+        sys::mapping::readwrite     data;   // file contents
+        int                         error;  // system error code, zero on success
+    };
+
+    static const size_t default_max_read_size = 64 << 20;
+
+    /// batch_reader (FILENAMES, BACKEND, CONCURRENCY)
+    ///
+    /// Effects: starts reading files listed in FILENAMES.  CONCURRENCY limits
+    /// number of files read simultaneously, zero selects reasonable default.
+    /// Throws: sys::generic_error if uring backend was requested but it is not
+    ///         available.
+
+    explicit batch_reader (const std::vector<std::string>& filenames,
+                           backend_type backend = auto_select, unsigned concurrency = 0);
+    explicit batch_reader (const std::vector<std::wstring>& filenames,
+                           backend_type backend = auto_select, unsigned concurrency = 0);
+    ~batch_reader ();
+
+    /// next (ITEM)
+    ///
+    /// Effects: waits until some file is read and stores it into ITEM.  if file
+    /// could not be read, ITEM.error is set to system error code and ITEM.data
+    /// is closed.
+    /// Returns: false if all files were already delivered.
+
+    bool next (item& result);
+
+    size_t size () const { return m_names.size(); }
+
+    /// backend()
+    ///
+    /// Returns: backend actually used for reading.
+
+    backend_type backend () const;
+
+private:
+#ifdef _WIN32
+    typedef std::wstring	native_string;
+#else
+    typedef std::string		native_string;
+#endif
+    class backend_impl;
+    class pool_backend;
+    class uring_backend;
+
+    void init (backend_type backend, unsigned concurrency);
+
+    static int read_file (const native_string& filename, mapping::readwrite& data);
+    static int load (sys::raw_handle file, mapping::off_type size, mapping::readwrite& data);
+    static void attach (mapping::map_base& map, mapping::detail::map_impl* impl);
+
+    std::vector<native_string>		m_names;
+    std::unique_ptr<backend_impl>	m_impl;
+
+    batch_reader (const batch_reader&);			// not defined
+    batch_reader& operator= (const batch_reader&);	//
+};
+
+} // namespace sys
+
+#endif /* SYSBATCH_H */
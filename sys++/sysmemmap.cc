@@ -26,6 +26,14 @@
 
 #include "sysmemmap.h"
 #include "sysfs.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <cstring>
 
 namespace sys { namespace mapping {
 
@@ -42,10 +50,27 @@ detail::info::info ()
 #endif
 }
 
+namespace {
+    // threshold may be changed while other threads open files
+    std::atomic<map_common::size_type> s_read_threshold (0x8000);
+}
+
+map_common::size_type map_common::
+read_threshold ()
+{
+    return s_read_threshold.load (std::memory_order_relaxed);
+}
+
+map_common::size_type map_common::
+set_read_threshold (size_type size)
+{
+    return s_read_threshold.exchange (size, std::memory_order_relaxed);
+}
+
 #ifdef _WIN32
 
-void map_base::
-open (sys::raw_handle file, mode_t mode, off_type file_size)
+detail::map_impl* map_common::
+create (sys::raw_handle file, mode_t mode, off_type file_size)
 {
     if (!file_size)
     {
@@ -53,6 +78,10 @@ open (sys::raw_handle file, mode_t mode, off_type file_size)
 	if (file_size == static_cast<off_type> (file::invalid_size))
             SYS_THROW_SYSTEM_ERROR();
     }
+    if (write != mode && file_size <= read_threshold())
+    {
+	return read_file (file, mode, static_cast<size_type> (file_size));
+    }
     DWORD protect, map_access;
     switch (mode)
     {
@@ -67,13 +96,34 @@ open (sys::raw_handle file, mode_t mode, off_type file_size)
     if (!backend)
         SYS_THROW_SYSTEM_ERROR();
 
-    impl.reset (new detail::map_impl (backend, file_size, map_access));
+    return new detail::map_impl (backend, file_size, map_access);
+}
+
+detail::map_impl* map_common::
+read_file (sys::raw_handle file, mode_t mode, size_type size)
+{
+    std::unique_ptr<detail::buffer_impl> buffer (
+	new detail::buffer_impl (size, read == mode? FILE_MAP_READ: FILE_MAP_COPY));
+    char* const data = buffer->data();
+    size_type pos = 0;
+    while (pos < size)
+    {
+	OVERLAPPED ov = {};
+	ov.Offset = static_cast<DWORD> (pos);
+	DWORD chunk = static_cast<DWORD> (size - pos), got;
+	if (!::ReadFile (file, data + pos, chunk, &got, &ov))
+	    SYS_THROW_SYSTEM_ERROR();
+	if (!got)
+	    break;	// file is shorter than requested, the rest is zero-filled
+	pos += got;
+    }
+    return buffer.release();
 }
 
 #else
 
-void map_base::
-open (sys::raw_handle file, mode_t mode, off_type file_size)
+detail::map_impl* map_common::
+create (sys::raw_handle file, mode_t mode, off_type file_size)
 {
     if (!file_size)
     {
@@ -81,13 +131,371 @@ open (sys::raw_handle file, mode_t mode, off_type file_size)
 	if (file::invalid_size == file_size)
 	    SYS_THROW_SYSTEM_ERROR();
     }
+    if (write != mode && file_size <= off_type (read_threshold()))
+    {
+	return read_file (file, mode, file_size);
+    }
     sys::handle backend (::dup (file));
     if (!backend)
         SYS_THROW_SYSTEM_ERROR();
 
-    impl.reset (new detail::map_impl (backend, file_size, mode));
+    return new detail::map_impl (backend, file_size, mode);
+}
+
+detail::map_impl* map_common::
+read_file (sys::raw_handle file, mode_t mode, size_type size)
+{
+    std::unique_ptr<detail::buffer_impl> buffer (new detail::buffer_impl (size, mode));
+    char* const data = buffer->data();
+    size_type pos = 0;
+    while (pos < size)
+    {
+	ssize_t got = ::pread (file, data + pos, size - pos, pos);
+	if (got < 0)
+	{
+	    if (EINTR == errno)
+		continue;
+	    SYS_THROW_SYSTEM_ERROR();
+	}
+	if (!got)
+	    break;	// file is shorter than requested, the rest is zero-filled
+	pos += got;
+    }
+    return buffer.release();
+}
+
+#endif /* _WIN32 */
+
+// --- anonymous -------------------------------------------------------------
+
+namespace {
+
+// anonymous_pool
+// process-wide cache of anonymous memory areas.  areas are rounded up to the
+// power of two and kept in per-size lists, areas larger than max_class bytes
+// are not cached.
+
+class anonymous_pool
+{
+public:
+    typedef detail::anonymous_pool_stats stats_type;
+
+    static anonymous_pool& instance ()
+	{
+	    // pool is never destroyed, so that anonymous objects with static
+	    // storage duration could safely release their memory.
+	    static anonymous_pool* pool = new anonymous_pool;
+	    return *pool;
+	}
+
+    void* allocate (size_t& size, bool huge_pages, bool& recycled);
+    void release (void* area, size_t size);
+
+    stats_type get_stats ()
+	{
+	    std::lock_guard<std::mutex> lock (m_mutex);
+	    return m_stats;
+	}
+
+    size_t set_limit (size_t limit);
+
+    void trim () { set_limit (set_limit (0)); }
+
+private:
+    static const int	min_class = 12;	// 4KB
+    static const int	max_class = 26;	// 64MB
+    static const size_t	default_limit = 128 << 20;
+
+    anonymous_pool ()
+	{
+	    std::memset (&m_stats, 0, sizeof(m_stats));
+	    m_stats.limit = default_limit;
+	}
+
+    static int size_class (size_t size)
+	{
+	    int cls = min_class;
+	    while (cls <= max_class && (size_t (1) << cls) < size)
+		++cls;
+	    return cls <= max_class ? cls : -1;
+	}
+
+    static void* system_allocate (size_t size, bool huge_pages);
+    static void system_free (void* area, size_t size);
+
+    std::mutex		m_mutex;
+    std::vector<void*>	m_free[max_class - min_class + 1];
+    stats_type		m_stats;
+};
+
+#ifdef _WIN32
+
+void* anonymous_pool::
+system_allocate (size_t size, bool)
+{
+    // large pages require SeLockMemoryPrivilege, don't bother
+    return ::VirtualAlloc (NULL, size, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+}
+
+void anonymous_pool::
+system_free (void* area, size_t)
+{
+    ::VirtualFree (area, 0, MEM_RELEASE);
+}
+
+#else
+
+void* anonymous_pool::
+system_allocate (size_t size, bool huge_pages)
+{
+    void* area = ::mmap (NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == area)
+	return 0;
+#ifdef MADV_HUGEPAGE
+    if (huge_pages)
+	::madvise (area, size, MADV_HUGEPAGE);
+#else
+    (void)huge_pages;
+#endif
+    return area;
+}
+
+void anonymous_pool::
+system_free (void* area, size_t size)
+{
+    ::munmap (area, size);
 }
 
 #endif /* _WIN32 */
 
+void* anonymous_pool::
+allocate (size_t& size, bool huge_pages, bool& recycled)
+{
+    recycled = false;
+    size = (size + detail::map_impl::page_mask()) & ~detail::map_impl::page_mask();
+    int cls = size_class (size);
+    if (cls >= 0)
+	size = size_t (1) << cls;
+    {
+	std::lock_guard<std::mutex> lock (m_mutex);
+	if (cls >= 0 && !m_free[cls - min_class].empty())
+	{
+	    auto& free_list = m_free[cls - min_class];
+	    void* area = free_list.back();
+	    free_list.pop_back();
+	    m_stats.cached_bytes -= size;
+	    ++m_stats.hits;
+	    recycled = true;
+#if !defined(_WIN32) && defined(MADV_HUGEPAGE)
+	    if (huge_pages)
+		::madvise (area, size, MADV_HUGEPAGE);
+#endif
+	    return area;
+	}
+	++m_stats.misses;
+    }
+    return system_allocate (size, huge_pages);
+}
+
+void anonymous_pool::
+release (void* area, size_t size)
+{
+    int cls = size_class (size);
+    if (cls >= 0)
+    {
+	std::lock_guard<std::mutex> lock (m_mutex);
+	if (m_stats.cached_bytes + size <= m_stats.limit)
+	{
+	    m_free[cls - min_class].push_back (area);
+	    m_stats.cached_bytes += size;
+	    return;
+	}
+	++m_stats.evictions;
+    }
+    system_free (area, size);
+}
+
+size_t anonymous_pool::
+set_limit (size_t limit)
+{
+    std::vector<std::pair<void*, size_t>> released;
+    size_t prev_limit;
+    {
+	std::lock_guard<std::mutex> lock (m_mutex);
+	prev_limit = m_stats.limit;
+	m_stats.limit = limit;
+	// drop largest areas first
+	for (int cls = max_class; cls >= min_class && m_stats.cached_bytes > limit; --cls)
+	{
+	    auto& free_list = m_free[cls - min_class];
+	    const size_t size = size_t (1) << cls;
+	    while (!free_list.empty() && m_stats.cached_bytes > limit)
+	    {
+		released.push_back (std::make_pair (free_list.back(), size));
+		free_list.pop_back();
+		m_stats.cached_bytes -= size;
+	    }
+	}
+    }
+    for (auto& area : released)
+	system_free (area.first, area.second);
+    return prev_limit;
+}
+
+} // anonymous namespace
+
+detail::anonymous_impl::
+anonymous_impl (size_type size, bool huge_pages)
+#ifdef _WIN32
+    : map_impl (size, FILE_MAP_WRITE)
+#else
+    : map_impl (size, write)
+#endif
+    , area (0), capacity (size)
+{
+    bool recycled;
+    area = anonymous_pool::instance().allocate (capacity, huge_pages, recycled);
+    if (!area)
+	SYS_THROW_SYSTEM_ERROR();
+    // recycled area has to look like the fresh one
+    if (recycled)
+	std::memset (area, 0, size);
+}
+
+detail::anonymous_impl::
+~anonymous_impl ()
+{
+    anonymous_pool::instance().release (area, capacity);
+}
+
+detail::map_impl* map_common::
+create_anonymous (size_type size, bool huge_pages)
+{
+    if (!size)
+	throw std::invalid_argument ("anonymous: zero-sized mapping requested");
+    return new detail::anonymous_impl (size, huge_pages);
+}
+
+detail::anonymous_pool_stats map_common::
+get_anonymous_pool_stats ()
+{
+    return anonymous_pool::instance().get_stats();
+}
+
+map_common::size_type map_common::
+set_anonymous_pool_limit (size_type bytes)
+{
+    return anonymous_pool::instance().set_limit (bytes);
+}
+
+void map_common::
+trim_anonymous_pool ()
+{
+    anonymous_pool::instance().trim();
+}
+
+// --- output_file -----------------------------------------------------------
+
+const output_file::size_type output_file::default_capacity;
+
+#ifdef _WIN32
+
+sys::raw_handle output_file::
+create (const char* filename)
+{
+    return ::CreateFileA (filename, GENERIC_READ|GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                          FILE_ATTRIBUTE_NORMAL, NULL);
+}
+
+sys::raw_handle output_file::
+create (const wchar_t* filename)
+{
+    return ::CreateFileW (filename, GENERIC_READ|GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                          FILE_ATTRIBUTE_NORMAL, NULL);
+}
+
+bool output_file::
+set_size (off_type size)
+{
+    LARGE_INTEGER pos;
+    pos.QuadPart = size;
+    return ::SetFilePointerEx (m_file, pos, NULL, FILE_BEGIN) && ::SetEndOfFile (m_file);
+}
+
+#else
+
+sys::raw_handle output_file::
+create (const char* filename)
+{
+    return ::open (filename, O_RDWR|O_CREAT|O_TRUNC, 0666);
+}
+
+sys::raw_handle output_file::
+create (const wchar_t* filename)
+{
+    string cname;
+    if (!wcstombs (wstring (filename), cname))
+        return sys::file_handle::invalid_handle();
+    return create (cname.c_str());
+}
+
+bool output_file::
+set_size (off_type size)
+{
+    // posix_fallocate never shrinks the file, truncation goes through ftruncate
+    if (size > static_cast<off_type> (file::get_size (m_file))
+        && 0 == ::posix_fallocate (m_file, 0, size))
+        return true;
+    // filesystem might not support preallocation
+    return ::ftruncate (m_file, size) != -1;
+}
+
+#endif /* _WIN32 */
+
+void output_file::
+init (size_type size)
+{
+    resize (size? size: default_capacity);
+}
+
+void output_file::
+resize (size_type size)
+{
+    release();
+    if (!set_size (size))
+        SYS_THROW_SYSTEM_ERROR();
+    m_map.open (m_file.get(), writeshare, size);
+    m_view.remap (m_map);
+}
+
+void output_file::
+release ()
+{
+    // view holds a reference to the map, both have to be released before the
+    // file could be resized.
+    m_view = view<uint8_t>();
+    m_map.close();
+}
+
+void output_file::
+commit (size_type length)
+{
+    if (length > capacity())
+        throw std::range_error ("output_file: length exceedes allocated size");
+    release();
+    if (!set_size (length))
+        SYS_THROW_SYSTEM_ERROR();
+    m_file.close();
+}
+
+output_file::
+~output_file ()
+{
+    if (is_open())
+    {
+        release();
+        set_size (0);
+    }
+}
+
 } } // namespace sys::mapping
@@ -31,29 +31,123 @@
 #include "sysio.h"
 #include "syserror.h"
 #include <stdexcept>
+#include <algorithm>
 #include <cassert>
+#include <type_traits>
 
-namespace sys { namespace mapping {
+namespace sys {
+
+class batch_reader;
+
+namespace mapping {
 
 typedef detail::map_impl::off_type	off_type;
 typedef detail::map_impl::size_type	size_type;
 
 inline size_type page_size () { return detail::map_impl::page_size(); }
 
-/// \class sys::mapping::map_base
+/// \class sys::mapping::map_common
 ///
-/// base class for memory mapped object.
-/// map_base maintains reference counted implementation of mapped object.
-/// mapped object is destroyed when there's no views on top of it.
+/// part of memory mapped object interface that doesn't depend on reference
+/// counting policy.  creates implementation objects that basic_map_base
+/// references.
 
-class SYSPP_DLLIMPORT map_base
+class SYSPP_DLLIMPORT map_common
 {
-    refcount_ptr<detail::map_impl>	impl;
-
 public:
     typedef detail::map_impl::off_type	off_type;
     typedef detail::map_impl::size_type	size_type;
 
+    /// page_size() and page_mask()
+    ///
+    /// Return system-dependent virtual page size and corresponding bitwise mask.
+
+    static size_type page_size () { return detail::map_impl::page_size(); }
+    static size_type page_mask () { return detail::map_impl::page_mask(); }
+
+    /// read_threshold() and set_read_threshold (SIZE)
+    ///
+    /// files opened in read or copy-on-write mode that are not larger than read
+    /// threshold are read into memory instead of being mapped, since for small
+    /// files setting up the mapping costs more than reading them.  views of such
+    /// objects behave exactly like mapped ones.  zero threshold disables reading.
+    /// set_read_threshold returns previous threshold value.
+
+    static size_type read_threshold ();
+    static size_type set_read_threshold (size_type size);
+
+protected:
+    /// create (FILENAME, MODE, SIZE)
+    /// create (HANDLE, MODE, SIZE)
+    ///
+    /// Effects: create memory mapped object with access mode MODE on top of the
+    /// file FILENAME or file referenced by system handle HANDLE.  HANDLE could be
+    /// safely used for any i/o operations (read, write, close etc) afterwards.
+    /// Returns: new object that is not referenced by anyone.
+    /// Throws: sys::generic_error if map cannot be created,
+    ///         std::bad_alloc if memory allocation for map failed.
+
+    template <typename CharT>
+    static detail::map_impl* create (const CharT* filename, mode_t mode, off_type size);
+    static detail::map_impl* create (sys::raw_handle handle, mode_t mode, off_type size);
+
+    /// create_anonymous (SIZE, HUGE_PAGES)
+    ///
+    /// Returns: new zero-filled object of SIZE bytes that is not backed by file.
+    /// Throws: std::invalid_argument if SIZE is zero,
+    ///         sys::generic_error if memory cannot be allocated.
+
+    static detail::map_impl* create_anonymous (size_type size, bool huge_pages);
+
+    // pool of anonymous memory, see basic_anonymous
+
+    static detail::anonymous_pool_stats get_anonymous_pool_stats ();
+    static size_type set_anonymous_pool_limit (size_type bytes);
+    static void trim_anonymous_pool ();
+
+private:
+    static detail::map_impl* read_file (sys::raw_handle handle, mode_t mode, size_type size);
+
+    /// open_mode (MODE)
+    ///
+    /// Returns: system-dependent file open mode corresponding to specified map access
+    /// mode.
+
+    static io::sys_mode open_mode (mode_t mode)
+	{
+#ifdef _WIN32
+	    return io::sys_mode (write == mode? io::read_write: io::generic_read,
+				 io::open_existing);
+#else
+	    return io::sys_mode (mode == read? O_RDONLY: O_RDWR);
+#endif
+	}
+};
+
+/// \class sys::mapping::basic_map_base
+///
+/// base class for memory mapped object.
+/// basic_map_base maintains reference counted implementation of mapped object.
+/// mapped object is destroyed when there's no views on top of it.
+///
+/// CountPolicy selects how references are counted, see sys::refcount_ptr.
+/// atomic_count is the default; tools that never share mapped objects and
+/// views between threads could use plain_count instantiations, so that copying
+/// views doesn't involve locked instructions.  objects and views with
+/// different policies are distinct types and could not be mixed.
+
+template <class CountPolicy = atomic_count>
+class basic_map_base : public map_common
+{
+    refcount_ptr<detail::map_impl, CountPolicy>	impl;
+
+    friend class sys::batch_reader;
+
+public:
+    typedef CountPolicy			count_policy;
+    typedef map_common::off_type	off_type;
+    typedef map_common::size_type	size_type;
+
     template <class T> class view;
 
     /// is_open()
@@ -80,181 +174,222 @@ public:
     /// otherwise.
     bool writeable () const { return impl? impl->writeable(): false; }
 
-    /// page_size() and page_mask()
-    ///
-    /// Return system-dependent virtual page size and corresponding bitwise mask.
-
-    static size_type page_size () { return detail::map_impl::page_size(); }
-    static size_type page_mask () { return detail::map_impl::page_mask(); }
-
 protected:
-    /// map_base is a base class for memory mapped objects and can be constructed by
-    /// ancestors only.
+    /// basic_map_base is a base class for memory mapped objects and can be
+    /// constructed by ancestors only.
 
-    map_base () : impl() { }
+    basic_map_base () : impl() { }
 
-    /// map_base (FILENAME, MODE, SIZE)
+    /// basic_map_base (FILENAME, MODE, SIZE)
+    /// basic_map_base (HANDLE, MODE, SIZE)
     ///
-    /// Effects: create memory mapped object on top of the file FILENAME with access
-    /// mode MODE.
-    /// Throws: sys::generic_error if map cannot be created,
-    ///         std::bad_alloc if memory allocation for map failed.
+    /// Effects: create memory mapped object, see map_common::create.
 
     template <typename CharT>
-    map_base (const CharT* filename, mode_t mode, off_type size = 0) : impl()
-	{ open (filename, mode, size); }
-
-    /// map_base (HANDLE, MODE, SIZE)
-    ///
-    /// Effects: create memory mapped object with access mode MODE on top of file
-    /// referenced by system handle HANDLE.  HANDLE could be safely used for any i/o
-    /// operations (read, write, close etc) after map_base object is created.
-    /// Throws: sys::generic_error if map cannot be created,
-    ///         std::bad_alloc if memory allocation for map failed.
+    basic_map_base (const CharT* filename, mode_t mode, off_type size = 0)
+	: impl (create (filename, mode, size))
+	{ }
 
-    map_base (sys::raw_handle handle, mode_t mode, off_type size = 0) : impl()
-	{ open (handle, mode, size); }
+    basic_map_base (sys::raw_handle handle, mode_t mode, off_type size = 0)
+	: impl (create (handle, mode, size))
+	{ }
 
-    map_base (const map_base& other) : impl (other.impl)
+    basic_map_base (const basic_map_base& other) : impl (other.impl)
         { }
 
-    ~map_base () { }
+    ~basic_map_base () { }
 
-    map_base& operator= (const map_base& other)
+    basic_map_base& operator= (const basic_map_base& other)
         {
             impl = other.impl;
             return *this;
         }
 
     template <typename CharT>
-    void open (const CharT* filename, mode_t mode, off_type size = 0);
-    void open (sys::raw_handle handle, mode_t mode, off_type size = 0);
-
-private:
-    /// open_mode (MODE)
-    ///
-    /// Returns: system-dependent file open mode corresponding to specified map access
-    /// mode.
-
-    static io::sys_mode open_mode (mode_t mode)
-	{
-#ifdef _WIN32
-	    return io::sys_mode (write == mode? io::read_write: io::generic_read,
-				 io::open_existing);
-#else
-	    return io::sys_mode (mode == read? O_RDONLY: O_RDWR);
-#endif
-	}
+    void open (const CharT* filename, mode_t mode, off_type size = 0)
+	{ impl.reset (create (filename, mode, size)); }
+    void open (sys::raw_handle handle, mode_t mode, off_type size = 0)
+	{ impl.reset (create (handle, mode, size)); }
+    void open_anonymous (size_type size, bool huge_pages)
+	{ impl.reset (create_anonymous (size, huge_pages)); }
 };
 
+typedef basic_map_base<> map_base;
+
 enum write_mode_t {
     writeshare	= write,	// normal read-write mode
     writecopy	= copy,		// copy-on-write mode
 };
 
-/// \class sys::mapping::readonly
+/// \class sys::mapping::basic_readonly
 ///
 /// class referring to readonly memory mapped object.
 
-class readonly : public map_base
+template <class CountPolicy = atomic_count>
+class basic_readonly : public basic_map_base<CountPolicy>
 {
+    typedef basic_map_base<CountPolicy> base_type;
+
 public:
-    readonly () { }
+    basic_readonly () { }
     template <typename CharT>
-    explicit readonly (const CharT* filename, off_type size = 0)
-       	: map_base (filename, read, size) { }
+    explicit basic_readonly (const CharT* filename, off_type size = 0)
+       	: base_type (filename, read, size) { }
     template <typename Ch, typename Tr, typename Al>
-    explicit readonly (const basic_string<Ch,Tr,Al>& filename, off_type size = 0)
-	: map_base (filename.c_str(), read, size) { }
-    explicit readonly (sys::raw_handle handle, off_type size = 0)
-       	: map_base (handle, read, size) { }
+    explicit basic_readonly (const basic_string<Ch,Tr,Al>& filename, off_type size = 0)
+	: base_type (filename.c_str(), read, size) { }
+    explicit basic_readonly (sys::raw_handle handle, off_type size = 0)
+       	: base_type (handle, read, size) { }
 
     template <typename CharT>
     void open (const CharT* filename, off_type size = 0)
-       	{ map_base::open (filename, read, size); }
+       	{ base_type::open (filename, read, size); }
 
     template <typename Ch, typename Tr, typename Al>
     void open (const basic_string<Ch,Tr,Al>& filename, off_type size = 0)
-	{ map_base::open (filename.c_str(), read, size); }
+	{ base_type::open (filename.c_str(), read, size); }
 
     void open (sys::raw_handle handle, off_type size = 0)
-       	{ map_base::open (handle, read, size); }
+       	{ base_type::open (handle, read, size); }
 };
 
-/// \class sys::mapping::readwrite
+typedef basic_readonly<> readonly;
+
+/// \class sys::mapping::basic_readwrite
 ///
 /// class referring to read-write memory mapped object.
 
-class readwrite : public map_base
+template <class CountPolicy = atomic_count>
+class basic_readwrite : public basic_map_base<CountPolicy>
 {
+    typedef basic_map_base<CountPolicy> base_type;
+
 public:
-    readwrite () { }
+    basic_readwrite () { }
 
     template <typename CharT>
-    explicit readwrite (const CharT* filename, write_mode_t mode = writeshare,
-			off_type size = 0)
-       	: map_base (filename, mode == writeshare? write: copy, size) { }
+    explicit basic_readwrite (const CharT* filename, write_mode_t mode = writeshare,
+			      off_type size = 0)
+       	: base_type (filename, mode == writeshare? write: copy, size) { }
 
     template <typename Ch, typename Tr, typename Al>
-    explicit readwrite (const basic_string<Ch,Tr,Al>& filename, write_mode_t mode = writeshare,
-		       	off_type size = 0)
-       	: map_base (filename.c_str(), mode == writeshare? write: copy, size) { }
+    explicit basic_readwrite (const basic_string<Ch,Tr,Al>& filename, write_mode_t mode = writeshare,
+			      off_type size = 0)
+       	: base_type (filename.c_str(), mode == writeshare? write: copy, size) { }
 
-    explicit readwrite (sys::raw_handle handle, write_mode_t mode = writeshare,
-			off_type size = 0)
-       	: map_base (handle, mode == writeshare? write: copy, size) { }
+    explicit basic_readwrite (sys::raw_handle handle, write_mode_t mode = writeshare,
+			      off_type size = 0)
+       	: base_type (handle, mode == writeshare? write: copy, size) { }
 
     template <typename CharT>
     void open (const CharT* filename, write_mode_t mode = writeshare, off_type size = 0)
-       	{ map_base::open (filename, mode == writeshare? write: copy, size); }
+       	{ base_type::open (filename, mode == writeshare? write: copy, size); }
 
     template <typename Ch, typename Tr, typename Al>
     void open (const basic_string<Ch,Tr,Al>& filename, write_mode_t mode = writeshare,
 	       off_type size = 0)
-	{ map_base::open (filename.c_str(), mode == writeshare? write: copy, size); }
+	{ base_type::open (filename.c_str(), mode == writeshare? write: copy, size); }
 
     void open (sys::raw_handle handle, write_mode_t mode = writeshare, off_type size = 0)
-       	{ map_base::open (handle, mode == writeshare? write: copy, size); }
+       	{ base_type::open (handle, mode == writeshare? write: copy, size); }
 };
 
-/// \class sys::mapping::map_base::view
+typedef basic_readwrite<> readwrite;
+
+/// \class sys::mapping::basic_anonymous
+///
+/// class referring to read-write memory mapped object that is not backed by any
+/// file, intended for scratch buffers.  memory is recycled through process-wide
+/// pool keyed by size class, so that repeated allocations of similar size don't
+/// result in system calls and page faults.  newly opened object is always
+/// zero-filled.
+
+template <class CountPolicy = atomic_count>
+class basic_anonymous : public basic_map_base<CountPolicy>
+{
+public:
+    typedef detail::anonymous_pool_stats pool_stats;
+
+    basic_anonymous () { }
+
+    /// basic_anonymous (SIZE, HUGE_PAGES)
+    ///
+    /// Effects: allocates SIZE bytes of anonymous memory, if HUGE_PAGES is true,
+    /// requests transparent huge pages backing for the area.
+    /// Throws: std::invalid_argument if SIZE is zero,
+    ///         sys::generic_error if memory cannot be allocated.
+
+    explicit basic_anonymous (size_type size, bool huge_pages = false)
+        { open (size, huge_pages); }
+
+    void open (size_type size, bool huge_pages = false)
+        { this->open_anonymous (size, huge_pages); }
+
+    /// get_pool_stats()
+    ///
+    /// Returns: usage statistics of the memory pool.
+
+    static pool_stats get_pool_stats ()
+	{ return map_common::get_anonymous_pool_stats(); }
+
+    /// set_pool_limit (BYTES)
+    ///
+    /// Effects: limits size of memory held by the pool, zero disables pooling.
+    /// Returns: previous limit.
+
+    static size_type set_pool_limit (size_type bytes)
+	{ return map_common::set_anonymous_pool_limit (bytes); }
+
+    /// trim_pool()
+    ///
+    /// Effects: returns all memory held by the pool to the system.
+
+    static void trim_pool ()
+	{ map_common::trim_anonymous_pool(); }
+};
+
+typedef basic_anonymous<> anonymous;
+
+/// \class sys::mapping::basic_map_base::view
 ///
 /// base class that maps views of memory mapped object into the address space of the
 /// calling process.
 
-template<class T>
-class SYSPP_DLLIMPORT map_base::view
+template <class CountPolicy>
+template <class T>
+class SYSPP_DLLIMPORT basic_map_base<CountPolicy>::view
 {
 public:
-    typedef map_base::off_type	off_type;
-    typedef map_base::size_type	size_type;
-    typedef T                   value_type;
+    typedef map_common::off_type	off_type;
+    typedef map_common::size_type	size_type;
+    typedef T				value_type;
 
 protected:
-    /// view (MAP, OFFSET, N)
+    /// view (MAP, OFFSET, N, HINT)
     ///
     /// Effects: creates a view of memory mapped object MAP, starting at offset
     /// OFFSET, containing N objects of type T.  if N is zero, tries to map all
-    /// available area.
+    /// available area.  HINT describes expected access pattern, see advise().
     /// Throws: std::invalid_argument if MAP does not refer to initialized memory
     ///                               mapped object.
     ///         std::range_error if OFFSET is greater than size of MAP.
     ///         sys::generic_error if some system errors occurs.
 
-    explicit view (map_base& mf, off_type offset = 0, size_type n = 0)
+    explicit view (basic_map_base& mf, off_type offset = 0, size_type n = 0,
+                   advice_t hint = normal)
 	: map (mf.impl), area (0)
-	{ do_remap (offset, n); }
+	{ do_remap (offset, n, hint); }
 
     view (view&& other)
         : map (other.map), area (other.area), msize (other.msize)
         { other.area = 0; }
 
     template <typename U>
-    view (const view<U>& other, off_type offset, size_type n)
+    view (const view<U>& other, off_type offset, size_type n, advice_t hint = normal)
         : map (other.map), area (0)
-        { do_remap (offset, n); }
+        { do_remap (offset, n, hint); }
 
-    view () : map (0), area (0) { }
+    view () : map (0), area (0), msize (0) { }
 
     ~view () { if (area) map->unmap ((void*)area, msize*sizeof(T)); }
 
@@ -286,7 +421,19 @@ public:
 
     bool sync () { return area? map->sync (area, msize*sizeof(T)): false; }
 
-    void bind (const map_base& mf)
+    /// advise (HINT)
+    ///
+    /// Effects: informs the system about expected access pattern of the view.
+    /// sequential and random adjust read-ahead, willneed and populate start
+    /// reading pages in advance, hugepage requests transparent huge pages
+    /// backing.  note that dontneed discards modifications made to a writecopy
+    /// view.
+    /// Returns: false if the hint is not supported or the view is not mapped.
+
+    bool advise (advice_t hint)
+        { return area? map->advise ((void*)area, msize*sizeof(T), hint): false; }
+
+    void bind (const basic_map_base& mf)
         {
             unmap();
             map = mf.impl;
@@ -297,15 +444,16 @@ public:
             unmap();
             map = other.map;
         }
-    void remap (const map_base& mf, off_type offset = 0, size_type n = 0)
+    void remap (const basic_map_base& mf, off_type offset = 0, size_type n = 0,
+                advice_t hint = normal)
 	{
             bind (mf);
-	    do_remap (offset, n);
+	    do_remap (offset, n, hint);
 	}
-    void remap (off_type offset, size_type n)
+    void remap (off_type offset, size_type n, advice_t hint = normal)
         {
             unmap();
-            do_remap (offset, n);
+            do_remap (offset, n, hint);
         }
     void unmap ()
 	{
@@ -319,9 +467,9 @@ public:
     off_type max_offset () const { return map->get_size(); }
 
 private:
-    void do_remap (off_type offset, size_type n);
+    void do_remap (off_type offset, size_type n, advice_t hint);
 
-    refcount_ptr<detail::map_impl>	map;
+    refcount_ptr<detail::map_impl, CountPolicy>	map;
     T*		area;	// pointer to the beginning of view address space
     size_type	msize;	// size of view in terms of T objects
 
@@ -329,55 +477,204 @@ private:
     view& operator= (const view&);	//
 };
 
-template <class T>
-class SYSPP_DLLIMPORT view : public map_base::view<T>
+/// \class sys::mapping::view
+///
+/// writable view of read-write or anonymous memory mapped object.
+
+template <class T, class CountPolicy = atomic_count>
+class SYSPP_DLLIMPORT view : public basic_map_base<CountPolicy>::template view<T>
 {
+    typedef typename basic_map_base<CountPolicy>::template view<T> base_type;
+
 public:
-    typedef map_base::off_type	off_type;
-    typedef map_base::size_type	size_type;
+    typedef map_common::off_type	off_type;
+    typedef map_common::size_type	size_type;
 
-    view () : map_base::view<T>() { }
-    explicit view (readwrite& rwm, off_type offset = 0, size_type n = 0)
-	: map_base::view<T> (rwm, offset, n)
+    view () : base_type() { }
+    explicit view (basic_readwrite<CountPolicy>& rwm, off_type offset = 0, size_type n = 0,
+                   advice_t hint = normal)
+	: base_type (rwm, offset, n, hint)
+	{ }
+    explicit view (basic_anonymous<CountPolicy>& mem, off_type offset = 0, size_type n = 0,
+                   advice_t hint = normal)
+	: base_type (mem, offset, n, hint)
 	{ }
-    view (view&& other) : map_base::view<T> (std::move (other)) { }
+    view (view&& other) : base_type (std::move (other)) { }
 
     template <typename U>
-    view (const view<U>& other, off_type offset, size_type n)
-        : map_base::view<T> (other, offset, n)
+    view (const view<U, CountPolicy>& other, off_type offset, size_type n, advice_t hint = normal)
+        : base_type (other, offset, n, hint)
         { }
+
+    view& operator= (view&& other)
+        {
+            base_type::operator= (std::move (other));
+            return *this;
+        }
 };
 
-template <class T>
-class SYSPP_DLLIMPORT const_view : public map_base::view<const T>
+/// \class sys::mapping::const_view
+///
+/// read-only view of any memory mapped object.
+
+template <class T, class CountPolicy = atomic_count>
+class SYSPP_DLLIMPORT const_view : public basic_map_base<CountPolicy>::template view<const T>
 {
+    typedef typename basic_map_base<CountPolicy>::template view<const T> base_type;
+
 public:
-    typedef map_base::off_type	off_type;
-    typedef map_base::size_type	size_type;
+    typedef map_common::off_type	off_type;
+    typedef map_common::size_type	size_type;
 
-    const_view () : map_base::view<const T>() { }
-    explicit const_view (map_base& map, off_type offset = 0, size_type n = 0)
-	: map_base::view<const T> (map, offset, n)
+    const_view () : base_type() { }
+    explicit const_view (basic_map_base<CountPolicy>& map, off_type offset = 0, size_type n = 0,
+                         advice_t hint = normal)
+	: base_type (map, offset, n, hint)
+	{ }
+    const_view (const_view&& other) : base_type (std::move (other)) { }
+    const_view (typename basic_map_base<CountPolicy>::template view<T>&& other)
+	: base_type (std::move (other))
 	{ }
-    const_view (const_view&& other) : map_base::view<const T> (std::move (other)) { }
-    const_view (map_base::view<T>&& other) : map_base::view<const T> (std::move (other)) { }
 
-    template <typename U>
-    const_view (const map_base::view<U>& other, off_type offset, size_type n)
-        : map_base::view<const T> (other, offset, n)
+    // OTHER is any view of the same object
+    template <class View, class = typename std::enable_if<
+                !std::is_base_of<map_common, View>::value>::type>
+    const_view (const View& other, off_type offset, size_type n, advice_t hint = normal)
+        : base_type (other, offset, n, hint)
         { }
+
+    const_view& operator= (const_view&& other)
+        {
+            base_type::operator= (std::move (other));
+            return *this;
+        }
+};
+
+/// \class sys::mapping::output_file
+///
+/// output file that is written through the writable memory mapped view.  file
+/// is preallocated to the expected size, or grows geometrically when the size is
+/// unknown beforehand, and is truncated to the actual length on commit().
+///
+/// typical usage:
+///
+///     sys::mapping::output_file out (filename, unpacked_size);
+///     size_t length = decode (packed, out.data(), out.capacity());
+///     out.commit (length);
+
+class SYSPP_DLLIMPORT output_file
+{
+public:
+    typedef map_base::off_type	off_type;
+    typedef map_base::size_type	size_type;
+
+    static const size_type default_capacity = 0x10000;
+
+    /// output_file (FILENAME, SIZE)
+    ///
+    /// Effects: creates file FILENAME, preallocates SIZE bytes (or
+    /// default_capacity if SIZE is zero) and maps them into memory.
+    /// Throws: sys::file_error if file cannot be created or mapped.
+
+    template <typename CharT>
+    explicit output_file (const CharT* filename, size_type size = 0)
+        { open (filename, size); }
+
+    template <typename Ch, typename Tr, typename Al>
+    explicit output_file (const basic_string<Ch,Tr,Al>& filename, size_type size = 0)
+        { open (filename.c_str(), size); }
+
+    /// ~output_file()
+    ///
+    /// Effects: uncommitted file is truncated to zero length.
+
+    ~output_file ();
+
+    bool is_open () const { return m_file.valid(); }
+
+    uint8_t* data () const { return m_view.data(); }
+    uint8_t* begin () const { return m_view.begin(); }
+    uint8_t* end () const { return m_view.end(); }
+
+    /// capacity()
+    ///
+    /// Returns: number of bytes currently available for writing.
+
+    size_type capacity () const { return m_view.size(); }
+
+    /// get_view()
+    ///
+    /// Returns: writable view of the whole allocated area.  view is invalidated
+    /// by reserve() and commit().
+
+    view<uint8_t>& get_view () { return m_view; }
+
+    /// reserve (SIZE)
+    ///
+    /// Effects: ensures that at least SIZE bytes are available for writing,
+    /// growing file at least twice if necessary.  contents written so far is
+    /// preserved, but the area could be mapped to a different address.
+    /// Returns: pointer to the beginning of the area.
+    /// Throws: sys::generic_error if file cannot be extended.
+
+    uint8_t* reserve (size_type size)
+        {
+            if (size > capacity())
+                resize (std::max (size, capacity() * 2));
+            return data();
+        }
+
+    /// commit (LENGTH)
+    ///
+    /// Effects: unmaps file and truncates it to LENGTH bytes.
+    /// Throws: std::range_error if LENGTH exceedes capacity,
+    ///         sys::generic_error if file cannot be truncated.
+
+    void commit (size_type length);
+
+private:
+    template <typename CharT>
+    void open (const CharT* filename, size_type size);
+    void init (size_type size);
+    void resize (size_type size);
+    void release ();
+    bool set_size (off_type size);
+
+    static sys::raw_handle create (const char* filename);
+    static sys::raw_handle create (const wchar_t* filename);
+
+    sys::file_handle	m_file;
+    readwrite		m_map;
+    view<uint8_t>	m_view;
+
+    output_file (const output_file&);			// not defined
+    output_file& operator= (const output_file&);	//
 };
 
 // --- template methods implementation ---------------------------------------
 
-template <typename CharT> inline void map_base::
-open (const CharT* filename, mode_t mode, off_type size)
+template <typename CharT> inline detail::map_impl* map_common::
+create (const CharT* filename, mode_t mode, off_type size)
 {
     // this handle automatically closes itself on function exit
     sys::file_handle handle (sys::create_file (filename, open_mode (mode), io::share_default));
     if (!handle) SYS_THROW_FILE_ERROR (filename);
     try {
-	open (handle, mode, size);
+	return create (handle, mode, size);
+    }
+    catch (generic_error& X)
+    {
+	throw file_error (X.get_error_code(), filename);
+    }
+}
+
+template <typename CharT> inline void output_file::
+open (const CharT* filename, size_type size)
+{
+    m_file.reset (create (filename));
+    if (!m_file) SYS_THROW_FILE_ERROR (filename);
+    try {
+	init (size);
     }
     catch (generic_error& X)
     {
@@ -385,8 +682,8 @@ open (const CharT* filename, mode_t mode, off_type size)
     }
 }
 
-template <class T> void map_base::view<T>::
-do_remap (off_type offset, size_type n)
+template <class CountPolicy> template <class T> void basic_map_base<CountPolicy>::view<T>::
+do_remap (off_type offset, size_type n, advice_t hint)
 {
     assert (0 == area);
 
@@ -400,7 +697,7 @@ do_remap (off_type offset, size_type n)
     if (!byte_size || off_type (byte_size) > map_size || offset > map_size-byte_size)
 	byte_size = static_cast<size_type> (map_size - offset);
 
-    void* v = map->map (offset, byte_size);
+    void* v = map->map (offset, byte_size, hint);
     if (!v) SYS_THROW_SYSTEM_ERROR();
     area = static_cast<T*> (v);
     msize = byte_size / sizeof(T);
@@ -421,17 +718,17 @@ public:
 
     template <typename CharT>
     explicit mapped_file (const CharT* filename, mapping::mode_t mode, off_type size = 0)
-       	: map_base (filename, mode, size) { }
+       	: mapping::map_base (filename, mode, size) { }
 
     explicit mapped_file (sys::raw_handle handle, mapping::mode_t mode, off_type size = 0)
-       	: map_base (handle, mode, size) { }
+       	: mapping::map_base (handle, mode, size) { }
 
     template <typename CharT>
     void open (const CharT* filename, mapping::mode_t mode, off_type size = 0)
-       	{ map_base::open (filename, mode, size); }
+       	{ mapping::map_base::open (filename, mode, size); }
 
     void open (sys::raw_handle handle, mapping::mode_t mode, off_type size = 0)
-       	{ map_base::open (handle, mode, size); }
+       	{ mapping::map_base::open (handle, mode, size); }
 
     template <class T>
     class view;
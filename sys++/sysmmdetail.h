@@ -51,7 +51,20 @@ enum mode_t
     write,	// read/write access (shared access)
     copy,	// copy-on-write access (private access)
 };
-   
+
+// access pattern hints for mapped views
+
+enum advice_t
+{
+    normal,	// no special treatment
+    sequential,	// expect sequential access, aggressive read-ahead
+    random,	// expect random access, disable read-ahead
+    willneed,	// expect access in the near future, start read-ahead
+    dontneed,	// do not expect access in the near future
+    hugepage,	// back view with huge pages where possible
+    populate,	// prefault whole view at the moment of mapping
+};
+
 namespace detail {
 
 struct SYSPP_DLLIMPORT info
@@ -125,7 +138,9 @@ public:
     map_impl (sys::handle& handle, off_type size, DWORD mode)
        	: backend (handle), backend_size (size), access (mode) { }
 
-    void* map (off_type offset = 0, size_type size = 0)
+    virtual ~map_impl () { }
+
+    virtual void* map (off_type offset = 0, size_type size = 0, advice_t hint = normal)
 	{
 	    off_type page_offset (0);
 	    if (offset)
@@ -137,13 +152,42 @@ public:
 	    LARGE_INTEGER pos;
 	    pos.QuadPart = offset;
 	    char* ptr = (char*) ::MapViewOfFile (backend, access, pos.HighPart, pos.LowPart, size);
-	    return ptr? ptr + page_offset: ptr;
+	    if (!ptr)
+		return ptr;
+	    if (hint != normal)
+	    {
+		if (!size)
+		    size = static_cast<size_type> (backend_size - offset);
+		advise (ptr, size, hint);
+	    }
+	    return ptr + page_offset;
 	}
 
-    bool unmap (void* area, size_type)
+    virtual bool unmap (void* area, size_type)
 	{ return ::UnmapViewOfFile (page_align (area)); }
 
-    bool sync (void* area, size_type size)
+    // advise (AREA, SIZE, HINT)
+    //
+    // Windows has no equivalent of madvise, the only hints that make sense here
+    // are those that trigger read-ahead.
+    // Returns: false if the hint was rejected or is not supported.
+    virtual bool advise (void* area, size_type size, advice_t hint)
+	{
+#if _WIN32_WINNT >= 0x0602
+	    if (willneed == hint || populate == hint || sequential == hint)
+	    {
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress = page_align (area);
+		range.NumberOfBytes = size_align (area, size);
+		return ::PrefetchVirtualMemory (::GetCurrentProcess(), 1, &range, 0);
+	    }
+#else
+	    (void)area; (void)size;
+#endif
+	    return normal == hint;
+	}
+
+    virtual bool sync (void* area, size_type size)
 	{ return ::FlushViewOfFile (page_align (area), size_align (area, size)); }
 
     off_type get_size () const { return backend_size; }
@@ -151,6 +195,11 @@ public:
     bool writeable () const
        	{ return access & (FILE_MAP_WRITE|FILE_MAP_COPY); }
 
+protected:
+    // constructor for objects that are not backed by file mapping
+    map_impl (off_type size, DWORD mode)
+	: backend_size (size), access (mode) { }
+
 private:
 
     sys::handle		backend;
@@ -172,7 +221,9 @@ public:
 	, map_flags (mode == copy? MAP_PRIVATE: MAP_SHARED)
 	{ }
 
-    void* map (off_type offset = 0, size_type size = 0)
+    virtual ~map_impl () { }
+
+    virtual void* map (off_type offset = 0, size_type size = 0, advice_t hint = normal)
 	{
 	    off_type page_offset (0);
 	    if (offset)
@@ -183,20 +234,55 @@ public:
 	    }
 	    if (size == 0)
 	       	size = backend_size - offset;
-	    void* ptr = ::mmap (NULL, size, protect, map_flags, backend, offset);
+	    int flags = map_flags;
+#ifdef MAP_POPULATE
+	    if (populate == hint)
+		flags |= MAP_POPULATE;
+#endif
+	    void* ptr = ::mmap (NULL, size, protect, flags, backend, offset);
 	    if (ptr != MAP_FAILED)
 	    {
 		assert (0 == (int_ptr_cast (ptr) & page_mask()));
+		// advice is merely a hint, failure to apply it is not an error
+		if (hint != normal && flags == map_flags)
+		    advise (ptr, size, hint);
 		return static_cast<char*>(ptr) + page_offset;
 	    }
 	    else
 		return 0;
 	}
 
-    bool unmap (void* area, size_type size)
+    virtual bool unmap (void* area, size_type size)
 	{ return ::munmap (page_align (area), size_align (area, size)) != -1; }
 
-    bool sync (void* area, off_type size)
+    // advise (AREA, SIZE, HINT)
+    //
+    // Effects: passes access pattern HINT for SIZE bytes at AREA to the kernel.
+    // Returns: false if the hint was rejected or is not supported.
+    virtual bool advise (void* area, size_type size, advice_t hint)
+	{
+	    int advice;
+	    switch (hint)
+	    {
+	    case normal:	advice = MADV_NORMAL; break;
+	    case sequential:	advice = MADV_SEQUENTIAL; break;
+	    case random:	advice = MADV_RANDOM; break;
+	    case willneed:	advice = MADV_WILLNEED; break;
+	    case dontneed:	advice = MADV_DONTNEED; break;
+#ifdef MADV_HUGEPAGE
+	    case hugepage:	advice = MADV_HUGEPAGE; break;
+#endif
+#ifdef MADV_POPULATE_READ
+	    case populate:	advice = MADV_POPULATE_READ; break;
+#else
+	    case populate:	advice = MADV_WILLNEED; break;
+#endif
+	    default:		return false;
+	    }
+	    return ::madvise (page_align (area), size_align (area, size), advice) != -1;
+	}
+
+    virtual bool sync (void* area, size_type size)
 	{
 	    size = size? size_align (area, size): page_size();
 	    return ::msync (page_align (area), size, MS_SYNC) != -1;
@@ -206,6 +292,14 @@ public:
 
     bool writeable () const { return protect & PROT_WRITE; }
 
+protected:
+    // constructor for objects that are not backed by file mapping
+    map_impl (off_type size, mode_t mode)
+	: backend_size (size)
+	, protect (mode == read? PROT_READ: PROT_READ|PROT_WRITE)
+	, map_flags (MAP_PRIVATE)
+	{ }
+
 private:
 
     sys::file_handle	backend;
@@ -216,6 +310,77 @@ private:
 
 #endif /* _WIN32 */
 
+// anonymous_impl
+// memory mapped object backed by anonymous memory.  whole area is allocated at
+// once and recycled through the process-wide pool, views merely point into it.
+
+class SYSPP_DLLIMPORT anonymous_impl : public map_impl
+{
+public:
+    anonymous_impl (size_type size, bool huge_pages);
+    ~anonymous_impl ();
+
+    void* map (off_type offset = 0, size_type size = 0, advice_t hint = normal)
+	{
+	    char* ptr = static_cast<char*> (area) + offset;
+	    if (hint != normal)
+		advise (ptr, size? size: static_cast<size_type> (get_size() - offset), hint);
+	    return ptr;
+	}
+
+    bool unmap (void*, size_type) { return true; }
+
+    bool sync (void*, size_type) { return true; }
+
+private:
+    void*	area;
+    size_type	capacity;	// actual size of allocated area
+};
+
+// buffer_impl
+// small files are read into the heap buffer at once, that is cheaper than
+// setting up the mapping.  views merely point into the buffer.
+
+class SYSPP_DLLIMPORT buffer_impl : public map_impl
+{
+public:
+#ifdef _WIN32
+    buffer_impl (size_type size, DWORD mode)
+#else
+    buffer_impl (size_type size, mode_t mode)
+#endif
+	: map_impl (size, mode), buffer (new char[size]())
+	{ }
+
+    ~buffer_impl () { delete[] buffer; }
+
+    void* map (off_type offset = 0, size_type = 0, advice_t = normal)
+	{ return buffer + offset; }
+
+    bool unmap (void*, size_type) { return true; }
+
+    bool sync (void*, size_type) { return true; }
+
+    bool advise (void*, size_type, advice_t) { return true; }
+
+    char* data () const { return buffer; }
+
+private:
+    char*	buffer;
+
+    buffer_impl (const buffer_impl&);			// not defined
+    buffer_impl& operator= (const buffer_impl&);	//
+};
+
+struct anonymous_pool_stats
+{
+    unsigned long	hits;		// allocations satisfied from the pool
+    unsigned long	misses;		// allocations that required system call
+    unsigned long	evictions;	// areas released because the pool was full
+    size_t		cached_bytes;	// size of areas currently held by the pool
+    size_t		limit;		// maximum size of areas held by the pool
+};
+
 } } } // namespace sys::mapping::detail
 
 #endif /* SYSMMDETAIL_H */
@@ -0,0 +1,151 @@
+// -*- C++ -*-
+//! \file       sysmmwindow.h
+//! \date       2026 Oct 16
+//! \brief      sliding window reader over memory mapped objects.
+//
+
+#ifndef SYSMMWINDOW_H
+#define SYSMMWINDOW_H
+
+#include "sysmemmap.h"
+#include <future>
+#include <stdexcept>
+#include <algorithm>
+
+namespace sys { namespace mapping {
+
+/// \class sys::mapping::window_reader
+///
+/// walks memory mapped object in page-aligned windows of fixed size, so that
+/// files larger than the address space could be processed in bounded memory.
+/// adjacent windows overlap by at least OVERLAP bytes.  while the caller
+/// processes current window, the next one is mapped and prefaulted on a helper
+/// thread.
+///
+/// typical usage:
+///
+///     sys::mapping::window_reader reader (in);
+///     if (!reader.empty()) do
+///     {
+///         process (reader.begin(), reader.next_begin(), reader.offset());
+///     }
+///     while (reader.next());
+
+class window_reader
+{
+public:
+    typedef map_base::off_type	off_type;
+    typedef map_base::size_type	size_type;
+
+    static const size_type default_window_size = 32 << 20;
+
+    /// window_reader (MAP, WINDOW_SIZE, OVERLAP, HINT)
+    ///
+    /// Effects: maps first window of MAP.  WINDOW_SIZE and OVERLAP are rounded up
+    /// to the page size.  HINT is applied to every window mapped ahead.
+    /// Throws: std::invalid_argument if OVERLAP is not less than WINDOW_SIZE,
+    ///         sys::generic_error if some system error occurs.
+
+    explicit window_reader (map_base& map, size_type window_size = default_window_size,
+                            size_type overlap = 0, advice_t hint = populate)
+        : m_map_size (map.size()), m_offset (0), m_hint (hint)
+        {
+            const size_type mask = map_base::page_mask();
+            m_window = std::max ((window_size + mask) & ~mask, map_base::page_size());
+            overlap = (overlap + mask) & ~mask;
+            if (overlap >= m_window)
+                throw std::invalid_argument ("window_reader: overlap exceeds window size");
+            m_step = m_window - overlap;
+            m_anchor.bind (map);
+            if (m_map_size)
+            {
+                m_view = map_window (0);
+                prefetch();
+            }
+        }
+
+    ~window_reader ()
+        {
+            // view mapped by helper thread is discarded
+            if (m_ahead.valid())
+                m_ahead.wait();
+        }
+
+    bool empty () const { return 0 == m_view.size(); }
+
+    const uint8_t* data () const { return m_view.data(); }
+    const uint8_t* begin () const { return m_view.begin(); }
+    const uint8_t* end () const { return m_view.end(); }
+    size_type size () const { return m_view.size(); }
+
+    /// offset()
+    ///
+    /// Returns: offset of the current window within mapped object.
+
+    off_type offset () const { return m_offset; }
+
+    /// next_begin()
+    ///
+    /// Returns: pointer within current window where the next window starts.
+    /// bytes in range [begin(), next_begin()) are not seen by subsequent windows,
+    /// the rest is repeated at the beginning of the next window.  for the last
+    /// window returns end().
+
+    const uint8_t* next_begin () const
+        { return last()? end(): begin() + m_step; }
+
+    /// last()
+    ///
+    /// Returns: true if current window reaches the end of mapped object.
+
+    bool last () const { return m_offset + off_type (m_view.size()) >= m_map_size; }
+
+    /// next()
+    ///
+    /// Effects: advances to the next window.
+    /// Returns: false if current window was the last one.
+    /// Throws: sys::generic_error if next window could not be mapped.
+
+    bool next ()
+        {
+            if (last())
+                return false;
+            m_view = m_ahead.get();
+            m_offset += m_step;
+            prefetch();
+            return true;
+        }
+
+    size_type window_size () const { return m_window; }
+    size_type overlap () const { return m_window - m_step; }
+
+private:
+    const_view<uint8_t> map_window (off_type offset) const
+        {
+            size_type n = static_cast<size_type> (std::min<off_type> (m_window, m_map_size - offset));
+            return const_view<uint8_t> (m_anchor, offset, n, m_hint);
+        }
+
+    void prefetch ()
+        {
+            if (!last())
+                m_ahead = std::async (std::launch::async, &window_reader::map_window,
+                                      this, m_offset + m_step);
+        }
+
+    const_view<uint8_t>                 m_anchor;   // unmapped, keeps reference to the map
+    const_view<uint8_t>                 m_view;
+    std::future<const_view<uint8_t>>    m_ahead;
+    const off_type                      m_map_size;
+    off_type                            m_offset;
+    size_type                           m_window;
+    size_type                           m_step;
+    const advice_t                      m_hint;
+
+    window_reader (const window_reader&);             // not defined
+    window_reader& operator= (const window_reader&);  //
+};
+
+} } // namespace sys::mapping
+
+#endif /* SYSMMWINDOW_H */
@@ -0,0 +1,163 @@
+// -*- C++ -*-
+//! \file       batchread.cc
+//! \date       2026 Oct 16
+//! \brief      compare reading directory of small files one by one against
+//              batch_reader backends.
+//
+
+#include "sysbatch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::vector<std::string> create_files (const std::string& dir, int count, size_t max_size)
+{
+    std::vector<std::string> names;
+    std::vector<char> data (max_size);
+    for (size_t i = 0; i < max_size; ++i)
+        data[i] = static_cast<char> (i * 7);
+    std::srand (1);
+    for (int i = 0; i < count; ++i)
+    {
+        char name[32];
+        std::sprintf (name, "%05d.bin", i);
+        names.push_back (dir + "/" + name);
+        size_t size = 1 + std::rand() % max_size;
+        std::ofstream out (names.back().c_str(), std::ios::out|std::ios::binary|std::ios::trunc);
+        if (!out.write (data.data(), size))
+            throw std::runtime_error ("failed to create test file");
+    }
+    return names;
+}
+
+void remove_files (const std::vector<std::string>& names)
+{
+    for (const auto& name : names)
+        std::remove (name.c_str());
+}
+
+// drop files from the page cache, so that every pass starts cold.  on systems
+// without posix_fadvise passes are measured against the warm cache.
+
+void evict_files (const std::vector<std::string>& names)
+{
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+    for (const auto& name : names)
+    {
+        int fd = ::open (name.c_str(), O_RDONLY);
+        if (-1 == fd)
+            continue;
+        ::fdatasync (fd);
+        ::posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close (fd);
+    }
+#else
+    (void)names;
+#endif
+}
+
+unsigned checksum (sys::mapping::map_base& in)
+{
+    sys::mapping::const_view<uint8_t> view (in);
+    unsigned sum = 0;
+    for (auto b : view)
+        sum += b;
+    return sum;
+}
+
+double scan_single (const std::vector<std::string>& names, unsigned& sum)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& name : names)
+    {
+        sys::mapping::readonly in (name);
+        sum += checksum (in);
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+double scan_batch (const std::vector<std::string>& names, sys::batch_reader::backend_type backend,
+                   unsigned concurrency, unsigned& sum)
+{
+    auto start = std::chrono::steady_clock::now();
+    sys::batch_reader batch (names, backend, concurrency);
+    sys::batch_reader::item file;
+    while (batch.next (file))
+    {
+        if (file.error)
+            throw std::runtime_error ("batch read failed");
+        sum += checksum (file.data);
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    if (argc < 2)
+    {
+        std::puts ("usage: batchread DIRECTORY [COUNT [MAX_SIZE [CONCURRENCY]]]");
+        return 0;
+    }
+    const std::string dir (argv[1]);
+    int count = argc > 2 ? std::atoi (argv[2]) : 20000;
+    if (count <= 0)
+        count = 20000;
+    size_t max_size = argc > 3 ? std::strtoul (argv[3], 0, 0) : 0x4000;
+    if (!max_size)
+        max_size = 0x4000;
+    unsigned concurrency = argc > 4 ? std::atoi (argv[4]) : 0;
+
+    auto names = create_files (dir, count, max_size);
+    std::printf ("%d files up to %u bytes\n", count, unsigned (max_size));
+    std::printf ("%-10s %12s %12s\n", "method", "cold ms", "warm ms");
+
+    unsigned reference = 0;
+    evict_files (names);
+    double t_cold = scan_single (names, reference);
+    reference = 0;
+    double t_warm = scan_single (names, reference);
+    std::printf ("%-10s %12.1f %12.1f\n", "single", t_cold * 1e3, t_warm * 1e3);
+
+    struct { const char* name; sys::batch_reader::backend_type backend; } methods[] = {
+        { "uring",   sys::batch_reader::uring },
+        { "threads", sys::batch_reader::threads },
+    };
+    for (const auto& m : methods)
+    {
+        try
+        {
+            unsigned sum_cold = 0, sum_warm = 0;
+            evict_files (names);
+            t_cold = scan_batch (names, m.backend, concurrency, sum_cold);
+            t_warm = scan_batch (names, m.backend, concurrency, sum_warm);
+            if (sum_cold != reference || sum_warm != reference)
+                throw std::runtime_error ("checksum mismatch");
+            std::printf ("%-10s %12.1f %12.1f\n", m.name, t_cold * 1e3, t_warm * 1e3);
+        }
+        catch (std::exception& X)
+        {
+            std::printf ("%-10s %s\n", m.name, X.what());
+        }
+    }
+    remove_files (names);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "batchread: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,176 @@
+// -*- C++ -*-
+//! \file       bitread.cc
+//! \date       2026 Oct 16
+//! \brief      measure bit_reader throughput against bit-at-a-time loops.
+//
+
+#include "bitreader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+typedef std::vector<bin::uint8_t> byte_vector;
+
+// loop used by most decoders: fetch byte, walk the mask.
+
+unsigned scan_bytewise (const byte_vector& input, size_t nbits)
+{
+    const bin::uint8_t* src = input.data();
+    unsigned sum = 0, bits = 0, mask = 0;
+    for (size_t i = 0; i < nbits; ++i)
+    {
+        if (!mask)
+        {
+            bits = *src++;
+            mask = 0x80;
+        }
+        sum = sum * 2 + ((bits & mask) != 0);
+        mask >>= 1;
+    }
+    return sum;
+}
+
+// 16-bit words with sentinel bit, like deike bit_stream.
+
+unsigned scan_wordwise (const byte_vector& input, size_t nbits)
+{
+    const bin::uint8_t* src = input.data();
+    const bin::uint8_t* end = src + input.size();
+    unsigned sum = 0, bits = 1;
+    for (size_t i = 0; i < nbits; ++i)
+    {
+        if (1 == bits)
+        {
+            if (src + 2 > end)
+                throw std::runtime_error ("end of stream");
+            bits = (src[0] | src[1] << 8) | 0x10000;
+            src += 2;
+        }
+        sum = sum * 2 + (bits & 1);
+        bits >>= 1;
+    }
+    return sum;
+}
+
+template <class Order, unsigned Width>
+unsigned scan_get_bit (const byte_vector& input, size_t nbits)
+{
+    bin::bit_reader<Order, Width> bits (input.data(), input.data() + input.size());
+    unsigned sum = 0;
+    for (size_t i = 0; i < nbits; ++i)
+        sum = sum * 2 + bits.get_bit();
+    return sum;
+}
+
+// variable-width fields, as in LZ offset/length pairs.
+
+unsigned scan_get_bits (const byte_vector& input, size_t nbits)
+{
+    bin::bit_reader<bin::msb_first> bits (input.data(), input.data() + input.size());
+    unsigned sum = 0, width = 1;
+    for (size_t i = 0; i + width <= nbits; i += width)
+    {
+        sum = sum * 31 + bits.get_bits (width);
+        width = width % 13 + 1;
+    }
+    return sum;
+}
+
+// table-driven decoder pattern: ensure longest code once, then peek/consume.
+
+unsigned scan_peek (const byte_vector& input, size_t nbits)
+{
+    bin::bit_reader<bin::msb_first> bits (input.data(), input.data() + input.size());
+    unsigned sum = 0, width = 1;
+    for (size_t i = 0; i + width <= nbits; i += width)
+    {
+        if (!bits.ensure (16))
+            break;
+        sum = sum * 31 + bits.peek (width);
+        bits.consume (width);
+        width = width % 13 + 1;
+    }
+    return sum;
+}
+
+unsigned scan_bytewise_fields (const byte_vector& input, size_t nbits)
+{
+    const bin::uint8_t* src = input.data();
+    unsigned sum = 0, bits = 0, mask = 0, width = 1;
+    for (size_t i = 0; i + width <= nbits; i += width)
+    {
+        unsigned field = 0;
+        for (unsigned j = 0; j < width; ++j)
+        {
+            if (!mask)
+            {
+                bits = *src++;
+                mask = 0x80;
+            }
+            field = field * 2 + ((bits & mask) != 0);
+            mask >>= 1;
+        }
+        sum = sum * 31 + field;
+        width = width % 13 + 1;
+    }
+    return sum;
+}
+
+typedef unsigned (*scan_func) (const byte_vector&, size_t);
+
+unsigned run_report (const char* name, scan_func scan, const byte_vector& input,
+                     size_t nbits, int passes)
+{
+    unsigned sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+        sum += scan (input, nbits);
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    std::printf ("%-24s %10.1f\n", name, double (nbits) * passes / t.count() / 1e6);
+    return sum;
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x100000;
+    if (!size)
+        size = 0x100000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 20;
+    if (passes <= 0)
+        passes = 1;
+
+    byte_vector input (size);
+    std::srand (1);
+    for (auto& b : input)
+        b = static_cast<bin::uint8_t> (std::rand());
+    // trailing bytes are left for the scalar refill path
+    const size_t nbits = (size - 1) * 8;
+
+    std::printf ("%u bytes, %d passes\n", unsigned (size), passes);
+    std::printf ("%-24s %10s\n", "method", "Mbit/s");
+    unsigned a = run_report ("bytewise bit", scan_bytewise, input, nbits, passes);
+    unsigned b = run_report ("bit_reader<msb,8> bit", scan_get_bit<bin::msb_first, 8>, input, nbits, passes);
+    if (a != b)
+        throw std::runtime_error ("msb_first mismatch");
+    a = run_report ("wordwise bit", scan_wordwise, input, nbits, passes);
+    b = run_report ("bit_reader<lsb,16> bit", scan_get_bit<bin::lsb_first, 16>, input, nbits, passes);
+    if (a != b)
+        throw std::runtime_error ("lsb_first mismatch");
+    a = run_report ("bytewise fields", scan_bytewise_fields, input, nbits, passes);
+    b = run_report ("bit_reader get_bits", scan_get_bits, input, nbits, passes);
+    unsigned c = run_report ("bit_reader peek/consume", scan_peek, input, nbits, passes);
+    if (a != b || a != c)
+        throw std::runtime_error ("field mismatch");
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "bitread: %s\n", X.what());
+    return 1;
+}
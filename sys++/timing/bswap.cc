@@ -0,0 +1,76 @@
+// -*- C++ -*-
+//! \file       bswap.cc
+//! \date       2026 Oct 16
+//! \brief      compare bulk endian conversion against element-wise functors.
+//
+
+#include "bindata.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <stdexcept>
+
+namespace {
+
+template <typename IntT>
+double run_transform (const std::vector<IntT>& src, std::vector<IntT>& dst, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+        std::transform (src.begin(), src.end(), dst.begin(), bin::bigendian_convert<IntT>());
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+template <typename IntT>
+double run_bulk (const std::vector<IntT>& src, std::vector<IntT>& dst, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+        bin::convert_range<bin::bigendian_convert<IntT>> (src.data(), dst.data(), src.size());
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+template <typename IntT>
+void run_report (const char* name, size_t bytes, int passes)
+{
+    // odd number of elements exercises the scalar tail
+    std::vector<IntT> src (bytes / sizeof(IntT) + 3), dst1 (src.size()), dst2 (src.size());
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = static_cast<IntT> (i * 0x9E3779B97F4A7C15ull);
+
+    double t_scalar = run_transform (src, dst1, passes);
+    double t_bulk = run_bulk (src, dst2, passes);
+    if (dst1 != dst2)
+        throw std::runtime_error ("conversion mismatch");
+
+    const double mb = double (src.size() * sizeof(IntT)) * passes / (1024*1024);
+    std::printf ("%-8s %12.1f %12.1f %8.2f\n", name, mb / t_scalar, mb / t_bulk, t_scalar / t_bulk);
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t bytes = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x10000;
+    if (!bytes)
+        bytes = 0x10000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 0;
+    if (passes <= 0)
+        passes = static_cast<int> (std::max<size_t> (1, (size_t (1) << 32) / bytes));
+
+    std::printf ("%u bytes, %d passes\n", unsigned (bytes), passes);
+    std::printf ("%-8s %12s %12s %8s\n", "type", "scalar MB/s", "bulk MB/s", "ratio");
+    run_report<bin::uint16_t> ("uint16", bytes, passes);
+    run_report<bin::uint32_t> ("uint32", bytes, passes);
+    run_report<bin::uint64_t> ("uint64", bytes, passes);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "bswap: %s\n", X.what());
+    return 1;
+}
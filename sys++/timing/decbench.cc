@@ -0,0 +1,739 @@
+// -*- C++ -*-
+//! \file       decbench.cc
+//! \date       2026 Oct 16
+//! \brief      run every decompressor over synthetic corpora and report speed,
+//              cycles per byte and peak memory in a table suitable for diff.
+//
+// corpora are generated in memory and compressed with reference encoders
+// below, so no game data is needed.  every decoded buffer is compared with the
+// original before its timing is reported.
+//
+// output is one line per decoder and corpus, columns separated by spaces:
+//
+//   format corpus size packed mb_s cpb peak_kb
+//
+// mb_s is decoded megabytes per second, cpb is cycles per decoded byte counted
+// by time stamp counter on x86, '-' elsewhere.  peak_kb is resident set
+// high-water mark of the whole process after the row was measured, so it
+// only grows down the table; compare the same row between builds.
+
+#include "lzssenc.h"
+#include "lzssvar.h"
+#include "prsdec.h"
+#include "ikedec.h"
+#include "zio.h"
+#include "../../vns/esd.h"
+#include <zlib.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define DECBENCH_RDTSC 1
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <x86intrin.h>
+#define DECBENCH_RDTSC 1
+#else
+#define DECBENCH_RDTSC 0
+#endif
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+// --- corpora ---------------------------------------------------------------
+
+// xorshift generator, std::rand is too slow for megabytes of noise.
+
+class random_source
+{
+public:
+    explicit random_source (uint32_t seed) : m_state (seed ? seed : 1) { }
+
+    uint32_t operator() ()
+	{
+	    m_state ^= m_state << 13;
+	    m_state ^= m_state >> 17;
+	    m_state ^= m_state << 5;
+	    return m_state;
+	}
+
+private:
+    uint32_t	m_state;
+};
+
+// script-like text: lines of words from small vocabulary, with two-byte
+// command codes in between.
+
+byte_vector make_text (size_t size)
+{
+    static const char* const words[] = {
+	"the", "of", "and", "to", "in", "is", "you", "that", "it", "he",
+	"was", "for", "on", "are", "as", "with", "his", "they", "at", "be",
+	"this", "have", "from", "or", "one", "had", "by", "word", "but", "not",
+	"what", "all", "were", "we", "when", "your", "can", "said", "there", "use",
+    };
+    const size_t word_count = sizeof(words)/sizeof(*words);
+    random_source rnd (1);
+    byte_vector text;
+    text.reserve (size + 128);
+    while (text.size() < size)
+    {
+	text.push_back (0x10 + rnd() % 8);
+	text.push_back (rnd() & 0xFF);
+	unsigned line_length = 3 + rnd() % 12;
+	for (unsigned i = 0; i < line_length; ++i)
+	{
+	    const char* word = words[rnd() % word_count];
+	    text.insert (text.end(), word, word + std::strlen (word));
+	    text.push_back (' ');
+	}
+	text.back() = '\n';
+    }
+    text.resize (size);
+    return text;
+}
+
+// image-like data: 32-bit pixels of smooth gradients with a bit of noise,
+// flat areas and rows repeated from above.
+
+byte_vector make_image (size_t size)
+{
+    const unsigned width = 640;
+    random_source rnd (2);
+    byte_vector image (size);
+    for (size_t pos = 0; pos < size; pos += 4)
+    {
+	size_t pixel = pos / 4;
+	unsigned x = pixel % width, y = static_cast<unsigned> (pixel / width);
+	uint8_t px[4];
+	if (y > 0 && (y / 8) % 3 == 0)
+	    std::memcpy (px, &image[pos - width * 4], 4);	// repeated rows
+	else if (x / 64 % 4 == 1)
+	{
+	    px[0] = 0x20; px[1] = 0x40; px[2] = 0x80; px[3] = 0xFF;	// flat area
+	}
+	else
+	{
+	    unsigned noise = rnd() & 3;
+	    px[0] = static_cast<uint8_t> (x / 3 + noise);
+	    px[1] = static_cast<uint8_t> (y / 2 + noise);
+	    px[2] = static_cast<uint8_t> ((x + y) / 4);
+	    px[3] = 0xFF;
+	}
+	std::memcpy (&image[pos], px, std::min<size_t> (4, size - pos));
+    }
+    return image;
+}
+
+byte_vector make_random (size_t size)
+{
+    random_source rnd (3);
+    byte_vector data (size);
+    for (auto& b : data)
+	b = static_cast<uint8_t> (rnd() >> 7);
+    return data;
+}
+
+// --- LZSS variants (sys++/lzssvar.h) -------------------------------------
+
+using bin::classic_lzss;	// tools/lzss.cc
+using bin::bcs_lzss;		// vns/debcs.cc
+using bin::ps2_lzss;		// vns/deps2.cc
+using bin::advc_lzss;		// dec/unadvc.cc
+
+template <class Params>
+byte_vector lzss_encode (const byte_vector& input)
+{
+    bin::lzss_encoder<Params> lzss;
+    byte_vector packed;
+    lzss.encode (input.data(), input.size(), packed);
+    return packed;
+}
+
+template <class Params>
+size_t lzss_decode (const byte_vector& packed, byte_vector& output)
+{
+    return bin::lzss_decompress<Params> (packed.data(), packed.size(), output.data(), output.size());
+}
+
+// --- match finder for PRS and ike ------------------------------------------
+
+// greedy hash chain search for matches of 3 bytes or more, plus the last
+// occurrence of every byte pair for two-byte matches.
+
+class match_finder
+{
+public:
+    match_finder (const byte_vector& data, size_t window, unsigned max_match)
+	: m_data (data), m_window (window), m_max_match (max_match)
+	, m_head (hash_size, nil), m_prev (data.size(), nil), m_pair (0x10000, nil)
+	{ }
+
+    // find (POS, ACCEPT, DISTANCE)
+    // Returns: length of the longest match at POS with distance for which
+    // ACCEPT returns true, 0 if there's none.
+
+    template <class Accept>
+    unsigned find (size_t pos, Accept accept, size_t& distance) const
+	{
+	    if (m_data.size() - pos < 3)
+		return 0;
+	    const size_t limit = std::min<size_t> (m_max_match, m_data.size() - pos);
+	    unsigned best = 0;
+	    long cand = m_head[hash (pos)];
+	    for (unsigned depth = 0; cand != nil && depth < max_depth; ++depth, cand = m_prev[cand])
+	    {
+		size_t d = pos - cand;
+		if (d > m_window)
+		    break;
+		if (!accept (d))
+		    continue;
+		unsigned n = 0;
+		while (n < limit && m_data[cand + n] == m_data[pos + n])
+		    ++n;
+		if (n > best)
+		{
+		    best = n;
+		    distance = d;
+		    if (n == limit)
+			break;
+		}
+	    }
+	    return best >= 3 ? best : 0;
+	}
+
+    // Returns: distance to the previous occurrence of byte pair at POS, 0 if
+    // there's none.
+
+    size_t find_pair (size_t pos) const
+	{
+	    if (m_data.size() - pos < 2)
+		return 0;
+	    long cand = m_pair[pair (pos)];
+	    return cand != nil ? pos - cand : 0;
+	}
+
+    void insert (size_t pos)
+	{
+	    if (m_data.size() - pos >= 3)
+	    {
+		unsigned h = hash (pos);
+		m_prev[pos] = m_head[h];
+		m_head[h] = static_cast<long> (pos);
+	    }
+	    if (m_data.size() - pos >= 2)
+		m_pair[pair (pos)] = static_cast<long> (pos);
+	}
+
+private:
+    enum { hash_bits = 15, hash_size = 1 << hash_bits, max_depth = 32, nil = -1 };
+
+    unsigned hash (size_t pos) const
+	{
+	    const uint8_t* p = &m_data[pos];
+	    uint32_t v = p[0] | p[1] << 8 | p[2] << 16;
+	    return (v * 2654435761u) >> (32 - hash_bits);
+	}
+    unsigned pair (size_t pos) const { return m_data[pos] | m_data[pos+1] << 8; }
+
+    const byte_vector&	m_data;
+    size_t		m_window;
+    unsigned		m_max_match;
+    std::vector<long>	m_head;
+    std::vector<long>	m_prev;
+    std::vector<long>	m_pair;
+};
+
+// --- PRS (dec/adviz.cc) ----------------------------------------------------
+
+class prs_writer
+{
+public:
+    prs_writer () : m_ctl (0), m_count (16) { }
+
+    void put_literal (uint8_t byte)
+	{
+	    put_flag (0);
+	    m_data.push_back (byte);
+	}
+    void put_ref (unsigned count, unsigned distance)
+	{
+	    put_flag (1);
+	    if (count <= 9 && distance <= 16)
+		m_data.push_back (static_cast<uint8_t> ((count - 2) << 5 | (distance - 1) << 1 | 1));
+	    else
+	    {
+		unsigned code = (count - 2) << 10 | (distance - 1);
+		m_data.push_back (static_cast<uint8_t> (code << 1));
+		m_data.push_back (static_cast<uint8_t> (code >> 7));
+	    }
+	}
+    byte_vector& data () { return m_data; }
+
+private:
+    void put_flag (unsigned bit)
+	{
+	    if (16 == m_count)
+	    {
+		m_ctl = m_data.size();
+		m_data.resize (m_ctl + 2);
+		m_count = 0;
+	    }
+	    if (bit)
+	    {
+		unsigned mask = 0x8000 >> m_count;
+		m_data[m_ctl] |= static_cast<uint8_t> (mask);
+		m_data[m_ctl+1] |= static_cast<uint8_t> (mask >> 8);
+	    }
+	    ++m_count;
+	}
+
+    byte_vector	m_data;
+    size_t	m_ctl;
+    unsigned	m_count;
+};
+
+byte_vector prs_encode (const byte_vector& input)
+{
+    match_finder finder (input, 1024, 33);
+    prs_writer out;
+    size_t pos = 0;
+    // decoder rejects references to the very first output byte
+    auto accept = [&] (size_t distance) { return distance < pos; };
+    while (pos < input.size())
+    {
+	size_t distance = 0;
+	unsigned count = finder.find (pos, accept, distance);
+	if (!count)
+	{
+	    distance = finder.find_pair (pos);
+	    if (distance && distance < pos && distance <= 1024)
+		count = 2;
+	}
+	if (!count)
+	{
+	    out.put_literal (input[pos]);
+	    finder.insert (pos++);
+	    continue;
+	}
+	out.put_ref (count, static_cast<unsigned> (distance));
+	for (unsigned i = 0; i < count; ++i)
+	    finder.insert (pos++);
+    }
+    return std::move (out.data());
+}
+
+size_t prs_decode (const byte_vector& packed, byte_vector& output)
+{
+    return bin::prs_decompress (packed.data(), packed.size(), output.data(), output.size());
+}
+
+// --- ike (vns/deike.cc) ----------------------------------------------------
+
+// next control word is reserved right after the last bit of the current one
+// is written, the way decoder fetches it.
+
+class ike_writer
+{
+public:
+    explicit ike_writer (size_t unpacked_size)
+	: m_data (13), m_count (0)
+	{
+	    m_data[2] = 'i'; m_data[3] = 'k'; m_data[4] = 'e';
+	    m_data[10] = static_cast<uint8_t> (unpacked_size >> 16 << 2);
+	    m_data[11] = static_cast<uint8_t> (unpacked_size);
+	    m_data[12] = static_cast<uint8_t> (unpacked_size >> 8);
+	    reserve_word();
+	}
+
+    void put_bit (unsigned bit)
+	{
+	    if (bit)
+		m_data[m_word + m_count / 8] |= 1 << (m_count & 7);
+	    if (16 == ++m_count)
+		reserve_word();
+	}
+    void put_bits (unsigned bits, unsigned length)
+	{
+	    for (unsigned i = 0; i < length; ++i)
+		put_bit (bits >> i & 1);
+	}
+    void put_byte (uint8_t byte) { m_data.push_back (byte); }
+
+    byte_vector& data () { return m_data; }
+
+private:
+    void reserve_word ()
+	{
+	    m_word = m_data.size();
+	    m_data.resize (m_word + 2);
+	    m_count = 0;
+	}
+
+    byte_vector	m_data;
+    size_t	m_word;
+    unsigned	m_count;
+};
+
+// shortest prefix codes for long match distances and counts, derived from
+// decoder tables.
+
+class ike_codes
+{
+public:
+    struct code { uint16_t bits; uint8_t length; uint8_t byte; };
+
+    ike_codes () : m_offset (1), m_count (17)
+	{
+	    const auto& tables = bin::detail::ike_tables::instance();
+	    for (unsigned bits = 0; bits < 0x100; ++bits)
+	    {
+		const auto& e = tables.offset[bits];
+		// distance = 0x100 - byte - delta
+		for (unsigned byte = 0; byte < 0x100; ++byte)
+		{
+		    size_t distance = 0x100 - byte - e.delta;
+		    if (distance >= m_offset.size())
+			m_offset.resize (distance + 1);
+		    code& c = m_offset[distance];
+		    if (!c.length || e.length < c.length)
+		    {
+			c.bits = static_cast<uint16_t> (bits & ((1u << e.length) - 1));
+			c.length = e.length;
+			c.byte = static_cast<uint8_t> (byte);
+		    }
+		}
+	    }
+	    for (unsigned bits = 0; bits < 0x200; ++bits)
+	    {
+		const auto& e = tables.count[bits];
+		code& c = e.count ? m_count[e.count] : m_long_count;
+		if (!c.length || e.length < c.length)
+		{
+		    c.bits = static_cast<uint16_t> (bits & ((1u << e.length) - 1));
+		    c.length = e.length;
+		}
+	    }
+	}
+
+    size_t max_distance () const { return m_offset.size() - 1; }
+    const code* offset (size_t distance) const
+	{
+	    return distance < m_offset.size() && m_offset[distance].length ? &m_offset[distance] : 0;
+	}
+    const code& count (unsigned n) const { return n < 17 ? m_count[n] : m_long_count; }
+
+private:
+    std::vector<code>	m_offset;
+    std::vector<code>	m_count;
+    code		m_long_count = code();
+};
+
+byte_vector ike_encode (const byte_vector& input)
+{
+    static const ike_codes codes;
+    match_finder finder (input, codes.max_distance(), 272);
+    ike_writer out (input.size());
+    auto accept = [&] (size_t distance) { return codes.offset (distance) != 0; };
+    size_t pos = 0;
+    while (pos < input.size())
+    {
+	size_t distance = 0;
+	unsigned count = finder.find (pos, accept, distance);
+	if (count)
+	{
+	    const auto& o = *codes.offset (distance);
+	    const auto& c = codes.count (count);
+	    out.put_bits (2, 2);
+	    out.put_byte (o.byte);
+	    out.put_bits (o.bits, o.length);
+	    out.put_bits (c.bits, c.length);
+	    if (count >= 17)
+		out.put_byte (static_cast<uint8_t> (count - 17));
+	}
+	else if ((distance = finder.find_pair (pos)) >= 2 && distance <= std::min<size_t> (pos, 0x800))
+	{
+	    count = 2;
+	    out.put_bits (0, 2);
+	    if (distance <= 0x100)
+	    {
+		out.put_byte (static_cast<uint8_t> (0x100 - distance));
+		out.put_bit (0);
+	    }
+	    else
+	    {
+		size_t extra = (distance - 0x101) & ~0xFFu;
+		out.put_byte (static_cast<uint8_t> (0x200 + extra - distance));
+		out.put_bit (1);
+		out.put_bit (!(extra & 0x400));
+		out.put_bit (!(extra & 0x200));
+		out.put_bit (!(extra & 0x100));
+	    }
+	}
+	else
+	{
+	    out.put_bit (1);
+	    out.put_byte (input[pos]);
+	    finder.insert (pos++);
+	    continue;
+	}
+	for (unsigned i = 0; i < count; ++i)
+	    finder.insert (pos++);
+    }
+    return std::move (out.data());
+}
+
+size_t ike_decode (const byte_vector& packed, byte_vector& output)
+{
+    return bin::ike_decompress (packed.data(), packed.size(), output.data(), output.size());
+}
+
+// --- Huffman (vns/exesd.cc) ------------------------------------------------
+
+// packed stream is ESD file as described in vns/esd.h, records for all 256
+// leaves come first, followed by internal nodes.
+
+byte_vector huffman_encode (const byte_vector& input)
+{
+    std::vector<size_t> freq (256);
+    for (auto b : input)
+	++freq[b];
+    typedef std::pair<size_t, int> item;
+    std::priority_queue<item, std::vector<item>, std::greater<item>> queue;
+    for (int i = 0; i < 256; ++i)
+	queue.push (item (freq[i], i));
+    std::vector<int> child (2 * 512, -1);
+    int next_node = 256;
+    while (queue.size() > 1)
+    {
+	item a = queue.top(); queue.pop();
+	item b = queue.top(); queue.pop();
+	child[2 * next_node]     = a.second;
+	child[2 * next_node + 1] = b.second;
+	queue.push (item (a.first + b.first, next_node++));
+    }
+    int root = queue.top().second;
+
+    std::vector<uint32_t> code (256), length (256);
+    std::vector<std::pair<int, std::pair<uint32_t, uint32_t>>> stack;
+    stack.push_back (std::make_pair (root, std::make_pair (0u, 0u)));
+    while (!stack.empty())
+    {
+	int node = stack.back().first;
+	uint32_t bits = stack.back().second.first, n = stack.back().second.second;
+	stack.pop_back();
+	if (node < 256)
+	{
+	    if (n > 32)
+		throw std::runtime_error ("Huffman code is too long");
+	    code[node] = bits;
+	    length[node] = n;
+	    continue;
+	}
+	stack.push_back (std::make_pair (child[2 * node],     std::make_pair (bits << 1,     n + 1)));
+	stack.push_back (std::make_pair (child[2 * node + 1], std::make_pair (bits << 1 | 1, n + 1)));
+    }
+
+    byte_vector packed;
+    auto put32 = [&] (int32_t v) {
+	for (int i = 0; i < 4; ++i)
+	    packed.push_back (static_cast<uint8_t> (v >> i * 8));
+    };
+    put32 (0x5048);		// "HP\0\0"
+    put32 (0);
+    put32 (static_cast<int32_t> (input.size()));
+    put32 (root);
+    put32 (256);		// leaf records
+    put32 (static_cast<int32_t> (input.size()));
+    for (int node = 0; node < 256; ++node)
+    {
+	put32 (node);
+	put32 (-1);
+	put32 (-1);
+    }
+    for (int node = 256; node < next_node; ++node)
+    {
+	put32 (node);
+	put32 (child[2 * node]);
+	put32 (child[2 * node + 1]);
+    }
+    uint64_t acc = 0;
+    unsigned acc_bits = 0;
+    for (auto b : input)
+    {
+	acc = acc << length[b] | code[b];
+	acc_bits += length[b];
+	while (acc_bits >= 8)
+	{
+	    acc_bits -= 8;
+	    packed.push_back (static_cast<uint8_t> (acc >> acc_bits));
+	}
+    }
+    if (acc_bits)
+	packed.push_back (static_cast<uint8_t> (acc << (8 - acc_bits)));
+    return packed;
+}
+
+size_t huffman_decode (const byte_vector& packed, byte_vector& output)
+{
+    esd_decode (packed.data(), packed.size(), output);
+    return output.size();
+}
+
+// --- zlib (tools/unzlib.cc, vns/deenz.cc, ...) -----------------------------
+
+byte_vector zlib_encode (const byte_vector& input)
+{
+    uLongf size = compressBound (static_cast<uLong> (input.size()));
+    byte_vector packed (size);
+    if (Z_OK != compress2 (packed.data(), &size, input.data(), static_cast<uLong> (input.size()),
+			   Z_DEFAULT_COMPRESSION))
+	throw std::runtime_error ("zlib compression failed");
+    packed.resize (size);
+    return packed;
+}
+
+size_t zlib_decode (const byte_vector& packed, byte_vector& output)
+{
+    return zio::inflate_to (packed.data(), packed.size(), output.data(), output.size());
+}
+
+// --- measurement -----------------------------------------------------------
+
+struct codec
+{
+    const char*	name;
+    byte_vector	(*encode) (const byte_vector&);
+    size_t	(*decode) (const byte_vector&, byte_vector&);
+    size_t	max_size;	// largest input format can describe, 0 if unlimited
+};
+
+const codec codecs[] = {
+    { "lzss",    lzss_encode<classic_lzss>, lzss_decode<classic_lzss>, 0 },
+    { "bcs",     lzss_encode<bcs_lzss>,     lzss_decode<bcs_lzss>,     0 },
+    { "ps2",     lzss_encode<ps2_lzss>,     lzss_decode<ps2_lzss>,     0 },
+    { "advc",    lzss_encode<advc_lzss>,    lzss_decode<advc_lzss>,    0 },
+    { "prs",     prs_encode,                prs_decode,                0 },
+    { "ike",     ike_encode,                ike_decode,                0x3FFFFF },
+    { "huffman", huffman_encode,            huffman_decode,            0 },
+    { "zlib",    zlib_encode,               zlib_decode,               0 },
+};
+
+struct corpus
+{
+    const char*	name;
+    byte_vector	(*make) (size_t);
+};
+
+const corpus corpora[] = {
+    { "text",   make_text },
+    { "image",  make_image },
+    { "random", make_random },
+};
+
+uint64_t read_cycles ()
+{
+#if DECBENCH_RDTSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Returns: peak resident set size of the process in kilobytes.
+
+unsigned long peak_rss_kb ()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (::GetProcessMemoryInfo (::GetCurrentProcess(), &pmc, sizeof(pmc)))
+	return static_cast<unsigned long> (pmc.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (0 == ::getrusage (RUSAGE_SELF, &usage))
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+    return 0;
+}
+
+void run_codec (const codec& c, const corpus& corp, const byte_vector& input, int passes)
+{
+    byte_vector packed = c.encode (input);
+    byte_vector output (input.size());
+    // warm up and check round trip
+    size_t size = c.decode (packed, output);
+    if (size != input.size() || output != input)
+	throw std::runtime_error (std::string (c.name) + '/' + corp.name + ": round trip failed");
+
+    uint64_t cycles = read_cycles();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+	c.decode (packed, output);
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    cycles = read_cycles() - cycles;
+
+    const double total = double (input.size()) * passes;
+    char cpb[32] = "-";
+    if (DECBENCH_RDTSC)
+	std::snprintf (cpb, sizeof(cpb), "%.2f", cycles / total);
+    std::printf ("%-8s %-7s %9u %9u %9.1f %8s %9lu\n", c.name, corp.name,
+		 unsigned (input.size()), unsigned (packed.size()),
+		 total / (1024*1024) / t.count(), cpb, peak_rss_kb());
+    std::fflush (stdout);
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x100000;
+    if (!size)
+	size = 0x100000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 5;
+    if (passes <= 0)
+	passes = 1;
+    const char* only = argc > 3 ? argv[3] : 0;
+
+    std::printf ("%-8s %-7s %9s %9s %9s %8s %9s\n", "format", "corpus", "size", "packed",
+		 "mb_s", "cpb", "peak_kb");
+    for (const auto& corp : corpora)
+    {
+	byte_vector input = corp.make (size);
+	for (const auto& c : codecs)
+	{
+	    if (only && std::strcmp (only, c.name) != 0)
+		continue;
+	    if (c.max_size && input.size() > c.max_size)
+	    {
+		byte_vector part (input.begin(), input.begin() + c.max_size);
+		run_codec (c, corp, part, passes);
+	    }
+	    else
+		run_codec (c, corp, input, passes);
+	}
+    }
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "decbench: %s\n", X.what());
+    return 1;
+}
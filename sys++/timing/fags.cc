@@ -0,0 +1,222 @@
+// -*- C++ -*-
+//! \file       fags.cc
+//! \date       2026 Oct 16
+//! \brief      compare ways to apply bit pair permutation of vns/defags.cc.
+//
+// "loop" is the original 16-step permutation, "lut" translates every byte
+// through table selected by four control bits, since swapped pairs never
+// cross byte boundary, "delta" is a scalar delta swap and "simd" is what
+// defags does now.  all variants are checked against "loop" on random data,
+// seeds and sizes before timing.
+
+#include "../../vns/fags.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+// --- original, vns/defags.cc ----------------------------------------------
+
+void ref_decrypt (uint8_t* data, size_t size, uint32_t seed)
+{
+    size /= 4;
+    if (0 == size)
+	return;
+    uint16_t ctl[32];
+    uint32_t key[32];
+
+    for (int i = 0; i < 32; ++i)
+    {
+	uint32_t code = 0;
+	uint32_t k = seed;
+	for (int j = 0; j < 16; ++j)
+	{
+	    code = (k ^ (k >> 1)) << 15 | (code & 0xFFFF) >> 1;
+	    k >>= 2;
+	}
+	key[i] = seed;
+	ctl[i] = code;
+	seed = seed << 1 | seed >> 31;
+    }
+    uint32_t* data32 = reinterpret_cast<uint32_t*> (data);
+    for (size_t i = 0; i < size; ++i)
+    {
+	auto s = *data32;
+	auto code = ctl[i & 0x1F];
+	unsigned d = 0;
+	unsigned v3 = 3;
+	unsigned v2 = 2;
+	unsigned v1 = 1;
+	for (int j = 0; j < 16; ++j)
+	{
+	    if (0 != (code & 1))
+	    {
+		d |= (s & v1) << 1 | (s >> 1) & (v2 >> 1);
+	    }
+	    else
+	    {
+		d |= s & v3;
+	    }
+	    code >>= 1;
+	    v3 <<= 2;
+	    v2 <<= 2;
+	    v1 <<= 2;
+	}
+	*data32++ = d ^ key[i & 0x1F];
+    }
+}
+
+// masks of lower bits of swapped pairs and keys for 32 dword positions
+void make_tables (uint32_t seed, uint32_t* mask, uint32_t* key)
+{
+    for (int i = 0; i < 32; ++i)
+    {
+	uint32_t code = 0;
+	uint32_t k = seed;
+	for (int j = 0; j < 16; ++j)
+	{
+	    code = (k ^ (k >> 1)) << 15 | (code & 0xFFFF) >> 1;
+	    k >>= 2;
+	}
+	uint32_t m = 0;
+	for (int j = 0; j < 16; ++j)
+	    m |= (code >> j & 1) << 2*j;
+	key[i] = seed;
+	mask[i] = m;
+	seed = seed << 1 | seed >> 31;
+    }
+}
+
+// --- byte-sliced tables ---------------------------------------------------
+
+void lut_decrypt (uint8_t* data, size_t size, uint32_t seed)
+{
+    size /= 4;
+    uint32_t mask[32], key[32];
+    make_tables (seed, mask, key);
+    // byte permutation for every combination of four pair swaps
+    static uint8_t perm[16][256];
+    static bool perm_ready = false;
+    if (!perm_ready)
+    {
+	for (unsigned c = 0; c < 16; ++c)
+	{
+	    unsigned m = (c & 1) | (c & 2) << 1 | (c & 4) << 2 | (c & 8) << 3;
+	    for (unsigned x = 0; x < 256; ++x)
+	    {
+		unsigned t = (x ^ x >> 1) & m;
+		perm[c][x] = static_cast<uint8_t> (x ^ t ^ t << 1);
+	    }
+	}
+	perm_ready = true;
+    }
+    // control nibble of each byte of each of 32 positions
+    uint8_t nibble[32][4];
+    for (int i = 0; i < 32; ++i)
+	for (int b = 0; b < 4; ++b)
+	{
+	    unsigned m = mask[i] >> 8*b;
+	    nibble[i][b] = (m & 1) | (m >> 1 & 2) | (m >> 2 & 4) | (m >> 3 & 8);
+	}
+    const uint8_t* key8 = reinterpret_cast<const uint8_t*> (key);
+    for (size_t i = 0; i < size; ++i)
+    {
+	const uint8_t* n = nibble[i & 0x1F];
+	const uint8_t* k = key8 + (i & 0x1F) * 4;
+	uint8_t* p = data + i * 4;
+	p[0] = perm[n[0]][p[0]] ^ k[0];
+	p[1] = perm[n[1]][p[1]] ^ k[1];
+	p[2] = perm[n[2]][p[2]] ^ k[2];
+	p[3] = perm[n[3]][p[3]] ^ k[3];
+    }
+}
+
+// --- scalar delta swap ----------------------------------------------------
+
+void delta_decrypt (uint8_t* data, size_t size, uint32_t seed)
+{
+    size /= 4;
+    uint32_t mask[32], key[32];
+    make_tables (seed, mask, key);
+    for (size_t i = 0; i < size; ++i)
+    {
+	uint32_t s;
+	std::memcpy (&s, data + i * 4, 4);
+	uint32_t t = (s ^ s >> 1) & mask[i & 0x1F];
+	s ^= t ^ t << 1 ^ key[i & 0x1F];
+	std::memcpy (data + i * 4, &s, 4);
+    }
+}
+
+typedef void (*decrypt_func) (uint8_t*, size_t, uint32_t);
+
+struct variant
+{
+    const char*		name;
+    decrypt_func	func;
+};
+
+const variant variants[] = {
+    { "loop",	ref_decrypt },
+    { "lut",	lut_decrypt },
+    { "delta",	delta_decrypt },
+    { "simd",	fags_decrypt },
+};
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x1000000;
+    if (!size)
+	size = 0x1000000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 10;
+    if (passes <= 0)
+	passes = 1;
+
+    std::srand (1);
+    byte_vector input (size);
+    for (auto& b : input)
+	b = std::rand();
+
+    for (int trial = 0; trial < 2000; ++trial)
+    {
+	size_t n = std::rand() % 1000;
+	uint32_t seed = std::rand() ^ uint32_t (std::rand()) << 16;
+	byte_vector expected (input.begin(), input.begin() + n);
+	ref_decrypt (expected.data(), n, seed);
+	for (const auto& v : variants)
+	{
+	    byte_vector data (input.begin(), input.begin() + n);
+	    v.func (data.data(), n, seed);
+	    if (data != expected)
+		throw std::runtime_error (std::string (v.name) + " output mismatch");
+	}
+    }
+
+    std::printf ("%u bytes, %d passes\n", unsigned (size), passes);
+    std::printf ("%-8s %10s\n", "method", "MB/s");
+    byte_vector data (input);
+    for (const auto& v : variants)
+    {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < passes; ++i)
+	    v.func (data.data(), size, 0x12345678 + i);
+	std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+	std::printf ("%-8s %10.1f\n", v.name, double (size) * passes / (1024*1024) / t.count());
+    }
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "fags: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,240 @@
+// -*- C++ -*-
+//! \file       fused.cc
+//! \date       2026 Oct 16
+//! \brief      compare decrypting input in place before LZSS decoding against
+//              decrypting it in chunks as decoder reads it.
+//
+// "inplace" is what scwextract, deary and deps2 did: copy-on-write mapping
+// decrypted as a whole, then decoded.  "fused" maps the file read-only and
+// passes cipher to lzss_decompress.  private_kb is the growth of private
+// memory while the view is mapped, which includes copied pages.
+
+#include "lzssenc.h"
+#include "lzssvar.h"
+#include "sysmemmap.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+// --- ciphers used by the tools ---------------------------------------------
+
+struct scw_cipher		// vns/scwextract.cc
+{
+    static const char* name () { return "scw"; }
+    void operator() (uint8_t* data, size_t size, size_t offset) const
+	{
+	    for (size_t i = 0; i < size; ++i)
+		data[i] ^= offset + i;
+	}
+    void encrypt (uint8_t* data, size_t size) const { (*this) (data, size, 0); }
+};
+
+struct ary_cipher		// vns/deary.cc
+{
+    static const char* name () { return "ary"; }
+    void operator() (uint8_t* data, size_t size, size_t) const
+	{
+	    for (size_t i = 0; i < size; ++i)
+		data[i] ^= 0x7C;
+	}
+    void encrypt (uint8_t* data, size_t size) const { (*this) (data, size, 0); }
+};
+
+struct ps2_cipher		// vns/deps2.cc
+{
+    static const char* name () { return "ps2"; }
+    SYSPP_static_constexpr unsigned key = 0x5A;
+    SYSPP_static_constexpr int shift = 3;
+
+    void operator() (uint8_t* data, size_t size, size_t) const
+	{
+	    for (size_t i = 0; i < size; ++i)
+	    {
+		uint8_t x = static_cast<uint8_t> (key ^ (data[i] - 0x7Cu));
+		data[i] = static_cast<uint8_t> (x >> shift | x << (8 - shift));
+	    }
+	}
+    void encrypt (uint8_t* data, size_t size) const
+	{
+	    for (size_t i = 0; i < size; ++i)
+	    {
+		uint8_t x = static_cast<uint8_t> (data[i] << shift | data[i] >> (8 - shift));
+		data[i] = static_cast<uint8_t> ((x ^ key) + 0x7C);
+	    }
+	}
+};
+
+// --- measurement -----------------------------------------------------------
+
+// Returns: private memory of the process in kilobytes.
+
+unsigned long private_kb ()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (::GetProcessMemoryInfo (::GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*> (&pmc), sizeof(pmc)))
+	return static_cast<unsigned long> (pmc.PrivateUsage / 1024);
+#else
+    unsigned long size, resident, shared;
+    if (std::FILE* statm = std::fopen ("/proc/self/statm", "r"))
+    {
+	int n = std::fscanf (statm, "%lu %lu %lu", &size, &resident, &shared);
+	std::fclose (statm);
+	if (3 == n)
+	    return (resident - shared) * (::sysconf (_SC_PAGESIZE) / 1024);
+    }
+#endif
+    return 0;
+}
+
+unsigned long minor_faults ()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (::GetProcessMemoryInfo (::GetCurrentProcess(), &pmc, sizeof(pmc)))
+	return pmc.PageFaultCount;
+#else
+    struct rusage usage;
+    if (0 == ::getrusage (RUSAGE_SELF, &usage))
+	return usage.ru_minflt;
+#endif
+    return 0;
+}
+
+struct result
+{
+    double		seconds;
+    unsigned long	faults;
+    unsigned long	private_kb;
+};
+
+// run (DECODE, EXPECTED, PASSES)
+// DECODE (OUTPUT, PROBE) maps the file and decodes it into OUTPUT, then calls
+// PROBE while the view is still mapped.
+
+template <class Decode>
+result run (Decode decode, const byte_vector& expected, int passes)
+{
+    result r = { 0, 0, 0 };
+    byte_vector output (expected.size());
+    for (int i = 0; i < passes; ++i)
+    {
+	unsigned long faults = minor_faults(), mem = private_kb();
+	auto start = std::chrono::steady_clock::now();
+	decode (output, [&] {
+	    unsigned long now = private_kb();
+	    r.private_kb = std::max (r.private_kb, now > mem ? now - mem : 0);
+	});
+	std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+	r.seconds += t.count();
+	r.faults += minor_faults() - faults;
+	if (output != expected)
+	    throw std::runtime_error ("output mismatch");
+    }
+    r.faults /= passes;
+    return r;
+}
+
+byte_vector make_text (size_t size)
+{
+    static const char* const words[] = {
+	"the", "of", "and", "to", "in", "is", "you", "that", "it", "he",
+	"was", "for", "on", "are", "as", "with", "his", "they", "at", "be",
+    };
+    byte_vector text;
+    text.reserve (size + 16);
+    std::srand (1);
+    while (text.size() < size)
+    {
+	text.push_back (0x10 + std::rand() % 8);
+	for (int i = 3 + std::rand() % 12; i > 0; --i)
+	{
+	    const char* word = words[std::rand() % 20];
+	    text.insert (text.end(), word, word + std::strlen (word));
+	    text.push_back (' ');
+	}
+	text.back() = 0;
+    }
+    text.resize (size);
+    return text;
+}
+
+template <class Params, class Cipher>
+void compare (const char* filename, const byte_vector& plain, int passes)
+{
+    const Cipher cipher = Cipher();
+    {
+	bin::lzss_encoder<Params> lzss;
+	byte_vector packed;
+	lzss.encode (plain.data(), plain.size(), packed);
+	cipher.encrypt (packed.data(), packed.size());
+	std::ofstream file (filename, std::ios::out|std::ios::binary|std::ios::trunc);
+	file.write (reinterpret_cast<const char*> (packed.data()), packed.size());
+	if (!file)
+	    throw std::runtime_error ("error writing temporary file");
+    }
+    auto inplace = run ([&] (byte_vector& output, std::function<void()> probe) {
+	sys::mapping::readwrite in (filename, sys::mapping::writecopy);
+	sys::mapping::view<uint8_t> view (in);
+	cipher (view.data(), view.size(), 0);
+	bin::lzss_decompress<Params> (view.data(), view.size(), output.data(), output.size());
+	probe();
+    }, plain, passes);
+    auto fused = run ([&] (byte_vector& output, std::function<void()> probe) {
+	sys::mapping::readonly in (filename);
+	sys::mapping::const_view<uint8_t> view (in);
+	bin::lzss_decompress<Params> (view.data(), view.size(), output.data(), output.size(), cipher);
+	probe();
+    }, plain, passes);
+
+    const double mb = double (plain.size()) * passes / (1024*1024);
+    std::printf ("%-6s %-8s %10.1f %10lu %10lu\n", Cipher::name(), "inplace",
+		 mb / inplace.seconds, inplace.faults, inplace.private_kb);
+    std::printf ("%-6s %-8s %10.1f %10lu %10lu\n", Cipher::name(), "fused",
+		 mb / fused.seconds, fused.faults, fused.private_kb);
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    const char* filename = argc > 1 ? argv[1] : "fused.tmp";
+    size_t size = argc > 2 ? std::strtoul (argv[2], 0, 0) : 0x1000000;
+    if (!size)
+	size = 0x1000000;
+    int passes = argc > 3 ? std::atoi (argv[3]) : 5;
+    if (passes <= 0)
+	passes = 1;
+
+    const byte_vector plain = make_text (size);
+    std::printf ("%u bytes, %d passes, scratch file %s\n", unsigned (size), passes, filename);
+    std::printf ("%-6s %-8s %10s %10s %10s\n", "tool", "method", "MB/s", "faults", "private_kb");
+    compare<bin::lzss_params<>, scw_cipher> (filename, plain, passes);
+    compare<bin::lzss_params<>, ary_cipher> (filename, plain, passes);
+    compare<bin::ps2_lzss, ps2_cipher> (filename, plain, passes);
+    std::remove (filename);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "fused: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,277 @@
+// -*- C++ -*-
+//! \file       huffman.cc
+//! \date       2026 Oct 16
+//! \brief      compare huffman_table against bit-at-a-time tree walk used by
+//              exesd, and measure symbols per second.
+//
+// trees are stored the way exesd keeps them: 6 ints per node, children at
+// offsets 1 and 2, leaves marked with -1.  randomized trials check that both
+// decoders produce the same symbols and fail at the same point on truncated
+// input.
+
+#include "huffman.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+struct code_tree
+{
+    std::vector<int>		nodes;	// exesd layout
+    int				root;
+    std::vector<unsigned>	code;	// code of each symbol, first bit is the lowest
+    std::vector<unsigned>	length;
+};
+
+enum distribution { uniform, text, skewed };
+
+// make_tree (DIST)
+// builds Huffman tree for 256 symbols with frequencies of given distribution.
+// skewed distribution gives codes up to ~30 bits long.
+
+code_tree make_tree (distribution dist)
+{
+    std::vector<double> freq (256);
+    for (int i = 0; i < 256; ++i)
+    {
+        switch (dist)
+        {
+        case uniform: freq[i] = 1 + std::rand() % 4; break;
+        case text:    freq[i] = 1 + 10000.0 / (1 + std::rand() % 256); break;
+        case skewed:  freq[i] = i < 32 ? double (1u << (31 - i)) : 1; break;
+        }
+    }
+    typedef std::pair<double, int> item;
+    std::priority_queue<item, std::vector<item>, std::greater<item>> queue;
+    code_tree tree;
+    tree.nodes.assign (0xC00, 0);
+    for (int i = 0; i < 256; ++i)
+    {
+        tree.nodes[6 * i + 1] = -1;
+        queue.push (item (freq[i], i));
+    }
+    int next_node = 256;
+    while (queue.size() > 1)
+    {
+        item a = queue.top(); queue.pop();
+        item b = queue.top(); queue.pop();
+        int node = next_node++;
+        tree.nodes[6 * node + 1] = a.second;
+        tree.nodes[6 * node + 2] = b.second;
+        queue.push (item (a.first + b.first, node));
+    }
+    tree.root = queue.top().second;
+
+    tree.code.assign (256, 0);
+    tree.length.assign (256, 0);
+    std::vector<std::pair<int, std::pair<unsigned, unsigned>>> stack;
+    stack.push_back (std::make_pair (tree.root, std::make_pair (0u, 0u)));
+    while (!stack.empty())
+    {
+        int node = stack.back().first;
+        unsigned code = stack.back().second.first, length = stack.back().second.second;
+        stack.pop_back();
+        if (-1 == tree.nodes[6 * node + 1])
+        {
+            tree.code[node] = code;
+            tree.length[node] = length;
+            continue;
+        }
+        stack.push_back (std::make_pair (tree.nodes[6 * node + 1], std::make_pair (code, length + 1)));
+        stack.push_back (std::make_pair (tree.nodes[6 * node + 2], std::make_pair (code | 1u << length, length + 1)));
+    }
+    return tree;
+}
+
+template <class Order>
+class bit_writer
+{
+public:
+    void put (unsigned bit)
+        {
+            if (!m_count)
+                m_data.push_back (0);
+            if (bit)
+                m_data.back() |= mask (Order());
+            m_count = (m_count + 1) & 7;
+        }
+    byte_vector& data () { return m_data; }
+
+private:
+    uint8_t mask (bin::msb_first) const { return 0x80 >> m_count; }
+    uint8_t mask (bin::lsb_first) const { return 1 << m_count; }
+
+    byte_vector	m_data;
+    unsigned	m_count = 0;
+};
+
+template <class Order>
+byte_vector encode (const code_tree& tree, const byte_vector& input)
+{
+    bit_writer<Order> out;
+    for (auto symbol : input)
+    {
+        unsigned code = tree.code[symbol];
+        for (unsigned i = 0; i < tree.length[symbol]; ++i)
+            out.put (code >> i & 1);
+    }
+    return std::move (out.data());
+}
+
+byte_vector make_input (const code_tree& tree, size_t count)
+{
+    // pick symbols so that short codes are more frequent
+    byte_vector input (count);
+    for (auto& symbol : input)
+    {
+        do
+            symbol = std::rand() & 0xFF;
+        while (tree.length[symbol] > 8 && std::rand() % (1 << std::min (tree.length[symbol] - 8, 16u)));
+    }
+    return input;
+}
+
+// reference decoder, loop from exesd.  returns number of symbols decoded
+// before input was exhausted.
+
+template <class Order>
+size_t ref_decode (const code_tree& tree, const byte_vector& packed, uint8_t* output, size_t count)
+{
+    const std::vector<int>& tree_nodes = tree.nodes;
+    bin::bit_reader<Order> bits (packed.data(), packed.data() + packed.size());
+    size_t i = 0;
+    try
+    {
+        for (; i < count; ++i)
+        {
+            int symbol = tree.root;
+            do
+            {
+                int node = bits.get_bit() + 6 * symbol;
+                symbol = tree_nodes[node + 1];
+            }
+            while (tree_nodes[6 * symbol + 1] != -1);
+            output[i] = symbol;
+        }
+    }
+    catch (std::runtime_error&) { }
+    return i;
+}
+
+template <class Order>
+void build_table (bin::huffman_table<Order>& table, const code_tree& tree)
+{
+    const std::vector<int>& tree_nodes = tree.nodes;
+    table.build (tree.root, tree_nodes.size() / 6,
+                 [&] (int node, int bit) { return tree_nodes[6 * node + 1 + bit]; },
+                 [&] (int node) { return -1 == tree_nodes[6 * node + 1]; });
+}
+
+template <class Order>
+size_t table_decode (const bin::huffman_table<Order>& table, const byte_vector& packed,
+                     uint8_t* output, size_t count)
+{
+    bin::bit_reader<Order> bits (packed.data(), packed.data() + packed.size());
+    size_t i = 0;
+    try
+    {
+        for (; i < count; ++i)
+            output[i] = table.decode (bits);
+    }
+    catch (std::runtime_error&) { }
+    return i;
+}
+
+template <class Order>
+void run_trials (int trials)
+{
+    for (int n = 0; n < trials; ++n)
+    {
+        code_tree tree = make_tree (distribution (n % 3));
+        byte_vector input = make_input (tree, 1 + std::rand() % 5000);
+        byte_vector packed = encode<Order> (tree, input);
+        // every other trial cuts the stream at random point
+        if (n & 1)
+            packed.resize (std::rand() % (packed.size() + 1));
+        bin::huffman_table<Order> table;
+        build_table (table, tree);
+        byte_vector out1 (input.size()), out2 (input.size());
+        size_t count1 = ref_decode<Order> (tree, packed, out1.data(), out1.size());
+        size_t count2 = table_decode (table, packed, out2.data(), out2.size());
+        if (count1 != count2 || out1 != out2)
+            throw std::runtime_error ("decoders mismatch");
+        if (!(n & 1) && (count1 != input.size() || out1 != input))
+            throw std::runtime_error ("decoded data mismatch");
+    }
+}
+
+template <class Func>
+double run (Func decode, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+        decode();
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+void run_speed (const char* name, distribution dist, size_t count, int passes)
+{
+    code_tree tree = make_tree (dist);
+    byte_vector input = make_input (tree, count);
+    byte_vector packed = encode<bin::msb_first> (tree, input);
+    byte_vector output (count);
+
+    double t_ref = run ([&] { ref_decode<bin::msb_first> (tree, packed, output.data(), count); }, passes);
+    if (output != input)
+        throw std::runtime_error ("reference output mismatch");
+    std::fill (output.begin(), output.end(), 0);
+    bin::huffman_table<bin::msb_first> table;
+    build_table (table, tree);
+    double t_table = run ([&] { table_decode (table, packed, output.data(), count); }, passes);
+    if (output != input)
+        throw std::runtime_error ("table output mismatch");
+
+    const double msym = double (count) * passes / 1e6;
+    std::printf ("%-8s %6.2f %6u %12.1f %12.1f %8.2f\n", name,
+                 double (packed.size()) * 8 / count, table.max_length(),
+                 msym / t_ref, msym / t_table, t_ref / t_table);
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t count = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x1000000;
+    if (!count)
+        count = 0x1000000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 3;
+    if (passes <= 0)
+        passes = 1;
+    int trials = argc > 3 ? std::atoi (argv[3]) : 300;
+
+    std::srand (1);
+    run_trials<bin::msb_first> (trials);
+    run_trials<bin::lsb_first> (trials);
+    std::printf ("%d randomized trials passed for each bit order\n", trials);
+
+    std::printf ("%u symbols, %d passes\n", unsigned (count), passes);
+    std::printf ("%-8s %6s %6s %12s %12s %8s\n", "tree", "bits", "max", "walk Msym/s", "table Msym/s", "speedup");
+    run_speed ("uniform", uniform, count, passes);
+    run_speed ("text", text, count, passes);
+    run_speed ("skewed", skewed, count, passes);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "huffman: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,410 @@
+// -*- C++ -*-
+//! \file       ike.cc
+//! \date       2026 Oct 16
+//! \brief      compare ike_decompress against bit-at-a-time decoder it replaced.
+//
+// input is produced by a random token generator that lays out control words
+// and bytes in the order decoder reads them.
+
+#include "ikedec.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+// --- reference decoder, from deike.cc --------------------------------------
+
+class bit_stream
+{
+    const uint8_t*  m_src;
+    const uint8_t*  const m_end;
+    int             m_bits;
+
+public:
+    bit_stream (const uint8_t* input, size_t size)
+        : m_src (input), m_end (input + size), m_bits (2)
+    {
+    }
+
+    uint8_t read_byte ()
+    {
+        if (m_src == m_end)
+            throw std::runtime_error ("end of stream");
+        return *m_src++;
+    }
+
+    uint8_t get_bit ()
+    {
+        int bit = m_bits & 1;
+        m_bits >>= 1;
+        if (1 == m_bits)
+        {
+            if (m_src+2 > m_end)
+                throw std::runtime_error ("end of stream");
+            m_bits = m_src[0] | m_src[1] << 8 | 0x10000;
+            m_src += 2;
+        }
+        return bit;
+    }
+};
+
+size_t ref_decompress (const uint8_t* input, size_t input_size, uint8_t* output)
+{
+    size_t unpacked_size = bin::ike_unpacked_size (input);
+    bit_stream bits (input+13, input_size-13);
+    bits.get_bit();
+    size_t dst = 0;
+    while (dst < unpacked_size)
+    {
+        int offset, shift, count;
+        if (bits.get_bit() != 0)
+        {
+            output[dst++] = bits.read_byte();
+            continue;
+        }
+        if (bits.get_bit() != 0)
+        {
+            offset = bits.read_byte() | -0x100;
+            shift = 0;
+            if (bits.get_bit() == 0)
+                shift += 0x100;
+            if (bits.get_bit() == 0)
+            {
+                offset -= 0x200;
+                if (bits.get_bit() == 0)
+                {
+                    shift <<= 1;
+                    if (bits.get_bit() == 0)
+                        shift += 0x100;
+                    offset -= 0x200;
+                    if (bits.get_bit() == 0)
+                    {
+                        shift <<= 1;
+                        if (bits.get_bit() == 0)
+                            shift += 0x100;
+                        offset -= 0x400;
+                        if (bits.get_bit() == 0)
+                        {
+                            offset -= 0x800;
+                            shift <<= 1;
+                            if (bits.get_bit() == 0)
+                                shift += 0x100;
+                        }
+                    }
+                }
+            }
+            offset -= shift;
+            if (bits.get_bit() != 0)
+                count = 3;
+            else if (bits.get_bit() != 0)
+                count = 4;
+            else if (bits.get_bit() != 0)
+                count = 5;
+            else if (bits.get_bit() != 0)
+                count = 6;
+            else if (bits.get_bit() != 0)
+            {
+                if (bits.get_bit() != 0)
+                    count = 8;
+                else
+                    count = 7;
+            }
+            else if (bits.get_bit() != 0)
+                count = bits.read_byte() + 17;
+            else
+            {
+                count = 9;
+                if (bits.get_bit() != 0)
+                    count = 13;
+                if (bits.get_bit() != 0)
+                    count += 2;
+                if (bits.get_bit() != 0)
+                    count++;
+            }
+        }
+        else
+        {
+            offset = bits.read_byte() | -0x100;
+            if (bits.get_bit() != 0)
+            {
+                offset -= 0x100;
+                if (bits.get_bit() == 0)
+                    offset -= 0x400;
+                if (bits.get_bit() == 0)
+                    offset -= 0x200;
+                if (bits.get_bit() == 0)
+                    offset -= 0x100;
+            }
+            else if (offset == -1)
+            {
+                if (bits.get_bit() == 0)
+                    break;
+                else
+                    continue;
+            }
+            count = 2;
+        }
+        for (int i = 0; i < count; ++i)
+            output[dst+i] = output[dst+offset+i];
+        dst += count;
+    }
+    return dst;
+}
+
+// --- generator -------------------------------------------------------------
+
+// ike_writer
+// mirrors bit_stream: the next control word is reserved right after the last
+// bit of the current one is written.
+
+class ike_writer
+{
+public:
+    explicit ike_writer (size_t unpacked_size)
+        : m_data (13), m_count (0)
+        {
+            m_data[2] = 'i'; m_data[3] = 'k'; m_data[4] = 'e';
+            m_data[10] = static_cast<uint8_t> (unpacked_size >> 16 << 2);
+            m_data[11] = static_cast<uint8_t> (unpacked_size);
+            m_data[12] = static_cast<uint8_t> (unpacked_size >> 8);
+            reserve_word();
+        }
+
+    void put_bit (unsigned bit)
+        {
+            if (bit)
+                m_data[m_word + m_count / 8] |= 1 << (m_count & 7);
+            if (16 == ++m_count)
+                reserve_word();
+        }
+    void put_byte (uint8_t byte) { m_data.push_back (byte); }
+
+    byte_vector& data () { return m_data; }
+
+private:
+    void reserve_word ()
+        {
+            m_word = m_data.size();
+            m_data.resize (m_word + 2);
+            m_count = 0;
+        }
+
+    byte_vector	m_data;
+    size_t	m_word;
+    unsigned	m_count;
+};
+
+// random bit source that records every bit it gives out, so that prefix
+// codes can be generated by running decoder logic on random bits.
+
+struct random_bits
+{
+    std::vector<unsigned> used;
+    unsigned operator() () { used.push_back (std::rand() & 1); return used.back(); }
+};
+
+int long_offset (random_bits& bit, unsigned byte)
+{
+    int offset = byte | -0x100, shift = 0;
+    if (bit() == 0)
+        shift += 0x100;
+    if (bit() == 0)
+    {
+        offset -= 0x200;
+        if (bit() == 0)
+        {
+            shift <<= 1;
+            if (bit() == 0)
+                shift += 0x100;
+            offset -= 0x200;
+            if (bit() == 0)
+            {
+                shift <<= 1;
+                if (bit() == 0)
+                    shift += 0x100;
+                offset -= 0x400;
+                if (bit() == 0)
+                {
+                    offset -= 0x800;
+                    shift <<= 1;
+                    if (bit() == 0)
+                        shift += 0x100;
+                }
+            }
+        }
+    }
+    return offset - shift;
+}
+
+byte_vector make_stream (size_t unpacked_size, int literal_ratio)
+{
+    ike_writer out (unpacked_size);
+    size_t dst = 0;
+    while (dst < unpacked_size)
+    {
+        size_t left = unpacked_size - dst;
+        int kind = std::rand() % 100;
+        if (kind < literal_ratio || dst < 16 || left < 3)
+        {
+            out.put_bit (1);
+            out.put_byte (0x20 + std::rand() % 64);
+            ++dst;
+            continue;
+        }
+        unsigned byte = std::rand() & 0xFF;
+        random_bits bit;
+        if (kind & 1)
+        {
+            // long match: offset prefix, then count prefix
+            int offset = long_offset (bit, byte);
+            unsigned count;
+            unsigned length_byte = 0;
+            unsigned form = std::rand() % 8;
+            if (form < 4)
+            {
+                for (unsigned i = 0; i < form; ++i)
+                    bit.used.push_back (0);
+                bit.used.push_back (1);
+                count = 3 + form;
+            }
+            else if (4 == form)
+            {
+                unsigned b = std::rand() & 1;
+                bit.used.insert (bit.used.end(), { 0, 0, 0, 0, 1, b });
+                count = 7 + b;
+            }
+            else if (5 == form)
+            {
+                length_byte = std::rand() & 0xFF;
+                bit.used.insert (bit.used.end(), { 0, 0, 0, 0, 0, 1 });
+                count = length_byte + 17;
+            }
+            else
+            {
+                unsigned b1 = std::rand() & 1, b2 = std::rand() & 1, b3 = std::rand() & 1;
+                bit.used.insert (bit.used.end(), { 0, 0, 0, 0, 0, 0, b1, b2, b3 });
+                count = (b1 ? 13 : 9) + b2 * 2 + b3;
+            }
+            if (size_t (-offset) > dst || count > left)
+                continue;
+            out.put_bit (0);
+            out.put_bit (1);
+            out.put_byte (byte);
+            for (size_t i = 0; i < bit.used.size(); ++i)
+            {
+                out.put_bit (bit.used[i]);
+                if (5 == form && i + 1 == bit.used.size())
+                    out.put_byte (length_byte);
+            }
+            dst += count;
+        }
+        else
+        {
+            // short match
+            int offset = byte | -0x100;
+            unsigned far = std::rand() & 1;
+            unsigned b1 = std::rand() & 1, b2 = std::rand() & 1, b3 = std::rand() & 1;
+            if (far)
+                offset -= 0x100 + (b1 ? 0 : 0x400) + (b2 ? 0 : 0x200) + (b3 ? 0 : 0x100);
+            else if (-1 == offset)
+            {
+                // no-op token
+                out.put_bit (0);
+                out.put_bit (0);
+                out.put_byte (byte);
+                out.put_bit (0);
+                out.put_bit (1);
+                continue;
+            }
+            if (size_t (-offset) > dst)
+                continue;
+            out.put_bit (0);
+            out.put_bit (0);
+            out.put_byte (byte);
+            out.put_bit (far);
+            if (far)
+            {
+                out.put_bit (b1);
+                out.put_bit (b2);
+                out.put_bit (b3);
+            }
+            dst += 2;
+        }
+    }
+    return std::move (out.data());
+}
+
+template <class Func>
+double run (Func decode, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+        decode();
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+// check (PACKED, UNPACKED_SIZE)
+// runs both decoders, including on truncated input, and compares results.
+
+void check (const byte_vector& packed, size_t unpacked_size)
+{
+    byte_vector out1 (unpacked_size + 0x200), out2 (unpacked_size);
+    bool fail1 = false, fail2 = false;
+    size_t size1 = 0, size2 = 0;
+    try { size1 = ref_decompress (packed.data(), packed.size(), out1.data()); }
+    catch (std::runtime_error&) { fail1 = true; }
+    try { size2 = bin::ike_decompress (packed.data(), packed.size(), out2.data(), out2.size()); }
+    catch (std::runtime_error&) { fail2 = true; }
+    if (fail1 != fail2 || (!fail1 && (size1 != size2 || !std::equal (out2.begin(), out2.end(), out1.begin()))))
+        throw std::runtime_error ("decoders mismatch");
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x200000;
+    if (!size || size > 0x3FFFFF)
+        size = 0x200000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 10;
+    if (passes <= 0)
+        passes = 1;
+
+    std::srand (1);
+    for (int n = 0; n < 500; ++n)
+    {
+        size_t unpacked_size = 1 + std::rand() % 3000;
+        byte_vector packed = make_stream (unpacked_size, n % 90);
+        check (packed, unpacked_size);
+        packed.resize (13 + std::rand() % (packed.size() - 12));
+        check (packed, unpacked_size);
+    }
+    std::puts ("randomized trials passed");
+
+    std::printf ("%u bytes, %d passes\n", unsigned (size), passes);
+    std::printf ("%-10s %10s %10s %8s\n", "literals", "bit MB/s", "table MB/s", "speedup");
+    for (int ratio : { 10, 40, 80 })
+    {
+        byte_vector packed = make_stream (size, ratio);
+        byte_vector out1 (size + 0x200), out2 (size);
+        double t_ref = run ([&] { ref_decompress (packed.data(), packed.size(), out1.data()); }, passes);
+        double t_new = run ([&] { bin::ike_decompress (packed.data(), packed.size(), out2.data(), out2.size()); }, passes);
+        if (!std::equal (out2.begin(), out2.end(), out1.begin()))
+            throw std::runtime_error ("output mismatch");
+        const double mb = double (size) * passes / (1024*1024);
+        std::printf ("%8d%% %10.1f %10.1f %8.2f\n", ratio, mb / t_ref, mb / t_new, t_ref / t_new);
+    }
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "ike: %s\n", X.what());
+    return 1;
+}
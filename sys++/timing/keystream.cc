@@ -0,0 +1,134 @@
+// -*- C++ -*-
+//! \file       keystream.cc
+//! \date       2026 Oct 16
+//! \brief      scaling of position-keyed decryption (vns/degss, vns/deags32i)
+//              with number of threads.
+//
+// every thread count is compared against the single-threaded loop of the
+// original tool, byte for byte, and against memcpy of the same size as the
+// memory bandwidth bound.
+
+#include "parallel.h"
+#include "../../vns/agsikey.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+const uint32_t agsi_key = 0x20041001;
+
+// --- reference loop, vns/deags32i.cc --------------------------------------
+// rotation by zero is spelled out, the tool relied on x86 masking shift count
+
+inline unsigned rotL (unsigned v, int count)
+{
+    count &= 0x1F;
+    return count ? v << count | v >> (32-count) : v;
+}
+
+void ref_decrypt (uint8_t* data, size_t size, uint32_t key)
+{
+    for (size_t i = 0; i < size; i += 4)
+    {
+	int rem = (i >> 2) % 31;
+	int div = (i >> 2) / 31;
+	unsigned t = rotL (key + div, rem);
+	size_t chunk = std::min<size_t> (4u, size-i);
+	for (size_t j = 0; j < chunk; ++j)
+	    data[i+j] ^= t >> (j << 3);
+    }
+}
+
+void parallel_decrypt (const uint8_t* src, uint8_t* dst, size_t size, unsigned threads)
+{
+    sys::parallel (size, threads, 0x100000, [=] (size_t pos, size_t count) {
+	rotl_keystream (src + pos, dst + pos, count, pos, agsi_key);
+    });
+}
+
+template <class Func>
+double run (Func func, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+	func();
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x4000000;
+    if (!size)
+	size = 0x4000000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 5;
+    if (passes <= 0)
+	passes = 1;
+    unsigned max_threads = argc > 3 ? std::atoi (argv[3]) : 0;
+    if (!max_threads)
+	max_threads = std::max (1u, std::thread::hardware_concurrency());
+
+    byte_vector input (size), expected, output (size);
+    std::srand (1);
+    for (auto& b : input)
+	b = std::rand() & 0xFF;
+
+    // odd sizes and chunk offsets, including incomplete last dword
+    for (size_t n = 1; n < 2000; n += 7)
+    {
+	byte_vector part (input.begin(), input.begin() + std::min (n * 37, size));
+	byte_vector ref (part);
+	ref_decrypt (ref.data(), ref.size(), agsi_key);
+	for (unsigned threads = 1; threads <= 3; ++threads)
+	{
+	    byte_vector out (part.size());
+	    sys::parallel (part.size(), threads, 4 * (1 + n % 64), [&] (size_t pos, size_t count) {
+		rotl_keystream (part.data() + pos, out.data() + pos, count, pos, agsi_key);
+	    });
+	    if (out != ref)
+		throw std::runtime_error ("chunked output mismatch");
+	}
+    }
+
+    double t_ref = run ([&] {
+	std::memcpy (output.data(), input.data(), size);
+	ref_decrypt (output.data(), size, agsi_key);
+    }, passes);
+    expected = output;
+    double t_copy = run ([&] { std::memcpy (output.data(), input.data(), size); }, passes);
+
+    const double gb = double (size) * passes / (1024*1024*1024);
+    std::printf ("%u bytes, %d passes, %u CPUs\n", unsigned (size), passes,
+		 std::thread::hardware_concurrency());
+    std::printf ("%-10s %8s %8s\n", "method", "threads", "GB/s");
+    std::printf ("%-10s %8u %8.2f\n", "memcpy", 1u, gb / t_copy);
+    std::printf ("%-10s %8u %8.2f\n", "loop", 1u, gb / t_ref);
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+	counts.push_back (threads);
+    counts.push_back (max_threads);
+    for (unsigned threads : counts)
+    {
+	double t = run ([&] { parallel_decrypt (input.data(), output.data(), size, threads); }, passes);
+	if (output != expected)
+	    throw std::runtime_error ("output mismatch");
+	std::printf ("%-10s %8u %8.2f\n", "parallel", threads, gb / t);
+    }
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "keystream: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,318 @@
+// -*- C++ -*-
+//! \file       lcg.cc
+//! \date       2026 Oct 16
+//! \brief      check lcg_jump and chunked decryption of vns/deomi, vns/descs
+//              and vns/decpt against their sequential loops, measure scaling
+//              with number of threads.
+
+#include "lcg.h"
+#include "xform.h"
+#include "parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+const bin::lcg_step<uint32_t> omi_lcg = { 5, 0xFFFFFFFD };
+const bin::lcg_step<uint32_t> scs_lcg = { 69069, 0 };
+
+// --- deomi ----------------------------------------------------------------
+
+void ref_omi (uint8_t* data, size_t length, uint32_t key)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+	data[i] = ((data[i] << 7) | (data[i] >> 1)) - key;
+	key = 5 * key - 3;
+    }
+}
+
+void omi_chunk (uint8_t* data, size_t length, size_t pos, uint32_t key)
+{
+    key = bin::lcg_jump (omi_lcg, pos) (key);
+    uint8_t stream[0x1000];
+    for (size_t i = 0; i < length; i += sizeof(stream))
+    {
+	size_t count = std::min (sizeof(stream), length - i);
+	bin::lcg_bytes (omi_lcg, key, stream, count);
+	xform::ror (data + i, count, 1);
+	xform::sub_stream (data + i, count, stream);
+    }
+}
+
+void par_omi (uint8_t* data, size_t size, unsigned threads, size_t chunk)
+{
+    sys::parallel (size, threads, chunk, [=] (size_t pos, size_t count) {
+	omi_chunk (data + pos, count, pos, 7654321);
+    });
+}
+
+// --- descs ----------------------------------------------------------------
+
+void ref_scs (uint8_t* data, size_t size)
+{
+    auto data_end = data + size;
+    auto ptr = data + 2;
+    while (ptr+1 < data_end)
+    {
+	size_t key = (ptr - data) | 1;
+	size_t len = ptr[0] | ptr[1] << 8;
+	ptr += 2;
+	if (ptr + len > data_end)
+	    break;
+	for (size_t i = 0; i < len; ++i)
+	{
+	    key *= 69069;
+	    ptr[i] ^= key;
+	}
+	ptr += len;
+    }
+}
+
+void scs_record (uint8_t* data, size_t size, uint32_t key)
+{
+    uint8_t stream[0x1000];
+    key *= 69069;
+    for (size_t i = 0; i < size; i += sizeof(stream))
+    {
+	size_t count = std::min (sizeof(stream), size - i);
+	bin::lcg_bytes (scs_lcg, key, stream, count);
+	xform::xor_stream (data + i, count, stream);
+    }
+}
+
+struct record
+{
+    size_t	pos;
+    size_t	size;
+};
+
+void par_scs (uint8_t* data, size_t size, unsigned threads, size_t chunk)
+{
+    std::vector<record> records;
+    auto data_end = data + size;
+    auto ptr = data + 2;
+    while (ptr+1 < data_end)
+    {
+	size_t len = ptr[0] | ptr[1] << 8;
+	ptr += 2;
+	if (ptr + len > data_end)
+	    break;
+	record rec = { static_cast<size_t> (ptr - data), len };
+	records.push_back (rec);
+	ptr += len;
+    }
+    sys::parallel (records.size(), threads, std::max<size_t> (1, chunk / 256), [&] (size_t first, size_t count) {
+	for (size_t i = first; i < first + count; ++i)
+	    scs_record (data + records[i].pos, records[i].size, (records[i].pos - 2) | 1);
+    });
+}
+
+// SCS file of records from 1 to 300 bytes long
+byte_vector make_scs (size_t size)
+{
+    byte_vector scs { 'P', 'E' };
+    while (scs.size() < size)
+    {
+	size_t len = 1 + std::rand() % 300;
+	scs.push_back (len & 0xFF);
+	scs.push_back (len >> 8);
+	for (size_t i = 0; i < len; ++i)
+	    scs.push_back (std::rand());
+    }
+    return scs;
+}
+
+// --- decpt ----------------------------------------------------------------
+
+uint8_t g_decrypt_table[256];
+
+void init_table ()
+{
+    for (int i = 0; i < 256; ++i)
+	g_decrypt_table[i] = static_cast<uint8_t> (i * 167 + 13);
+}
+
+void ref_cpt (uint8_t* data, size_t length)
+{
+    uint8_t prev = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+	auto x = data[i];
+	data[i] = g_decrypt_table[(x - prev) & 0xFF];
+	prev = x;
+    }
+}
+
+void cpt_chunk (const uint8_t* src, uint8_t* dst, size_t length, uint8_t prev)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+	auto x = src[i];
+	dst[i] = g_decrypt_table[(x - prev) & 0xFF];
+	prev = x;
+    }
+}
+
+// decpt reads from input mapping and writes into output one
+void par_cpt (const uint8_t* src, uint8_t* dst, size_t size, unsigned threads, size_t chunk)
+{
+    sys::parallel (size, threads, chunk, [=] (size_t pos, size_t count) {
+	cpt_chunk (src + pos, dst + pos, count, pos ? src[pos-1] : 0);
+    });
+}
+
+// --- checks ---------------------------------------------------------------
+
+template <typename UIntT>
+void check_jump (UIntT a, UIntT c)
+{
+    for (uint64_t n = 0; n < 5000; ++n)
+    {
+	UIntT seed = static_cast<UIntT> (std::rand()), x = seed;
+	for (uint64_t i = 0; i < n; ++i)
+	    x = a * x + c;
+	if (bin::lcg_jump (a, c, n) (seed) != x)
+	    throw std::runtime_error ("lcg_jump mismatch");
+    }
+    // jumps compose
+    for (int i = 0; i < 1000; ++i)
+    {
+	uint64_t n1 = uint64_t (std::rand()) << 20 | std::rand(), n2 = std::rand();
+	auto j1 = bin::lcg_jump (a, c, n1), j2 = bin::lcg_jump (a, c, n2);
+	if (bin::lcg_jump (a, c, n1 + n2) (7) != j1 (j2 (7)))
+	    throw std::runtime_error ("lcg_jump composition mismatch");
+    }
+}
+
+void check_tools (const byte_vector& input, const byte_vector& scs)
+{
+    for (int trial = 0; trial < 200; ++trial)
+    {
+	size_t size = std::rand() % 100000;
+	size_t chunk = 1 + std::rand() % 20000;
+	unsigned threads = 1 + std::rand() % 4;
+	byte_vector ref (input.begin(), input.begin() + size), data (ref);
+	ref_omi (ref.data(), size, 7654321);
+	par_omi (data.data(), size, threads, chunk);
+	if (ref != data)
+	    throw std::runtime_error ("deomi mismatch");
+
+	byte_vector out (size);
+	ref.assign (input.begin(), input.begin() + size);
+	ref_cpt (ref.data(), size);
+	par_cpt (input.data(), out.data(), size, threads, chunk);
+	if (ref != out)
+	    throw std::runtime_error ("decpt mismatch");
+
+	size = std::min (scs.size(), size);
+	ref.assign (scs.begin(), scs.begin() + size);
+	data = ref;
+	ref_scs (ref.data(), size);
+	par_scs (data.data(), size, threads, chunk);
+	if (ref != data)
+	    throw std::runtime_error ("descs mismatch");
+    }
+}
+
+template <class Func>
+double run (Func func, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+	func();
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x4000000;
+    if (!size)
+	size = 0x4000000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 5;
+    if (passes <= 0)
+	passes = 1;
+    unsigned max_threads = argc > 3 ? std::atoi (argv[3]) : 0;
+    if (!max_threads)
+	max_threads = std::max (1u, std::thread::hardware_concurrency());
+
+    std::srand (1);
+    check_jump<uint32_t> (5, 0xFFFFFFFD);
+    check_jump<uint32_t> (69069, 0);
+    check_jump<uint32_t> (214013, 2531011);
+    check_jump<uint64_t> (6364136223846793005ull, 1442695040888963407ull);
+    for (size_t n = 0; n < 300; ++n)
+    {
+	uint8_t stream[300];
+	uint32_t x = std::rand(), y = x;
+	bin::lcg_bytes (omi_lcg, x, stream, n);
+	for (size_t i = 0; i < n; ++i, y = omi_lcg (y))
+	    if (stream[i] != static_cast<uint8_t> (y))
+		throw std::runtime_error ("lcg_bytes mismatch");
+	if (x != y)
+	    throw std::runtime_error ("lcg_bytes state mismatch");
+    }
+
+    init_table();
+    byte_vector input (size);
+    for (auto& b : input)
+	b = std::rand();
+    const byte_vector scs = make_scs (size);
+    check_tools (input, scs);
+    std::printf ("lcg_jump and chunked decryption match sequential loops\n");
+
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+	counts.push_back (threads);
+    counts.push_back (max_threads);
+
+    std::printf ("%u bytes, %d passes, %u CPUs\n", unsigned (size), passes,
+		 std::thread::hardware_concurrency());
+    std::printf ("%-8s %-10s %8s %8s\n", "tool", "method", "threads", "GB/s");
+    byte_vector data (size), output (size);
+    struct tool
+    {
+	const char*	name;
+	std::function<void()>	ref;
+	std::function<void(unsigned)>	par;
+    };
+    const size_t chunk = 0x100000;
+    const tool tools[] = {
+	{ "deomi", [&] { ref_omi (data.data(), size, 7654321); },
+		   [&] (unsigned t) { par_omi (data.data(), size, t, chunk); } },
+	{ "descs", [&] { ref_scs (data.data(), data.size()); },
+		   [&] (unsigned t) { par_scs (data.data(), data.size(), t, chunk); } },
+	{ "decpt", [&] { ref_cpt (data.data(), size); },
+		   [&] (unsigned t) { par_cpt (input.data(), output.data(), size, t, chunk); } },
+    };
+    for (const auto& t : tools)
+    {
+	if (0 == std::strcmp (t.name, "descs"))
+	    data = scs;
+	const double gb = double (data.size()) * passes / (1024*1024*1024);
+	std::printf ("%-8s %-10s %8u %8.2f\n", t.name, "loop", 1u, gb / run (t.ref, passes));
+	for (unsigned threads : counts)
+	    std::printf ("%-8s %-10s %8u %8.2f\n", t.name, "parallel", threads,
+			 gb / run ([&] { t.par (threads); }, passes));
+    }
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "lcg: %s\n", X.what());
+    return 1;
+}
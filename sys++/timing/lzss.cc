@@ -0,0 +1,267 @@
+// -*- C++ -*-
+//! \file       lzss.cc
+//! \date       2026 Oct 16
+//! \brief      compare lzss_decoder variants against frame-based decoders they
+//              replaced.
+//
+// decoders are fed with random token streams, which are valid input for every
+// variant since any frame offset refers to initialized data.
+
+#include "lzssvar.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+// --- reference decoders ----------------------------------------------------
+
+template <class Params>
+size_t ref_classic (const uint8_t* packed, size_t packed_size, uint8_t* output, size_t output_size)
+{
+    const size_t FrameSize = Params::frame_size;
+    const unsigned frame_mask = FrameSize-1;
+
+    byte_vector frame (FrameSize);
+    Params::init_frame (frame.data());
+    int frame_pos = Params::init_pos;
+
+    size_t dst = 0;
+    auto const packed_end = packed + packed_size;
+    auto src = packed;
+    const bool msb_first = std::is_same<typename Params::flag_order, bin::msb_first>::value;
+    while (src != packed_end && dst < output_size)
+    {
+        int ctl = *src++;
+        for (int i = 0; src != packed_end && i < 8; ++i)
+        {
+            int bit = msb_first ? 0x80 >> i : 1 << i;
+            if (ctl & bit)
+            {
+                uint8_t b = *src++;
+                frame[frame_pos++ & frame_mask] = b;
+                output[dst++] = b;
+            }
+            else
+            {
+                if (packed_end - src < 2)
+                    break;
+                unsigned lo = *src++;
+                unsigned hi = *src++;
+                unsigned offset, count;
+                Params::decode_ref (lo, hi, offset, count);
+                for (unsigned i = 0; i < count && dst < output_size; ++i)
+                {
+                    uint8_t v = frame[offset++ & frame_mask];
+                    frame[frame_pos++ & frame_mask] = v;
+                    output[dst++] = v;
+                }
+            }
+            if (dst >= output_size)
+                break;
+        }
+    }
+    return dst;
+}
+
+size_t ref_stream (const uint8_t* packed, size_t packed_size, std::ostream& out)
+{
+    const size_t FrameSize = 0x1000;
+    const unsigned frame_mask = FrameSize-1;
+
+    byte_vector frame (FrameSize);
+    int frame_pos = 0xFEE;
+
+    size_t total = 0;
+    auto const packed_end = packed + packed_size;
+    auto src = packed;
+    while (src != packed_end)
+    {
+        int ctl = *src++;
+        for (int bit = 1; src != packed_end && bit != 0x100; bit <<= 1)
+        {
+            if (ctl & bit)
+            {
+                uint8_t b = *src++;
+                frame[frame_pos++] = b;
+                frame_pos &= frame_mask;
+                out.put (static_cast<char> (b));
+                ++total;
+            }
+            else
+            {
+                if (packed_end - src < 2)
+                    return total;
+                int lo = *src++;
+                int hi = *src++;
+                int offset = (hi & 0xF0) << 4 | lo;
+                int count = 3 + (hi & 0xF);
+                for (int i = 0; i < count; ++i)
+                {
+                    uint8_t v = frame[offset++];
+                    offset &= frame_mask;
+                    frame[frame_pos++] = v;
+                    frame_pos &= frame_mask;
+                    out.put (static_cast<char> (v));
+                }
+                total += count;
+            }
+        }
+    }
+    return total;
+}
+
+// --- variants --------------------------------------------------------------
+
+using bin::classic_lzss;
+using bin::bcs_lzss;
+using bin::ps2_lzss;
+using bin::advc_lzss;
+
+struct msb_lzss : bin::lzss_params<0x1000, 0, bin::msb_first> { };
+
+// --- corpus ----------------------------------------------------------------
+
+// text-like stream: short alphabet literals, about a half of tokens are
+// matches.  ratio is the percentage of literal tokens.
+
+byte_vector make_stream (size_t size, int ratio)
+{
+    byte_vector packed;
+    packed.reserve (size + 16);
+    std::srand (1);
+    while (packed.size() < size)
+    {
+        unsigned ctl = 0;
+        for (int bit = 0; bit < 8; ++bit)
+            if (std::rand() % 100 < ratio)
+                ctl |= 1 << bit;
+        packed.push_back (ctl);
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            if (ctl & (1 << bit))
+                packed.push_back (0x20 + std::rand() % 64);
+            else
+            {
+                packed.push_back (std::rand());
+                packed.push_back (std::rand());
+            }
+        }
+    }
+    return packed;
+}
+
+struct result
+{
+    size_t	size;
+    double	seconds;
+};
+
+template <class Func>
+result run (Func decode, int passes)
+{
+    result r = { 0, 0 };
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+        r.size = decode();
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    r.seconds = t.count();
+    return r;
+}
+
+void report (const char* name, const result& ref, const result& cur, int passes)
+{
+    const double mb = double (ref.size) * passes / (1024*1024);
+    std::printf ("%-10s %12.1f %12.1f %8.2f\n", name, mb / ref.seconds, mb / cur.seconds,
+                 ref.seconds / cur.seconds);
+}
+
+template <class Params>
+void compare (const char* name, const byte_vector& packed, size_t max_size, int passes)
+{
+    byte_vector out1 (max_size), out2 (max_size);
+    auto ref = run ([&] { return ref_classic<Params> (packed.data(), packed.size(), out1.data(), out1.size()); }, passes);
+    auto cur = run ([&] { return bin::lzss_decompress<Params> (packed.data(), packed.size(), out2.data(), out2.size()); }, passes);
+    if (ref.size != cur.size || !std::equal (out1.begin(), out1.begin() + ref.size, out2.begin()))
+        throw std::runtime_error (std::string (name) + " output mismatch");
+    report (name, ref, cur, passes);
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x100000;
+    if (!size)
+        size = 0x100000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 20;
+    if (passes <= 0)
+        passes = 1;
+    int ratio = argc > 3 ? std::atoi (argv[3]) : 50;
+
+    const byte_vector packed = make_stream (size, ratio);
+    const size_t max_size = packed.size() * 18;
+    std::printf ("%u bytes packed, %d%% literals, %d passes\n", unsigned (packed.size()), ratio, passes);
+    std::printf ("%-10s %12s %12s %8s\n", "variant", "frame MB/s", "engine MB/s", "ratio");
+    compare<classic_lzss> ("classic", packed, max_size, passes);
+    compare<bcs_lzss> ("bcs", packed, max_size, passes);
+    compare<ps2_lzss> ("ps2", packed, max_size, passes);
+    compare<advc_lzss> ("advc", packed, max_size, passes);
+    compare<msb_lzss> ("msb", packed, max_size, passes);
+
+    // output into stream, as tools/lzss.cc does
+    std::string out1, out2;
+    auto ref = run ([&] {
+        std::ostringstream out;
+        ref_stream (packed.data(), packed.size(), out);
+        out1 = out.str();
+        return out1.size();
+    }, passes);
+    auto cur = run ([&] {
+        std::ostringstream out;
+        bin::lzss_decompress<classic_lzss> (packed.data(), packed.size(), out);
+        out2 = out.str();
+        return out2.size();
+    }, passes);
+    if (out1 != out2)
+        throw std::runtime_error ("ostream output mismatch");
+    report ("ostream", ref, cur, passes);
+
+    // input pushed in chunks of random size, as unlzss --stdin does
+    std::vector<size_t> chunks;
+    for (size_t pos = 0; pos < packed.size(); )
+    {
+        size_t n = std::min<size_t> (1 + std::rand() % 0x4000, packed.size() - pos);
+        chunks.push_back (n);
+        pos += n;
+    }
+    auto push = run ([&] {
+        out2.clear();
+        bin::lzss_push_decoder<classic_lzss> lzss;
+        const uint8_t* src = packed.data();
+        for (size_t n : chunks)
+        {
+            lzss.push (src, n, [&] (const uint8_t* data, size_t size) {
+                out2.append (reinterpret_cast<const char*> (data), size);
+            });
+            src += n;
+        }
+        return out2.size();
+    }, passes);
+    if (out1 != out2)
+        throw std::runtime_error ("push output mismatch");
+    report ("push", ref, push, passes);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "lzss: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,109 @@
+// -*- C++ -*-
+//! \file       lzsspack.cc
+//! \date       2026 Oct 16
+//! \brief      measure lzss_encoder speed and ratio at each parsing level, and
+//              check that output decodes back to the input.
+//
+
+#include "lzssenc.h"
+#include "sysmemmap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+typedef bin::lzss_params<> classic_lzss;
+
+// script-like text: lines made of words from small vocabulary, with numeric
+// command codes in between.
+
+byte_vector make_text (size_t size)
+{
+    static const char* const words[] = {
+        "the", "of", "and", "to", "in", "is", "you", "that", "it", "he",
+        "was", "for", "on", "are", "as", "with", "his", "they", "at", "be",
+        "this", "have", "from", "or", "one", "had", "by", "word", "but", "not",
+    };
+    const size_t word_count = sizeof(words)/sizeof(*words);
+    byte_vector text;
+    text.reserve (size + 32);
+    std::srand (1);
+    while (text.size() < size)
+    {
+        text.push_back (0x10 + std::rand() % 8);
+        text.push_back (std::rand() % 256);
+        int line_length = 3 + std::rand() % 12;
+        for (int i = 0; i < line_length; ++i)
+        {
+            const char* word = words[std::rand() % word_count];
+            text.insert (text.end(), word, word + std::strlen (word));
+            text.push_back (' ');
+        }
+        text.back() = '\n';
+    }
+    text.resize (size);
+    return text;
+}
+
+void run_level (const char* name, bin::lzss_encoder<classic_lzss>::level_type level,
+                const byte_vector& input, int passes)
+{
+    bin::lzss_encoder<classic_lzss> lzss (level);
+    byte_vector packed;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+    {
+        packed.clear();
+        lzss.encode (input.data(), input.size(), packed);
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+
+    byte_vector unpacked (input.size());
+    size_t size = bin::lzss_decompress<classic_lzss> (packed.data(), packed.size(), unpacked.data(), unpacked.size());
+    if (size != input.size() || unpacked != input)
+        throw std::runtime_error (std::string (name) + " round trip failed");
+
+    const double mb = double (input.size()) * passes / (1024*1024);
+    std::printf ("%-8s %10.1f %10u %8.3f\n", name, mb / t.count(), unsigned (packed.size()),
+                 double (packed.size()) / input.size());
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    byte_vector input;
+    if (argc > 1 && !std::isdigit (argv[1][0]))
+    {
+        sys::mapping::readonly in (argv[1]);
+        sys::mapping::const_view<uint8_t> view (in);
+        input.assign (view.begin(), view.end());
+    }
+    else
+    {
+        size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x100000;
+        if (!size)
+            size = 0x100000;
+        input = make_text (size);
+    }
+    int passes = argc > 2 ? std::atoi (argv[2]) : 5;
+    if (passes <= 0)
+        passes = 1;
+
+    std::printf ("%u bytes, %d passes\n", unsigned (input.size()), passes);
+    std::printf ("%-8s %10s %10s %8s\n", "level", "MB/s", "packed", "ratio");
+    run_level ("greedy", bin::lzss_encoder<classic_lzss>::greedy, input, passes);
+    run_level ("lazy", bin::lzss_encoder<classic_lzss>::lazy, input, passes);
+    run_level ("optimal", bin::lzss_encoder<classic_lzss>::optimal, input, passes);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "lzsspack: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,118 @@
+// -*- C++ -*-
+//! \file       mmadvise.cc
+//! \date       2026 Oct 16
+//! \brief      compare page faults and throughput of mapped views with different
+//              access pattern hints.
+//
+
+#include "sysmemmap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct fault_count
+{
+    unsigned long minor;
+    unsigned long major;
+};
+
+fault_count get_faults ()
+{
+    fault_count f = { 0, 0 };
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (::GetProcessMemoryInfo (::GetCurrentProcess(), &pmc, sizeof(pmc)))
+        f.major = pmc.PageFaultCount;
+#else
+    struct rusage usage;
+    if (0 == ::getrusage (RUSAGE_SELF, &usage))
+    {
+        f.minor = usage.ru_minflt;
+        f.major = usage.ru_majflt;
+    }
+#endif
+    return f;
+}
+
+struct hint_desc
+{
+    const char*                 name;
+    sys::mapping::advice_t      hint;
+};
+
+const hint_desc hints[] = {
+    { "normal",     sys::mapping::normal },
+    { "sequential", sys::mapping::sequential },
+    { "random",     sys::mapping::random },
+    { "willneed",   sys::mapping::willneed },
+    { "hugepage",   sys::mapping::hugepage },
+    { "populate",   sys::mapping::populate },
+};
+
+// touch every byte of the view, so that the compiler can't skip the loop.
+
+unsigned run_pass (sys::mapping::map_base& in, sys::mapping::advice_t hint)
+{
+    sys::mapping::const_view<uint8_t> view (in, 0, 0, hint);
+    unsigned sum = 0;
+    for (auto ptr = view.begin(); ptr != view.end(); ++ptr)
+        sum += *ptr;
+    return sum;
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    if (argc < 2)
+    {
+        std::puts ("usage: mmadvise FILE [PASSES]");
+        return 0;
+    }
+    int passes = argc > 2 ? std::atoi (argv[2]) : 3;
+    if (passes <= 0)
+        passes = 1;
+
+    sys::mapping::readonly in (argv[1]);
+    const double mb_size = double (in.size()) / (1024*1024);
+    std::printf ("%s: %.1f MB, %d passes\n", argv[1], mb_size, passes);
+    std::printf ("%-12s %12s %12s %10s\n", "hint", "minor", "major", "MB/s");
+
+    // first pass warms up the page cache so that all hints are measured under
+    // the same conditions.
+    unsigned checksum = run_pass (in, sys::mapping::normal);
+    for (const auto& h : hints)
+    {
+        unsigned long minor = 0, major = 0;
+        double elapsed = 0;
+        for (int i = 0; i < passes; ++i)
+        {
+            auto start_faults = get_faults();
+            auto start = std::chrono::steady_clock::now();
+            unsigned sum = run_pass (in, h.hint);
+            std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+            auto end_faults = get_faults();
+            if (sum != checksum)
+                throw std::runtime_error ("checksum mismatch");
+            elapsed += t.count();
+            minor += end_faults.minor - start_faults.minor;
+            major += end_faults.major - start_faults.major;
+        }
+        std::printf ("%-12s %12lu %12lu %10.1f\n", h.name, minor / passes, major / passes,
+                     elapsed > 0 ? mb_size * passes / elapsed : 0.0);
+    }
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "mmadvise: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,71 @@
+// -*- C++ -*-
+//! \file       mmanon.cc
+//! \date       2026 Oct 16
+//! \brief      compare pooled anonymous mappings against fresh allocations.
+//
+
+#include "sysmemmap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// simulate batch run over scripts of various sizes: allocate scratch buffer,
+// fill it and release.
+
+double run_batch (int count, size_t max_size, bool huge_pages)
+{
+    std::srand (1);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+    {
+        size_t size = 1 + std::rand() % max_size;
+        sys::mapping::anonymous mem (size, huge_pages);
+        sys::mapping::view<uint8_t> view (mem);
+        std::memset (view.data(), i, view.size());
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+void run_report (const char* name, int count, size_t max_size, bool huge_pages)
+{
+    auto baseline = sys::mapping::anonymous::get_pool_stats();
+    double elapsed = run_batch (count, max_size, huge_pages);
+    auto stats = sys::mapping::anonymous::get_pool_stats();
+    std::printf ("%-16s %10.3f %10.2f %10lu %10lu %10lu\n", name, elapsed,
+                 elapsed * 1e6 / count, stats.hits - baseline.hits,
+                 stats.misses - baseline.misses, stats.evictions - baseline.evictions);
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    int count = argc > 1 ? std::atoi (argv[1]) : 10000;
+    size_t max_size = argc > 2 ? std::strtoul (argv[2], nullptr, 0) : 0x20000;
+    if (count <= 0 || !max_size)
+    {
+        std::puts ("usage: mmanon [COUNT [MAX_SIZE]]");
+        return 0;
+    }
+    std::printf ("%d allocations up to %u bytes\n", count, unsigned (max_size));
+    std::printf ("%-16s %10s %10s %10s %10s %10s\n", "mode", "seconds", "us/alloc",
+                 "hits", "misses", "evictions");
+
+    auto limit = sys::mapping::anonymous::set_pool_limit (0);
+    run_report ("no pool", count, max_size, false);
+    sys::mapping::anonymous::set_pool_limit (limit);
+    run_report ("pool", count, max_size, false);
+    sys::mapping::anonymous::trim_pool();
+    run_report ("pool+hugepage", count, max_size, true);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "mmanon: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,101 @@
+// -*- C++ -*-
+//! \file       mmsmall.cc
+//! \date       2026 Oct 16
+//! \brief      find crossover point between reading small files into memory and
+//              mapping them.
+//
+
+#include "sysmemmap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace {
+
+std::vector<std::string> create_files (const std::string& dir, int count, size_t size)
+{
+    std::vector<std::string> names;
+    std::vector<char> data (size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<char> (i * 7);
+    for (int i = 0; i < count; ++i)
+    {
+        char name[32];
+        std::sprintf (name, "%05d.bin", i);
+        names.push_back (dir + "/" + name);
+        std::ofstream out (names.back().c_str(), std::ios::out|std::ios::binary|std::ios::trunc);
+        if (!out.write (data.data(), size))
+            throw std::runtime_error ("failed to create test file");
+    }
+    return names;
+}
+
+void remove_files (const std::vector<std::string>& names)
+{
+    for (const auto& name : names)
+        std::remove (name.c_str());
+}
+
+// open every file, touch all of its bytes through const_view and close.
+
+double scan_files (const std::vector<std::string>& names, unsigned& checksum)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& name : names)
+    {
+        sys::mapping::readonly in (name);
+        sys::mapping::const_view<uint8_t> view (in);
+        for (auto b : view)
+            checksum += b;
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    if (argc < 2)
+    {
+        std::puts ("usage: mmsmall DIRECTORY [COUNT]");
+        return 0;
+    }
+    const std::string dir (argv[1]);
+    int count = argc > 2 ? std::atoi (argv[2]) : 10000;
+    if (count <= 0)
+        count = 10000;
+
+    std::printf ("%d files per size\n", count);
+    std::printf ("%10s %12s %12s %8s\n", "size", "mmap us", "read us", "ratio");
+    for (size_t size = 0x400; size <= 0x100000; size <<= 1)
+    {
+        auto names = create_files (dir, count, size);
+        unsigned sum_map = 0, sum_read = 0;
+        // warm up page cache
+        sys::mapping::map_base::set_read_threshold (0);
+        scan_files (names, sum_map);
+        sum_map = 0;
+
+        double t_map = scan_files (names, sum_map);
+        auto prev = sys::mapping::map_base::set_read_threshold (size);
+        double t_read = scan_files (names, sum_read);
+        sys::mapping::map_base::set_read_threshold (prev);
+        remove_files (names);
+        if (sum_map != sum_read)
+            throw std::runtime_error ("checksum mismatch");
+
+        std::printf ("%10u %12.2f %12.2f %8.2f\n", unsigned (size), t_map * 1e6 / count,
+                     t_read * 1e6 / count, t_map / t_read);
+    }
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "mmsmall: %s\n", X.what());
+    return 1;
+}
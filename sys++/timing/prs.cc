@@ -0,0 +1,183 @@
+// -*- C++ -*-
+//! \file       prs.cc
+//! \date       2026 Oct 16
+//! \brief      compare prs_decoder against byte-wise PRS decoder it replaced.
+//
+// decoders are fed with random token streams that only refer to data already
+// decoded.
+
+#include "prsdec.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+// reference decoder, with bounds check on every byte as bytecode_reader does.
+
+struct ref_reader
+{
+    const uint8_t* pos;
+    const uint8_t* end;
+
+    uint8_t get_byte ()
+    {
+        if (pos >= end)
+            throw std::runtime_error ("out of bounds");
+        return *pos++;
+    }
+    uint16_t get_word ()
+    {
+        if (pos + 2 > end)
+            throw std::runtime_error ("out of bounds");
+        uint16_t word = pos[0] | pos[1] << 8;
+        pos += 2;
+        return word;
+    }
+};
+
+size_t ref_decompress (const uint8_t* packed, size_t packed_size, byte_vector& output)
+{
+    ref_reader in = { packed, packed + packed_size };
+    size_t dst = 0;
+    uint16_t mask = 0;
+    uint16_t ctl = 0;
+    while (in.pos < in.end && dst < output.size())
+    {
+        mask >>= 1;
+        if (!mask)
+        {
+            ctl = in.get_word();
+            mask = 0x8000;
+        }
+        if (!(ctl & mask))
+        {
+            output[dst++] = in.get_byte();
+        }
+        else
+        {
+            uint8_t byte = in.get_byte();
+            size_t count, off;
+            if (byte & 1)
+            {
+                byte >>= 1;
+                count = (byte >> 4) + 2;
+                off = (byte & 0xF) + 1;
+            }
+            else
+            {
+                size_t ax = in.get_byte() << 7 | byte >> 1;
+                count = ((ax >> 10) & 0x3F) + 2;
+                off = (ax & 0x3FF) + 1;
+            }
+            if (off >= dst)
+                throw std::runtime_error ("invalid compressed file");
+            count = std::min (count, output.size() - dst);
+            while (count --> 0)
+            {
+                output[dst] = output[dst-off];
+                ++dst;
+            }
+        }
+    }
+    return dst;
+}
+
+// ratio is the percentage of literal tokens.  returns packed stream and sets
+// unpacked_size to the size of output.
+
+byte_vector make_stream (size_t size, int ratio, size_t& unpacked_size)
+{
+    byte_vector packed;
+    packed.reserve (size + 64);
+    std::srand (1);
+    size_t dst = 0;
+    while (packed.size() < size)
+    {
+        size_t ctl_pos = packed.size();
+        packed.resize (ctl_pos + 2);
+        unsigned ctl = 0;
+        for (unsigned mask = 0x8000; mask != 0; mask >>= 1)
+        {
+            if (dst < 2 || std::rand() % 100 < ratio)
+            {
+                packed.push_back (0x20 + std::rand() % 64);
+                ++dst;
+                continue;
+            }
+            ctl |= mask;
+            if (std::rand() & 1)
+            {
+                unsigned count = std::rand() % 8;
+                unsigned distance = std::rand() % std::min<size_t> (16, dst - 1);
+                packed.push_back (count << 5 | distance << 1 | 1);
+                dst += count + 2;
+            }
+            else
+            {
+                unsigned count = std::rand() % 32;
+                unsigned distance = std::rand() % std::min<size_t> (1024, dst - 1);
+                unsigned code = count << 10 | distance;
+                packed.push_back (code << 1 & 0xFF);
+                packed.push_back (code >> 7);
+                dst += count + 2;
+            }
+        }
+        packed[ctl_pos] = ctl & 0xFF;
+        packed[ctl_pos+1] = ctl >> 8;
+    }
+    unpacked_size = dst;
+    return packed;
+}
+
+template <class Func>
+double run (Func decode, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+        decode();
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x100000;
+    if (!size)
+        size = 0x100000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 20;
+    if (passes <= 0)
+        passes = 1;
+    int ratio = argc > 3 ? std::atoi (argv[3]) : 50;
+
+    size_t unpacked_size;
+    const byte_vector packed = make_stream (size, ratio, unpacked_size);
+    byte_vector out1 (unpacked_size), out2 (unpacked_size), out3;
+
+    double t_ref = run ([&] { ref_decompress (packed.data(), packed.size(), out1); }, passes);
+    double t_known = run ([&] { bin::prs_decompress (packed.data(), packed.size(), out2.data(), out2.size()); }, passes);
+    double t_grow = run ([&] { bin::prs_decompress (packed.data(), packed.size(), out3); }, passes);
+    if (out1 != out2 || out1 != out3)
+        throw std::runtime_error ("output mismatch");
+
+    const double mb = double (unpacked_size) * passes / (1024*1024);
+    std::printf ("%u bytes packed, %u unpacked, %d%% literals, %d passes\n",
+                 unsigned (packed.size()), unsigned (unpacked_size), ratio, passes);
+    std::printf ("%-12s %10s\n", "method", "MB/s");
+    std::printf ("%-12s %10.1f\n", "bytewise", mb / t_ref);
+    std::printf ("%-12s %10.1f\n", "known size", mb / t_known);
+    std::printf ("%-12s %10.1f\n", "growable", mb / t_grow);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "prs: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,96 @@
+// -*- C++ -*-
+//! \file       refcount.cc
+//! \date       2026 Oct 16
+//! \brief      measure copy/destroy throughput of mapped objects and views under
+//              atomic and plain reference counting.
+
+#include "sysmemmap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+struct counted : sys::refcount_base
+{
+    int value;
+};
+
+template <class Policy>
+double copy_pointers (long count, long& sum)
+{
+    sys::refcount_ptr<counted, Policy> origin (new counted);
+    origin->value = 1;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < count; ++i)
+    {
+        sys::refcount_ptr<counted, Policy> copy (origin);
+        sum += copy->value;
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+template <class Policy>
+double copy_maps (const sys::mapping::basic_anonymous<Policy>& in, long count, long& sum)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < count; ++i)
+    {
+        sys::mapping::basic_anonymous<Policy> copy (in);
+        sum += copy.size();
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+// anonymous mappings are mapped once, so views over them cost no system calls
+// and only reference counting is measured.
+
+template <class Policy>
+double create_views (sys::mapping::basic_map_base<Policy>& in, long count, long& sum)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < count; ++i)
+    {
+        sys::mapping::const_view<uint8_t, Policy> view (in, 0, 16);
+        sum += view[i & 15];
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+void report (const char* name, double elapsed, long count)
+{
+    std::printf ("%-26s %10.2f %10.1f\n", name, elapsed * 1e9 / count, count / elapsed / 1e6);
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    long count = argc > 1 ? std::atol (argv[1]) : 50000000;
+    if (count <= 0)
+        count = 50000000;
+
+    long sum = 0;
+    std::printf ("%-26s %10s %10s\n", "operation", "ns/op", "Mop/s");
+    report ("refcount_ptr<atomic>", copy_pointers<sys::atomic_count> (count, sum), count);
+    report ("refcount_ptr<plain>", copy_pointers<sys::plain_count> (count, sum), count);
+
+    sys::mapping::basic_anonymous<sys::atomic_count> mem (0x1000);
+    report ("map_base<atomic> copy", copy_maps (mem, count, sum), count);
+    report ("const_view<atomic> create", create_views (mem, count, sum), count);
+    sys::mapping::basic_anonymous<sys::plain_count> mem_st (0x1000);
+    report ("map_base<plain> copy", copy_maps (mem_st, count, sum), count);
+    report ("const_view<plain> create", create_views (mem_st, count, sum), count);
+    std::printf ("checksum %ld\n", sum);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "refcount: %s\n", X.what());
+    return 1;
+}
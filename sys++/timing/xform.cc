@@ -0,0 +1,225 @@
+// -*- C++ -*-
+//! \file       xform.cc
+//! \date       2026 Oct 16
+//! \brief      check xform kernels against loops of decryptors they replaced
+//              and measure throughput of each kernel.
+//
+// randomized trials run every kernel over ranges of random size and
+// alignment, in place and into separate buffer, and compare results with
+// scalar loops byte for byte.
+
+#include "xform.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+// --- reference loops -------------------------------------------------------
+
+void ref_xor (uint8_t* data, size_t size, long key)		// tools/xordecrypt.cc
+{
+    for (auto it = data; it != data + size; ++it)
+    {
+	*it ^= key;
+    }
+}
+
+void ref_xor_key (uint8_t* data, size_t size, const uint8_t* key, size_t key_size, size_t key_pos)
+{
+    for (size_t i = 0; i < size; ++i)
+	data[i] ^= key[(key_pos + i) % key_size];
+}
+
+void ref_rol (uint8_t* data, size_t size, long shift)		// tools/roldecrypt.cc
+{
+    for (auto it = data; it != data + size; ++it)
+    {
+	uint8_t x = *it;
+	*it = x << shift | x >> (8 - shift);
+    }
+}
+
+void ref_kururu (uint8_t* data, size_t size)			// vns/dekururu.cc
+{
+    for (auto ptr = data; ptr != data + size; ++ptr)
+    {
+	uint8_t v = *ptr ^ 0x39;
+	*ptr = v >> 3 | v << 5;
+    }
+}
+
+// words are accessed through memcpy, test offsets are not aligned
+void ref_kaas (uint8_t* data, size_t count)			// vns/dekaas.cc
+{
+    uint8_t* ptr = data;
+    do
+    {
+	uint16_t word;
+	std::memcpy (&word, ptr, 2);
+	word ^= 1;
+	std::memcpy (ptr, &word, 2);
+	ptr += 2;
+    }
+    while (--count > 0);
+}
+
+void ref_not (uint8_t* data, size_t size)			// vns/de_dv.cc
+{
+    for (size_t i = 0; i < size; ++i)
+	data[i] ^= 0xFF;
+}
+
+void ref_add (uint8_t* data, size_t size, uint8_t value)
+{
+    for (size_t i = 0; i < size; ++i)
+	data[i] += value;
+}
+
+// --- kernels under test ----------------------------------------------------
+
+struct kernel
+{
+    const char*	name;
+    std::function<void (uint8_t*, size_t)>	ref;
+    std::function<void (const uint8_t*, uint8_t*, size_t)>	xform;
+};
+
+const uint8_t kaas_key[2] = { 1, 0 };
+const uint8_t key3[3] = { 0x12, 0x9A, 0xF0 };
+
+std::vector<kernel> make_kernels (const byte_vector& long_key, size_t key_pos)
+{
+    const uint8_t* lkey = long_key.data();
+    const size_t lsize = long_key.size();
+    std::vector<kernel> k;
+    k.push_back ({ "xor_byte",
+	[] (uint8_t* p, size_t n) { ref_xor (p, n, 0x7F); },
+	[] (const uint8_t* s, uint8_t* d, size_t n) { xform::xor_byte (s, d, n, 0x7F); } });
+    k.push_back ({ "xor_key3",
+	[=] (uint8_t* p, size_t n) { ref_xor_key (p, n, key3, 3, key_pos); },
+	[=] (const uint8_t* s, uint8_t* d, size_t n) { xform::xor_key (s, d, n, key3, 3, key_pos); } });
+    k.push_back ({ "xor_keyN",
+	[=] (uint8_t* p, size_t n) { ref_xor_key (p, n, lkey, lsize, key_pos); },
+	[=] (const uint8_t* s, uint8_t* d, size_t n) { xform::xor_key (s, d, n, lkey, lsize, key_pos); } });
+    k.push_back ({ "kaas",
+	[] (uint8_t* p, size_t n) { if (n >= 2) ref_kaas (p, n / 2); },
+	[] (const uint8_t* s, uint8_t* d, size_t n) {
+	    if (s != d)
+		std::memcpy (d, s, n);
+	    xform::xor_key (d, n & ~size_t (1), kaas_key, 2);
+	} });
+    k.push_back ({ "invert",
+	[] (uint8_t* p, size_t n) { ref_not (p, n); },
+	[] (const uint8_t* s, uint8_t* d, size_t n) { xform::invert (s, d, n); } });
+    k.push_back ({ "add",
+	[] (uint8_t* p, size_t n) { ref_add (p, n, 0x7C); },
+	[] (const uint8_t* s, uint8_t* d, size_t n) { xform::add (s, d, n, 0x7C); } });
+    k.push_back ({ "sub",
+	[] (uint8_t* p, size_t n) { ref_add (p, n, static_cast<uint8_t> (-0x7C)); },
+	[] (const uint8_t* s, uint8_t* d, size_t n) { xform::sub (s, d, n, 0x7C); } });
+    k.push_back ({ "rol3",
+	[] (uint8_t* p, size_t n) { ref_rol (p, n, 3); },
+	[] (const uint8_t* s, uint8_t* d, size_t n) { xform::rol (s, d, n, 3); } });
+    k.push_back ({ "ror5",
+	[] (uint8_t* p, size_t n) { ref_rol (p, n, 3); },
+	[] (const uint8_t* s, uint8_t* d, size_t n) { xform::ror (s, d, n, 5); } });
+    k.push_back ({ "kururu",
+	[] (uint8_t* p, size_t n) { ref_kururu (p, n); },
+	[] (const uint8_t* s, uint8_t* d, size_t n) {
+	    xform::xor_byte (s, d, n, 0x39);
+	    xform::ror (d, n, 3);
+	} });
+    return k;
+}
+
+byte_vector random_bytes (size_t size)
+{
+    byte_vector data (size);
+    for (auto& b : data)
+	b = std::rand() & 0xFF;
+    return data;
+}
+
+void run_trials (int trials)
+{
+    for (int n = 0; n < trials; ++n)
+    {
+	byte_vector key = random_bytes (1 + std::rand() % 70);
+	size_t key_pos = std::rand() % 1000;
+	size_t size = std::rand() % 300;
+	size_t src_align = std::rand() % 40, dst_align = std::rand() % 40;
+	const byte_vector input = random_bytes (size + 40);
+	for (const auto& k : make_kernels (key, key_pos))
+	{
+	    byte_vector expected (input);
+	    k.ref (expected.data() + src_align, size);
+
+	    byte_vector inplace (input);
+	    k.xform (inplace.data() + src_align, inplace.data() + src_align, size);
+	    if (inplace != expected)
+		throw std::runtime_error (std::string (k.name) + " in place mismatch");
+
+	    byte_vector output (size + 40);
+	    k.xform (input.data() + src_align, output.data() + dst_align, size);
+	    if (!std::equal (expected.begin() + src_align, expected.begin() + src_align + size,
+			     output.begin() + dst_align))
+		throw std::runtime_error (std::string (k.name) + " mismatch");
+	}
+    }
+}
+
+template <class Func>
+double run (Func func, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+	func();
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    size_t size = argc > 1 ? std::strtoul (argv[1], 0, 0) : 0x1000000;
+    if (!size)
+	size = 0x1000000;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 20;
+    if (passes <= 0)
+	passes = 1;
+    int trials = argc > 3 ? std::atoi (argv[3]) : 500;
+
+    std::srand (1);
+    run_trials (trials);
+    std::printf ("%d randomized trials passed, vector width %u\n", trials,
+		 unsigned (xform::detail::vector_width));
+
+    byte_vector data = random_bytes (size);
+    byte_vector long_key = random_bytes (37);
+    std::printf ("%u bytes, %d passes, in place\n", unsigned (size), passes);
+    std::printf ("%-10s %10s %10s %8s\n", "kernel", "loop GB/s", "xform GB/s", "speedup");
+    for (const auto& k : make_kernels (long_key, 0))
+    {
+	double t_ref = run ([&] { k.ref (data.data(), data.size()); }, passes);
+	double t_new = run ([&] { k.xform (data.data(), data.data(), data.size()); }, passes);
+	const double gb = double (size) * passes / (1024*1024*1024);
+	std::printf ("%-10s %10.2f %10.2f %8.2f\n", k.name, gb / t_ref, gb / t_new, t_ref / t_new);
+    }
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "xform: %s\n", X.what());
+    return 1;
+}
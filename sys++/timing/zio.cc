@@ -0,0 +1,208 @@
+// -*- C++ -*-
+//! \file       zio.cc
+//! \date       2026 Oct 16
+//! \brief      compare zio inflate functions against inline zlib loops used by
+//              CatScene and ACD extractors.
+//
+// corpus consists of synthetic CatScene scripts and ACD blobs compressed with
+// zlib at default level.
+
+#include "zio.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> byte_vector;
+
+struct blob
+{
+    byte_vector	packed;
+    byte_vector	unpacked;
+};
+
+// output stream that only counts bytes written into it.
+
+class null_buf : public std::streambuf
+{
+public:
+    size_t count = 0;
+protected:
+    std::streamsize xsputn (const char*, std::streamsize n) override { count += n; return n; }
+    int_type overflow (int_type c) override { ++count; return c; }
+};
+
+byte_vector make_script (size_t size)
+{
+    static const char* const words[] = {
+        "\\n", "@", "[", "]", "name", "bg", "fg", "se", "bgm", "wait",
+        "the", "of", "and", "to", "in", "is", "you", "that", "it", "he",
+    };
+    const size_t word_count = sizeof(words)/sizeof(*words);
+    byte_vector text;
+    text.reserve (size + 16);
+    while (text.size() < size)
+    {
+        // binary record header followed by text
+        uint32_t id = std::rand();
+        text.insert (text.end(), (uint8_t*)&id, (uint8_t*)&id + 4);
+        int count = 2 + std::rand() % 10;
+        for (int i = 0; i < count; ++i)
+        {
+            const char* word = words[std::rand() % word_count];
+            text.insert (text.end(), word, word + std::strlen (word));
+            text.push_back (' ');
+        }
+        text.push_back (0);
+    }
+    text.resize (size);
+    return text;
+}
+
+blob make_blob (size_t size)
+{
+    blob b;
+    b.unpacked = make_script (size);
+    uLongf packed_size = compressBound (size);
+    b.packed.resize (packed_size);
+    if (compress (b.packed.data(), &packed_size, b.unpacked.data(), size) != Z_OK)
+        throw std::runtime_error ("compression failed");
+    b.packed.resize (packed_size);
+    return b;
+}
+
+// --- reference implementations ---------------------------------------------
+
+// excst/deenz: inflate through 4KB static buffer into stream.
+
+void ref_stream (const byte_vector& input, std::ostream& out)
+{
+    z_stream stream = z_stream();
+    stream.next_in = const_cast<uint8_t*> (input.data());
+    stream.avail_in = input.size();
+    static uint8_t dest[0x1000];
+    if (inflateInit (&stream) != Z_OK)
+        throw std::runtime_error ("zlib initialization error");
+    int err;
+    do
+    {
+        stream.next_out = dest;
+        stream.avail_out = sizeof(dest);
+        err = inflate (&stream, Z_NO_FLUSH);
+        if (err != Z_OK && err != Z_STREAM_END)
+            break;
+        out.write ((char*)dest, sizeof(dest) - stream.avail_out);
+    } while (0 == stream.avail_out);
+    inflateEnd (&stream);
+}
+
+// cst2txt/de_dv: single inflate call into buffer of known size.
+
+void ref_known (const byte_vector& input, uint8_t* output, size_t output_size)
+{
+    z_stream stream = z_stream();
+    stream.next_in = const_cast<uint8_t*> (input.data());
+    stream.avail_in = input.size();
+    if (inflateInit (&stream) != Z_OK)
+        throw std::runtime_error ("zlib initialization error");
+    stream.next_out = output;
+    stream.avail_out = output_size;
+    inflate (&stream, Z_NO_FLUSH);
+    inflateEnd (&stream);
+}
+
+template <class Func>
+double run (const std::vector<blob>& corpus, Func decode, int passes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; ++i)
+        for (const auto& b : corpus)
+            decode (b);
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    return t.count();
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    int count = argc > 1 ? std::atoi (argv[1]) : 200;
+    if (count <= 0)
+        count = 200;
+    int passes = argc > 2 ? std::atoi (argv[2]) : 5;
+    if (passes <= 0)
+        passes = 1;
+
+    // CatScene scripts are mostly 4..64KB, ACD blobs are larger
+    std::srand (1);
+    std::vector<blob> corpus;
+    size_t total = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        size_t size = i & 1 ? 0x10000 + std::rand() % 0x30000 : 0x1000 + std::rand() % 0xF000;
+        corpus.push_back (make_blob (size));
+        total += size;
+    }
+
+    byte_vector output;
+    null_buf nbuf;
+    std::ostream nout (&nbuf);
+    double t_ref_stream = run (corpus, [&] (const blob& b) { ref_stream (b.packed, nout); }, passes);
+    if (nbuf.count != total * passes)
+        throw std::runtime_error ("reference stream size mismatch");
+    nbuf.count = 0;
+    double t_stream = run (corpus, [&] (const blob& b) { zio::inflate_to (b.packed.data(), b.packed.size(), nout); }, passes);
+    if (nbuf.count != total * passes)
+        throw std::runtime_error ("zio stream size mismatch");
+
+    double t_ref_known = run (corpus, [&] (const blob& b) {
+        output.resize (b.unpacked.size());
+        ref_known (b.packed, output.data(), output.size());
+    }, passes);
+    double t_known = run (corpus, [&] (const blob& b) {
+        output.resize (b.unpacked.size());
+        if (zio::inflate_to (b.packed.data(), b.packed.size(), output.data(), output.size()) != output.size()
+            || output != b.unpacked)
+            throw std::runtime_error ("known size output mismatch");
+    }, passes);
+    double t_grow = run (corpus, [&] (const blob& b) {
+        zio::inflate_to (b.packed.data(), b.packed.size(), output);
+        if (output != b.unpacked)
+            throw std::runtime_error ("growable output mismatch");
+    }, passes);
+
+    // corrupted stream should be reported with data decoded up to the error
+    byte_vector broken = corpus[1].packed;
+    std::memset (&broken[broken.size() / 2], 0xFF, 16);
+    try
+    {
+        zio::inflate_to (broken.data(), broken.size(), output);
+        throw std::runtime_error ("corrupted stream passed unnoticed");
+    }
+    catch (zio::data_error& X)
+    {
+        std::printf ("corrupted stream: %s, %u bytes recovered\n", X.what(), unsigned (output.size()));
+    }
+
+    const double mb = double (total) * passes / (1024*1024);
+    std::printf ("%d blobs, %u bytes unpacked, %d passes, %s backend\n", count, unsigned (total), passes,
+                 ZIO_USE_LIBDEFLATE ? "libdeflate" : "zlib");
+    std::printf ("%-18s %10s\n", "method", "MB/s");
+    std::printf ("%-18s %10.1f\n", "4KB buffer stream", mb / t_ref_stream);
+    std::printf ("%-18s %10.1f\n", "zio stream", mb / t_stream);
+    std::printf ("%-18s %10.1f\n", "inline known size", mb / t_ref_known);
+    std::printf ("%-18s %10.1f\n", "zio known size", mb / t_known);
+    std::printf ("%-18s %10.1f\n", "zio growable", mb / t_grow);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "zio: %s\n", X.what());
+    return 1;
+}
@@ -0,0 +1,362 @@
+// -*- C++ -*-
+//! \file       xform.h
+//! \date       2026 Oct 16
+//! \brief      vectorized byte transforms used by simple script decryptors.
+//
+
+#ifndef SYS_XFORM_H
+#define SYS_XFORM_H
+
+#include "bindata.h"		// for SYSPP_SSE2, SYSPP_AVX2 and SIMD headers
+#include <cstring>
+#include <vector>
+
+/// \namespace xform
+///
+/// byte-wise transforms of memory ranges: XOR with repeating key or with
+/// keystream, rotation, addition, subtraction and negation of bits.  every
+/// function comes in two forms, (SRC, DST, SIZE, ...) that stores transformed
+/// SRC into DST, and (DATA, SIZE, ...) that transforms DATA in place.  SRC and
+/// DST either must be the same or must not overlap.
+///
+/// vector width is selected at compile time, AVX2 is used when compiler
+/// targets it (-mavx2, /arch:AVX2), otherwise SSE2 on x86, otherwise plain
+/// loops.
+
+namespace xform {
+
+namespace detail {
+
+// byte operations, each applies to a single byte and to vector registers.
+
+struct xor_op
+{
+    uint8_t	key;
+    explicit xor_op (uint8_t k) : key (k) { }
+    uint8_t operator() (uint8_t x) const { return x ^ key; }
+#if SYSPP_SSE2
+    __m128i operator() (__m128i x) const { return _mm_xor_si128 (x, _mm_set1_epi8 (key)); }
+#endif
+#if SYSPP_AVX2
+    __m256i operator() (__m256i x) const { return _mm256_xor_si256 (x, _mm256_set1_epi8 (key)); }
+#endif
+};
+
+struct add_op
+{
+    uint8_t	value;
+    explicit add_op (uint8_t v) : value (v) { }
+    uint8_t operator() (uint8_t x) const { return x + value; }
+#if SYSPP_SSE2
+    __m128i operator() (__m128i x) const { return _mm_add_epi8 (x, _mm_set1_epi8 (value)); }
+#endif
+#if SYSPP_AVX2
+    __m256i operator() (__m256i x) const { return _mm256_add_epi8 (x, _mm256_set1_epi8 (value)); }
+#endif
+};
+
+// there's no byte shifts in SSE, words are shifted and bits that crossed
+// byte boundary are masked out.
+
+struct rol_op
+{
+    unsigned	shift;		// 1..7
+    explicit rol_op (unsigned s) : shift (s) { }
+    uint8_t operator() (uint8_t x) const { return x << shift | x >> (8 - shift); }
+#if SYSPP_SSE2
+    __m128i operator() (__m128i x) const
+	{
+	    __m128i hi = _mm_and_si128 (_mm_sll_epi16 (x, _mm_cvtsi32_si128 (shift)),
+					_mm_set1_epi8 (static_cast<char> (0xFF << shift)));
+	    __m128i lo = _mm_and_si128 (_mm_srl_epi16 (x, _mm_cvtsi32_si128 (8 - shift)),
+					_mm_set1_epi8 (static_cast<char> (0xFF >> (8 - shift))));
+	    return _mm_or_si128 (hi, lo);
+	}
+#endif
+#if SYSPP_AVX2
+    __m256i operator() (__m256i x) const
+	{
+	    __m256i hi = _mm256_and_si256 (_mm256_sll_epi16 (x, _mm_cvtsi32_si128 (shift)),
+					   _mm256_set1_epi8 (static_cast<char> (0xFF << shift)));
+	    __m256i lo = _mm256_and_si256 (_mm256_srl_epi16 (x, _mm_cvtsi32_si128 (8 - shift)),
+					   _mm256_set1_epi8 (static_cast<char> (0xFF >> (8 - shift))));
+	    return _mm256_or_si256 (hi, lo);
+	}
+#endif
+};
+
+// transform_range (SRC, DST, SIZE, OP)
+// widest vectors go first, remaining bytes are transformed one by one.
+
+template <class Op>
+inline void transform_range (const uint8_t* src, uint8_t* dst, size_t size, Op op)
+{
+    size_t i = 0;
+#if SYSPP_AVX2
+    for (; i + 32 <= size; i += 32)
+    {
+	__m256i v = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i));
+	_mm256_storeu_si256 (reinterpret_cast<__m256i*> (dst + i), op (v));
+    }
+#endif
+#if SYSPP_SSE2
+    for (; i + 16 <= size; i += 16)
+    {
+	__m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+	_mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i), op (v));
+    }
+#endif
+    for (; i < size; ++i)
+	dst[i] = op (src[i]);
+}
+
+#if SYSPP_AVX2
+enum { vector_width = 32 };
+#elif SYSPP_SSE2
+enum { vector_width = 16 };
+#else
+enum { vector_width = 8 };
+#endif
+
+} // namespace detail
+
+/// xor_byte (SRC, DST, SIZE, KEY)
+///
+/// Effects: DST[i] = SRC[i] ^ KEY for i in [0, SIZE).
+
+inline void xor_byte (const uint8_t* src, uint8_t* dst, size_t size, uint8_t key)
+{
+    detail::transform_range (src, dst, size, detail::xor_op (key));
+}
+
+inline void xor_byte (uint8_t* data, size_t size, uint8_t key)
+{
+    xor_byte (data, data, size, key);
+}
+
+/// xor_key (SRC, DST, SIZE, KEY, KEY_SIZE, KEY_POS)
+///
+/// Effects: DST[i] = SRC[i] ^ KEY[(KEY_POS + i) % KEY_SIZE] for i in
+/// [0, SIZE).  KEY_POS allows to continue transform of a range split into
+/// parts.
+
+inline void xor_key (const uint8_t* src, uint8_t* dst, size_t size,
+		     const uint8_t* key, size_t key_size, size_t key_pos = 0)
+{
+    if (!key_size)
+    {
+	if (src != dst)
+	    std::memcpy (dst, src, size);
+	return;
+    }
+    if (1 == key_size)
+	return xor_byte (src, dst, size, key[0]);
+
+    // key is repeated into pattern of whole keys not shorter than a vector,
+    // followed by a vector more, so that key bytes for any position are read
+    // from pattern with a single load.
+    const size_t width = detail::vector_width;
+    const size_t period = key_size * ((width + key_size - 1) / key_size);
+    std::vector<uint8_t> pattern (period + width);
+    for (size_t i = 0; i < pattern.size(); ++i)
+	pattern[i] = key[i % key_size];
+    const uint8_t* const pat = pattern.data();
+    size_t phase = key_pos % key_size;
+    size_t i = 0;
+#if SYSPP_AVX2
+    for (; i + 32 <= size; i += 32)
+    {
+	__m256i v = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i));
+	__m256i k = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (pat + phase));
+	_mm256_storeu_si256 (reinterpret_cast<__m256i*> (dst + i), _mm256_xor_si256 (v, k));
+	phase += 32;
+	if (phase >= period)
+	    phase -= period;
+    }
+#endif
+#if SYSPP_SSE2
+    for (; i + 16 <= size; i += 16)
+    {
+	__m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+	__m128i k = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (pat + phase));
+	_mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i), _mm_xor_si128 (v, k));
+	phase += 16;
+	if (phase >= period)
+	    phase -= period;
+    }
+#else
+    for (; i + 8 <= size; i += 8)
+    {
+	uint64_t v, k;
+	std::memcpy (&v, src + i, 8);
+	std::memcpy (&k, pat + phase, 8);
+	v ^= k;
+	std::memcpy (dst + i, &v, 8);
+	phase += 8;
+	if (phase >= period)
+	    phase -= period;
+    }
+#endif
+    for (size_t j = 0; i < size; ++i, ++j)
+	dst[i] = src[i] ^ pat[phase + j];
+}
+
+inline void xor_key (uint8_t* data, size_t size, const uint8_t* key, size_t key_size, size_t key_pos = 0)
+{
+    xor_key (data, data, size, key, key_size, key_pos);
+}
+
+/// xor_stream (SRC, DST, SIZE, STREAM)
+///
+/// Effects: DST[i] = SRC[i] ^ STREAM[i] for i in [0, SIZE).  STREAM should not
+/// overlap DST.
+
+inline void xor_stream (const uint8_t* src, uint8_t* dst, size_t size, const uint8_t* stream)
+{
+    size_t i = 0;
+#if SYSPP_AVX2
+    for (; i + 32 <= size; i += 32)
+    {
+	__m256i v = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i));
+	__m256i k = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (stream + i));
+	_mm256_storeu_si256 (reinterpret_cast<__m256i*> (dst + i), _mm256_xor_si256 (v, k));
+    }
+#endif
+#if SYSPP_SSE2
+    for (; i + 16 <= size; i += 16)
+    {
+	__m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+	__m128i k = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (stream + i));
+	_mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i), _mm_xor_si128 (v, k));
+    }
+#else
+    for (; i + 8 <= size; i += 8)
+    {
+	uint64_t v, k;
+	std::memcpy (&v, src + i, 8);
+	std::memcpy (&k, stream + i, 8);
+	v ^= k;
+	std::memcpy (dst + i, &v, 8);
+    }
+#endif
+    for (; i < size; ++i)
+	dst[i] = src[i] ^ stream[i];
+}
+
+inline void xor_stream (uint8_t* data, size_t size, const uint8_t* stream)
+{
+    xor_stream (data, data, size, stream);
+}
+
+/// invert (SRC, DST, SIZE)
+///
+/// Effects: DST[i] = ~SRC[i] for i in [0, SIZE).
+
+inline void invert (const uint8_t* src, uint8_t* dst, size_t size)
+{
+    xor_byte (src, dst, size, 0xFF);
+}
+
+inline void invert (uint8_t* data, size_t size)
+{
+    xor_byte (data, data, size, 0xFF);
+}
+
+/// add (SRC, DST, SIZE, VALUE)
+///
+/// Effects: DST[i] = SRC[i] + VALUE modulo 256 for i in [0, SIZE).
+
+inline void add (const uint8_t* src, uint8_t* dst, size_t size, uint8_t value)
+{
+    detail::transform_range (src, dst, size, detail::add_op (value));
+}
+
+inline void add (uint8_t* data, size_t size, uint8_t value)
+{
+    add (data, data, size, value);
+}
+
+/// sub (SRC, DST, SIZE, VALUE)
+///
+/// Effects: DST[i] = SRC[i] - VALUE modulo 256 for i in [0, SIZE).
+
+inline void sub (const uint8_t* src, uint8_t* dst, size_t size, uint8_t value)
+{
+    add (src, dst, size, static_cast<uint8_t> (-value));
+}
+
+inline void sub (uint8_t* data, size_t size, uint8_t value)
+{
+    add (data, data, size, static_cast<uint8_t> (-value));
+}
+
+/// sub_stream (SRC, DST, SIZE, STREAM)
+///
+/// Effects: DST[i] = SRC[i] - STREAM[i] modulo 256 for i in [0, SIZE).  STREAM
+/// should not overlap DST.
+
+inline void sub_stream (const uint8_t* src, uint8_t* dst, size_t size, const uint8_t* stream)
+{
+    size_t i = 0;
+#if SYSPP_AVX2
+    for (; i + 32 <= size; i += 32)
+    {
+	__m256i v = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i));
+	__m256i k = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (stream + i));
+	_mm256_storeu_si256 (reinterpret_cast<__m256i*> (dst + i), _mm256_sub_epi8 (v, k));
+    }
+#endif
+#if SYSPP_SSE2
+    for (; i + 16 <= size; i += 16)
+    {
+	__m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+	__m128i k = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (stream + i));
+	_mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i), _mm_sub_epi8 (v, k));
+    }
+#endif
+    for (; i < size; ++i)
+	dst[i] = src[i] - stream[i];
+}
+
+inline void sub_stream (uint8_t* data, size_t size, const uint8_t* stream)
+{
+    sub_stream (data, data, size, stream);
+}
+
+/// rol (SRC, DST, SIZE, SHIFT)
+///
+/// Effects: rotates bits of every byte of SRC left by SHIFT modulo 8 and
+/// stores result into DST.
+
+inline void rol (const uint8_t* src, uint8_t* dst, size_t size, unsigned shift)
+{
+    shift &= 7;
+    if (shift)
+	detail::transform_range (src, dst, size, detail::rol_op (shift));
+    else if (src != dst)
+	std::memcpy (dst, src, size);
+}
+
+inline void rol (uint8_t* data, size_t size, unsigned shift)
+{
+    rol (data, data, size, shift);
+}
+
+/// ror (SRC, DST, SIZE, SHIFT)
+///
+/// Effects: rotates bits of every byte of SRC right by SHIFT modulo 8 and
+/// stores result into DST.
+
+inline void ror (const uint8_t* src, uint8_t* dst, size_t size, unsigned shift)
+{
+    rol (src, dst, size, 8 - (shift & 7));
+}
+
+inline void ror (uint8_t* data, size_t size, unsigned shift)
+{
+    rol (data, data, size, 8 - (shift & 7));
+}
+
+} // namespace xform
+
+#endif /* SYS_XFORM_H */
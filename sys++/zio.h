@@ -0,0 +1,339 @@
+// -*- C++ -*-
+//! \file       zio.h
+//! \date       2026 Oct 16
+//! \brief      inflate zlib streams into memory buffers or output streams.
+//
+// tools that include this header should be linked with zlib.  when compiled
+// with ZIO_USE_LIBDEFLATE defined, one-shot functions use libdeflate and fall
+// back to zlib only to locate data errors and to decode into too small
+// buffers, so libdeflate should be linked as well.
+//
+
+#ifndef SYS_ZIO_H
+#define SYS_ZIO_H
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdint>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+
+#ifndef ZIO_USE_LIBDEFLATE
+#define ZIO_USE_LIBDEFLATE 0
+#endif
+
+#if ZIO_USE_LIBDEFLATE
+#include <memory>
+#include <libdeflate.h>
+#endif
+
+namespace zio {
+
+/// \class zio::data_error
+///
+/// thrown when compressed stream is corrupted.  offset() is the position in the
+/// input where error was detected.
+
+class data_error : public std::runtime_error
+{
+public:
+    explicit data_error (size_t offset)
+	: std::runtime_error (format_message (offset)), m_offset (offset)
+	{ }
+
+    size_t offset () const { return m_offset; }
+
+private:
+    static std::string format_message (size_t offset)
+	{
+	    char buf[32];
+	    std::snprintf (buf, sizeof(buf), "zlib data error at %08llX",
+			   static_cast<unsigned long long> (offset));
+	    return buf;
+	}
+
+    size_t	m_offset;
+};
+
+/// \class zio::inflater
+///
+/// incremental zlib decompressor over a memory buffer.  output could be
+/// retrieved in chunks of arbitrary size, input could be supplied in chunks
+/// as well, see feed().
+
+class inflater
+{
+public:
+    inflater (const uint8_t* src, size_t src_size);
+    ~inflater () { inflateEnd (&m_stream); }
+
+    /// inflate (DST, DST_SIZE)
+    ///
+    /// Effects: decompresses up to DST_SIZE bytes into DST.
+    /// Returns: number of bytes written, less than DST_SIZE only when done or
+    /// when data error was encountered.  in the latter case data decoded before
+    /// the error is returned and the next call throws.
+    /// Throws: zio::data_error if stream is corrupted.
+
+    size_t inflate (uint8_t* dst, size_t dst_size);
+
+    /// done()
+    ///
+    /// Returns: true if end of compressed stream or end of input was reached.
+
+    bool done () const { return m_done; }
+
+    /// complete()
+    ///
+    /// Returns: true if end of compressed stream was reached and its checksum
+    /// matched.
+
+    bool complete () const { return m_complete; }
+
+    /// consumed()
+    ///
+    /// Returns: number of input bytes consumed so far.
+
+    size_t consumed () const { return m_offset + (m_stream.next_in - m_src); }
+
+    /// reset (SRC, SRC_SIZE)
+    ///
+    /// Effects: starts decoding of another stream, reusing allocated state.
+
+    void reset (const uint8_t* src, size_t src_size);
+
+    /// feed (SRC, SRC_SIZE)
+    ///
+    /// Effects: replaces remaining input with SRC_SIZE bytes at SRC, which
+    /// continue the stream.  should be called when done() is true while
+    /// complete() is not, i.e. when previous input is exhausted.
+
+    void feed (const uint8_t* src, size_t src_size);
+
+private:
+    inflater (const inflater&); // not defined
+    inflater& operator= (const inflater&);
+
+    const uint8_t*	m_src;
+    const uint8_t*	m_src_end;
+    size_t		m_offset;	// size of input chunks preceding m_src
+    z_stream		m_stream;
+    bool		m_done;
+    bool		m_complete;
+    bool		m_failed;	// data error is pending
+};
+
+inline inflater::
+inflater (const uint8_t* src, size_t src_size)
+    : m_src (src), m_src_end (src + src_size), m_offset (0), m_stream(), m_done (false)
+    , m_complete (false), m_failed (false)
+{
+    m_stream.next_in = const_cast<uint8_t*> (src);
+    m_stream.avail_in = static_cast<uInt> (std::min<size_t> (src_size, UINT_MAX));
+    int err = inflateInit (&m_stream);
+    if (Z_MEM_ERROR == err)
+	throw std::bad_alloc();
+    if (err != Z_OK)
+	throw std::runtime_error ("zlib initialization error");
+}
+
+inline void inflater::
+reset (const uint8_t* src, size_t src_size)
+{
+    m_src = src;
+    m_src_end = src + src_size;
+    m_stream.next_in = const_cast<uint8_t*> (src);
+    m_stream.avail_in = static_cast<uInt> (std::min<size_t> (src_size, UINT_MAX));
+    m_offset = 0;
+    m_done = m_complete = m_failed = false;
+    inflateReset (&m_stream);
+}
+
+inline void inflater::
+feed (const uint8_t* src, size_t src_size)
+{
+    m_offset += m_src_end - m_src;
+    m_src = src;
+    m_src_end = src + src_size;
+    m_stream.next_in = const_cast<uint8_t*> (src);
+    m_stream.avail_in = static_cast<uInt> (std::min<size_t> (src_size, UINT_MAX));
+    if (!m_complete)
+	m_done = false;
+}
+
+inline size_t inflater::
+inflate (uint8_t* dst, size_t dst_size)
+{
+    if (m_failed)
+	throw data_error (consumed());
+    size_t total = 0;
+    while (total < dst_size && !m_done)
+    {
+	if (!m_stream.avail_in)
+	{
+	    size_t left = m_src_end - m_stream.next_in;
+	    m_stream.avail_in = static_cast<uInt> (std::min<size_t> (left, UINT_MAX));
+	}
+	size_t avail = std::min<size_t> (dst_size - total, UINT_MAX);
+	m_stream.next_out = dst + total;
+	m_stream.avail_out = static_cast<uInt> (avail);
+	int err = ::inflate (&m_stream, Z_NO_FLUSH);
+	total += avail - m_stream.avail_out;
+	switch (err)
+	{
+	case Z_OK:
+	    break;
+	case Z_STREAM_END:
+	    m_done = m_complete = true;
+	    break;
+	case Z_BUF_ERROR:
+	    // no progress possible, input is truncated
+	    m_done = true;
+	    break;
+	case Z_MEM_ERROR:
+	    throw std::bad_alloc();
+	case Z_NEED_DICT:
+	case Z_DATA_ERROR:
+	    m_failed = true;
+	    if (!total)
+		throw data_error (consumed());
+	    return total;
+	default:
+	    throw std::runtime_error ("invalid compressed stream");
+	}
+    }
+    return total;
+}
+
+namespace detail {
+
+inline size_t inflate_zlib (const uint8_t* src, size_t src_size, std::vector<uint8_t>& output)
+{
+    inflater zs (src, src_size);
+    size_t size = 0;
+    output.resize (std::max<size_t> (src_size * 4, 0x1000));
+    try
+    {
+	while (!zs.done())
+	{
+	    if (size == output.size())
+		output.resize (size * 2);
+	    size += zs.inflate (output.data() + size, output.size() - size);
+	}
+    }
+    catch (data_error&)
+    {
+	output.resize (size);
+	throw;
+    }
+    output.resize (size);
+    return size;
+}
+
+#if ZIO_USE_LIBDEFLATE
+
+struct decompressor_deleter
+{
+    void operator() (libdeflate_decompressor* d) const { libdeflate_free_decompressor (d); }
+};
+
+typedef std::unique_ptr<libdeflate_decompressor, decompressor_deleter> decompressor_ptr;
+
+// decompressor is allocated per call, thread_local object with non-trivial
+// destructor is broken on older MinGW.
+
+inline decompressor_ptr make_decompressor ()
+{
+    decompressor_ptr d (libdeflate_alloc_decompressor());
+    if (!d)
+	throw std::bad_alloc();
+    return d;
+}
+
+#endif
+
+} // namespace detail
+
+/// inflate_to (SRC, SRC_SIZE, DST, DST_SIZE)
+///
+/// Effects: decompresses zlib stream SRC of SRC_SIZE bytes into buffer DST.
+/// decompression stops when DST_SIZE bytes are written.
+/// Returns: number of bytes written into DST.
+/// Throws: zio::data_error if stream is corrupted.
+
+inline size_t inflate_to (const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size)
+{
+#if ZIO_USE_LIBDEFLATE
+    size_t in_size, actual_size;
+    if (LIBDEFLATE_SUCCESS == libdeflate_zlib_decompress_ex (detail::make_decompressor().get(),
+					src, src_size, dst, dst_size, &in_size, &actual_size))
+	return actual_size;
+#endif
+    inflater zs (src, src_size);
+    size_t size = zs.inflate (dst, dst_size);
+    if (size < dst_size && !zs.done())
+	zs.inflate (dst + size, dst_size - size); // throws pending error
+    return size;
+}
+
+/// inflate_to (SRC, SRC_SIZE, OUTPUT)
+///
+/// Effects: decompresses zlib stream SRC of SRC_SIZE bytes, replacing contents
+/// of OUTPUT, for callers that don't know unpacked size in advance.
+/// Returns: number of bytes written.
+/// Throws: zio::data_error if stream is corrupted, OUTPUT contains data
+/// decompressed before error.
+
+inline size_t inflate_to (const uint8_t* src, size_t src_size, std::vector<uint8_t>& output)
+{
+#if ZIO_USE_LIBDEFLATE
+    auto d = detail::make_decompressor();
+    output.resize (std::max<size_t> (src_size * 4, 0x1000));
+    for (;;)
+    {
+	size_t in_size, actual_size;
+	auto rc = libdeflate_zlib_decompress_ex (d.get(), src, src_size,
+						 output.data(), output.size(), &in_size, &actual_size);
+	if (LIBDEFLATE_SUCCESS == rc)
+	{
+	    output.resize (actual_size);
+	    return actual_size;
+	}
+	if (rc != LIBDEFLATE_INSUFFICIENT_SPACE)
+	    break;
+	output.resize (output.size() * 2);
+    }
+#endif
+    return detail::inflate_zlib (src, src_size, output);
+}
+
+/// inflate_to (SRC, SRC_SIZE, OUT, BUFFER_SIZE)
+///
+/// Effects: decompresses zlib stream SRC of SRC_SIZE bytes into stream OUT
+/// through intermediate buffer of BUFFER_SIZE bytes.
+/// Returns: number of bytes written.
+/// Throws: zio::data_error if stream is corrupted, data decompressed before
+/// error is written into OUT.
+
+inline size_t inflate_to (const uint8_t* src, size_t src_size, std::ostream& out,
+			  size_t buffer_size = 0x40000)
+{
+    inflater zs (src, src_size);
+    std::vector<uint8_t> buffer (buffer_size);
+    size_t total = 0;
+    while (!zs.done())
+    {
+	size_t chunk = zs.inflate (buffer.data(), buffer.size());
+	out.write (reinterpret_cast<const char*> (buffer.data()), chunk);
+	total += chunk;
+    }
+    return total;
+}
+
+} // namespace zio
+
+#endif /* SYS_ZIO_H */
@@ -4,7 +4,8 @@
 //! \brief      compare first bytes of file and report offset where they differ.
 //
 
-#include "sysmemmap.h"
+#include "sysmmwindow.h"
+#include <algorithm>
 
 int main (int argc, char* argv[])
 try
@@ -16,21 +17,27 @@ try
     }
     sys::mapping::readonly file1 (argv[1]);
     sys::mapping::readonly file2 (argv[2]);
-    size_t common_size = std::min (file1.size(), file2.size());
+    auto common_size = std::min (file1.size(), file2.size());
     if (0 == common_size)
     {
         std::printf ("%08x: complete different\n", 0);
         return 0;
     }
-    sys::mapping::const_view<uint8_t> view1 (file1, 0, common_size);
-    sys::mapping::const_view<uint8_t> view2 (file2, 0, common_size);
-    size_t pos = 0;
-    while (pos < common_size)
+    // both readers advance in lockstep since their windows are of the same size
+    sys::mapping::window_reader view1 (file1);
+    sys::mapping::window_reader view2 (file2);
+    auto pos = common_size;
+    do
     {
-        if (view1[pos] != view2[pos])
+        auto length = std::min (view1.size(), view2.size());
+        auto diff = std::mismatch (view1.begin(), view1.begin() + length, view2.begin());
+        if (diff.first != view1.begin() + length)
+        {
+            pos = view1.offset() + (diff.first - view1.begin());
             break;
-        ++pos;
+        }
     }
+    while (view1.next() && view2.next());
     if (pos == common_size)
     {
         if (file1.size() == file2.size())
@@ -41,7 +48,7 @@ try
             std::printf ("%s: fully included into %s\n", argv[2], argv[1]);
         return 0;
     }
-    std::printf ("%08X: difference position\n", pos);
+    std::printf ("%08llX: difference position\n", static_cast<unsigned long long> (pos));
     return 0;
 }
 catch (sys::file_error& X)
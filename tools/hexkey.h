@@ -0,0 +1,49 @@
+// -*- C++ -*-
+//! \file       hexkey.h
+//! \date       2026 Oct 16
+//! \brief      parse key given as hex string on the command line.
+//
+
+#ifndef HEXKEY_H
+#define HEXKEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// parse_hex_key (HEX, KEY)
+// Effects: stores bytes of HEX into KEY in the order they're written, "A1B2C3"
+// is the key of three bytes A1, B2, C3.  odd number of digits is padded with
+// leading zero, optional 0x prefix is skipped.
+// Returns: false if HEX is empty or contains non-hex characters.
+
+template <typename CharT>
+bool parse_hex_key (const CharT* hex, std::vector<uint8_t>& key)
+{
+    if ('0' == hex[0] && ('x' == hex[1] || 'X' == hex[1]))
+        hex += 2;
+    std::size_t length = 0;
+    while (hex[length])
+        ++length;
+    if (!length)
+        return false;
+    key.assign ((length + 1) / 2, 0);
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        CharT c = hex[i];
+        unsigned digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+            return false;
+        std::size_t n = length - 1 - i;      // digit position from the right
+        key[key.size() - 1 - n / 2] |= digit << (n & 1) * 4;
+    }
+    return true;
+}
+
+#endif /* HEXKEY_H */
@@ -5,8 +5,11 @@
 //
 
 #include <string>
+#include <vector>
 #include <iostream>
-#include "sysmemmap.h"
+#include <cstdio>
+#include "sysmmwindow.h"
+#include "sysbatch.h"
 
 extern const unsigned short shift_jis_codepoints[];
 
@@ -83,13 +86,14 @@ public:
     jp_tokenizer () : jp_tokenizer (std::cout) { }
 
     void run (const uint8_t* begin, const uint8_t* end);
+    void feed (const uint8_t* begin, const uint8_t* end);
+    void end_token();
 
     const size_t min_token_length = 2;
 
 private:
     void add_sb_symbol (uint8_t symbol);
     void add_mb_symbol (uint8_t symbol);
-    void end_token();
 
     size_t      symbol_count;
     bstring     cur_token;
@@ -98,6 +102,17 @@ private:
 
 void jp_tokenizer::
 run (const uint8_t* begin, const uint8_t* end)
+{
+    feed (begin, end);
+    end_token();
+}
+
+// feed (BEGIN, END)
+// process range [BEGIN, END) without terminating current token, so that input
+// could be supplied in several chunks.
+
+void jp_tokenizer::
+feed (const uint8_t* begin, const uint8_t* end)
 {
     while (begin < end)
     {
@@ -127,7 +142,6 @@ run (const uint8_t* begin, const uint8_t* end)
             break;
         }
     }
-    end_token();
 }
 
 void jp_tokenizer::
@@ -169,20 +183,54 @@ end_token ()
     m_state = no_char;
 }
 
+void scan_strings (sys::mapping::map_base& in)
+{
+    sys::mapping::window_reader reader (in);
+
+    jp_tokenizer tok;
+    if (!reader.empty()) do
+    {
+        tok.feed (reader.begin(), reader.next_begin());
+    }
+    while (reader.next());
+    tok.end_token();
+}
+
 int wmain (int argc, wchar_t* argv[])
 try
 {
     if (argc < 2)
     {
-        std::cout << "usage: jpstrings FILE\n";
+        std::cout << "usage: jpstrings FILE...\n";
         return 0;
     }
-    sys::mapping::readonly in (argv[1]);
-    sys::mapping::const_view<uint8_t> view (in);
-
-    jp_tokenizer tok;
-    tok.run (view.begin(), view.end());
-    return 0;
+    if (2 == argc)
+    {
+        sys::mapping::readonly in (argv[1]);
+        scan_strings (in);
+        return 0;
+    }
+    // multiple files are read concurrently and reported in completion order
+    std::vector<std::wstring> names (argv + 1, argv + argc);
+    sys::batch_reader batch (names);
+    sys::batch_reader::item file;
+    int rc = 0;
+    while (batch.next (file))
+    {
+        const wchar_t* name = names[file.index].c_str();
+        if (file.error)
+        {
+            std::cout.flush();
+            std::cerr << "jpstrings: " << sys::file_error (file.error, name).what() << std::endl;
+            rc = 1;
+            continue;
+        }
+        std::cout.flush();
+        std::printf ("==> %S <==\n", name);
+        std::fflush (stdout);
+        scan_strings (file.data);
+    }
+    return rc;
 }
 catch (std::exception& X)
 {
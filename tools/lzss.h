@@ -11,5 +11,6 @@
 #include <cstdint>
 
 size_t lzss_decompress (const uint8_t* packed, size_t packed_size, std::ostream& out);
+size_t lzss_decompress (const uint8_t* packed, size_t packed_size, uint8_t* output, size_t output_size);
 
 #endif /* LZSS_H */
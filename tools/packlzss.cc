@@ -0,0 +1,137 @@
+// -*- C++ -*-
+//! \file       packlzss.cc
+//! \date       2026 Oct 16
+//! \brief      LZSS-compress files into the format read by lzss_decompress.
+//
+
+#include <atomic>
+#include <cstdio>
+#include <cwchar>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sysmemmap.h"
+#include "lzssenc.h"
+
+typedef bin::lzss_encoder<bin::lzss_params<>> encoder_type;
+
+void usage ()
+{
+    std::cout << "usage: packlzss [-g|-l|-o] INPUT OUTPUT\n"
+                 "       packlzss [-g|-l|-o] [-j THREADS] -d OUTDIR INPUT...\n"
+                 "    -g  greedy parsing (fastest)\n"
+                 "    -l  lazy parsing (default)\n"
+                 "    -o  optimal parsing (smallest output)\n"
+                 "    -j  number of files compressed concurrently\n";
+}
+
+void pack_file (encoder_type& lzss, const wchar_t* input, const wchar_t* output,
+                std::vector<uint8_t>& packed)
+{
+    sys::mapping::readonly in (input);
+    sys::mapping::const_view<uint8_t> view (in);
+    packed.clear();
+    lzss.encode (view.data(), view.size(), packed);
+    std::ofstream out (output, std::ios::out|std::ios::binary|std::ios::trunc);
+    if (!out)
+        throw std::runtime_error ("error opening output file");
+    out.write (reinterpret_cast<const char*> (packed.data()), packed.size());
+    if (!out)
+        throw std::runtime_error ("write error");
+}
+
+std::wstring output_name (const std::wstring& dir, const std::wstring& input)
+{
+    auto slash = input.find_last_of (L"/\\");
+    auto name = slash != std::wstring::npos ? input.substr (slash+1) : input;
+    return dir + L'/' + name;
+}
+
+// compress INPUTS into OUTDIR using THREADS workers, each with its own
+// encoder.  returns number of files that failed.
+
+int pack_files (const std::vector<std::wstring>& inputs, const std::wstring& outdir,
+                encoder_type::level_type level, unsigned threads)
+{
+    std::atomic<size_t> next_index (0);
+    std::atomic<int> failed (0);
+    auto worker = [&]
+    {
+        encoder_type lzss (level);
+        std::vector<uint8_t> packed;
+        for (size_t i; (i = next_index++) < inputs.size(); )
+        {
+            const auto& name = inputs[i];
+            try
+            {
+                pack_file (lzss, name.c_str(), output_name (outdir, name).c_str(), packed);
+            }
+            catch (std::exception& X)
+            {
+                std::fprintf (stderr, "%S: %s\n", name.c_str(), X.what());
+                ++failed;
+            }
+        }
+    };
+    threads = std::max (1u, std::min<unsigned> (threads, inputs.size()));
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+        pool.emplace_back (worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+    return failed;
+}
+
+int wmain (int argc, wchar_t* argv[])
+try
+{
+    auto level = encoder_type::lazy;
+    unsigned threads = std::thread::hardware_concurrency();
+    const wchar_t* outdir = nullptr;
+    int argn = 1;
+    for (; argn < argc && L'-' == argv[argn][0]; ++argn)
+    {
+        if (0 == std::wcscmp (argv[argn], L"-g"))
+            level = encoder_type::greedy;
+        else if (0 == std::wcscmp (argv[argn], L"-l"))
+            level = encoder_type::lazy;
+        else if (0 == std::wcscmp (argv[argn], L"-o"))
+            level = encoder_type::optimal;
+        else if (0 == std::wcscmp (argv[argn], L"-j") && argn + 1 < argc)
+            threads = std::wcstoul (argv[++argn], nullptr, 10);
+        else if (0 == std::wcscmp (argv[argn], L"-d") && argn + 1 < argc)
+            outdir = argv[++argn];
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (outdir)
+    {
+        if (argn == argc)
+        {
+            usage();
+            return 0;
+        }
+        std::vector<std::wstring> inputs (argv + argn, argv + argc);
+        return pack_files (inputs, outdir, level, threads) ? 1 : 0;
+    }
+    if (argc - argn != 2)
+    {
+        usage();
+        return 0;
+    }
+    encoder_type lzss (level);
+    std::vector<uint8_t> packed;
+    pack_file (lzss, argv[argn], argv[argn+1], packed);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "packlzss: %s\n", X.what());
+    return 1;
+}
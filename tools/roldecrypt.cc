@@ -5,6 +5,7 @@
 //
 
 #include "sysmemmap.h"
+#include "xform.h"
 #include <iostream>
 #include <fstream>
 #include <cwchar>
@@ -30,11 +31,7 @@ try
 
     sys::mapping::readwrite in (argv[1]);
     sys::mapping::view<uint8_t> view (in);
-    for (auto it = view.begin(); it != view.end(); ++it)
-    {
-        uint8_t x = *it;
-        *it = x << shift | x >> (8 - shift);
-    }
+    xform::rol (view.data(), view.size(), shift);
     return 0;
 }
 catch (std::exception& X)
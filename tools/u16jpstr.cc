@@ -7,7 +7,7 @@
 const size_t sjis_table_size = 32512;
 extern const unsigned short shift_jis_codepoints[];
 
-#include "sysmemmap.h"
+#include "sysmmwindow.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -84,6 +84,8 @@ public:
     }
 
     void run (const uint8_t* begin, const uint8_t* end);
+    void feed (const uint8_t* begin, const uint8_t* stop, const uint8_t* end);
+    void finish ();
 
 private:
     void add_u16 (sequence<wchar_t>& target, wchar_t c);
@@ -116,9 +118,21 @@ const uint8_t* u16_tokenizer::init_utf16_codepoints ()
 void u16_tokenizer::
 run (const uint8_t* const begin, const uint8_t* const end)
 {
+    feed (begin, end, end);
+    finish();
+}
+
+// feed (BEGIN, STOP, END)
+// process bytes in range [BEGIN, STOP), looking ahead up to END.  BEGIN should be
+// even-aligned relative to the start of input.
+
+void u16_tokenizer::
+feed (const uint8_t* const begin, const uint8_t* const stop, const uint8_t* const end)
+{
+    const size_t count = stop - begin;
     const size_t length = end - begin;
     size_t pos = 0;
-    while (pos < length)
+    while (pos < count)
     {
         const size_t current_pos = pos;
         auto byte0 = begin[pos++];
@@ -131,6 +145,11 @@ run (const uint8_t* const begin, const uint8_t* const end)
             add_u16 (u16[current_pos & 1], w0);
         }
     }
+}
+
+void u16_tokenizer::
+finish ()
+{
     if (u16[0].size() >= u16[1].size() && u16[0].bytes_size() >= u16[2].size())
     {
         if (u16[0].size() >= min_token_length)
@@ -199,13 +218,19 @@ try
         return 0;
     }
     sys::mapping::readonly in (argv[1]);
-    sys::mapping::const_view<uint8_t> view (in);
+    // windows overlap so that utf-16 pairs spanning window boundary are seen
+    sys::mapping::window_reader reader (in, sys::mapping::window_reader::default_window_size, 1);
     std::ofstream out (argv[2], std::ios::out|std::ios::trunc|std::ios::binary);
     wchar_t bom = L'\xFEFF';
     out.write (reinterpret_cast<char*> (&bom), 2);
 
     u16_tokenizer tok (out);
-    tok.run (view.begin(), view.end());
+    if (!reader.empty()) do
+    {
+        tok.feed (reader.begin(), reader.next_begin(), reader.end());
+    }
+    while (reader.next());
+    tok.finish();
     return 0;
 }
 catch (std::exception& X)
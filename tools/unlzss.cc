@@ -4,17 +4,78 @@
 //! \brief      LZSS-decopress file.
 //
 
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <vector>
 #include "sysmemmap.h"
 #include "lzss.h"
+#include "lzssdec.h"
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+void usage ()
+{
+    std::cout << "usage: unlz INPUT OUTPUT\n"
+                 "       unlz --stdin [OUTPUT]\n"
+                 "    --stdin  read compressed stream from standard input and write\n"
+                 "             into OUTPUT or standard output\n";
+}
+
+// decode standard input as it arrives, memory use doesn't depend on stream
+// length.
+
+int unpack_stdin (const char* output)
+{
+    std::FILE* out = stdout;
+    if (output && std::strcmp (output, "-") != 0)
+    {
+        out = std::fopen (output, "wb");
+        if (!out)
+        {
+            std::cerr << output << ": error opening output file\n";
+            return 1;
+        }
+    }
+#ifdef _WIN32
+    _setmode (_fileno (stdin), _O_BINARY);
+    if (stdout == out)
+        _setmode (_fileno (stdout), _O_BINARY);
+#endif
+    bin::lzss_push_decoder<bin::lzss_params<>> lzss;
+    std::vector<uint8_t> buffer (0x10000);
+    bool write_error = false;
+    auto sink = [&] (const uint8_t* data, size_t size) {
+        if (std::fwrite (data, 1, size, out) != size)
+            write_error = true;
+    };
+    size_t n;
+    while (!write_error && (n = std::fread (buffer.data(), 1, buffer.size(), stdin)) != 0)
+        lzss.push (buffer.data(), n, sink);
+    bool read_error = std::ferror (stdin) != 0;
+    if (std::fflush (out) != 0)
+        write_error = true;
+    if (out != stdout)
+        std::fclose (out);
+    if (read_error || write_error)
+    {
+        std::cerr << (read_error ? "read error\n" : "write error\n");
+        return 1;
+    }
+    return 0;
+}
 
 int main (int argc, char* argv[])
 try
 {
+    if (argc > 1 && 0 == std::strcmp (argv[1], "--stdin"))
+        return unpack_stdin (argc > 2 ? argv[2] : nullptr);
     if (argc < 3)
     {
-        std::cout << "usage: unlz INPUT OUTPUT\n";
+        usage();
         return 0;
     }
     sys::mapping::readonly in (argv[1]);
@@ -5,71 +5,359 @@
 //
 
 #include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
-#include <zlib.h>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
 #include "sysmemmap.h"
+#include "zio.h"
 
-int main (int argc, char* argv[])
-try
+namespace {
+
+void usage ()
+{
+    std::cout << "usage: unzlib INPUT OUTPUT\n"
+                 "       unzlib -c [-j THREADS] INPUT [OUTDIR]\n"
+                 "    -c  carve zlib streams embedded in INPUT, each stream is written\n"
+                 "        into OUTDIR/INPUT.OFFSET\n"
+                 "    -j  number of scanning threads\n";
+}
+
+int inflate_file (const char* input, const char* output)
 {
-    if (argc < 3)
+    sys::mapping::readonly in (input);
+    sys::mapping::const_view<uint8_t> view (in);
+
+    // unpacked size is unknown, start with an estimate and let output grow
+    zio::inflater zs (view.data(), view.size());
+    sys::mapping::output_file out (output, view.size() * 4);
+    size_t total = 0;
+    try
     {
-        std::cout << "usage: unzlib INPUT OUTPUT\n";
-        return 0;
+        while (!zs.done())
+        {
+            if (total == out.capacity())
+                out.reserve (total + 1);
+            total += zs.inflate (out.data() + total, out.capacity() - total);
+        }
+    }
+    catch (zio::data_error& X)
+    {
+        out.commit (total);
+        std::cerr << X.what() << '\n';
+        return 3;
     }
+    out.commit (total);
+    std::printf ("%s -> %s [EOF:%08llX]\n", input, output,
+                 static_cast<unsigned long long> (zs.consumed()));
+    return 0;
+}
 
-    sys::mapping::readonly in (argv[1]);
-    sys::mapping::const_view<uint8_t> view (in);
+// --- carving ---------------------------------------------------------------
+
+// find_cmf (P, END)
+// Returns: pointer to the first byte in [P, END) that could be CMF byte of
+// zlib header, i.e. compression method 8 with window size up to 32K, or END.
+
+const uint8_t* find_cmf (const uint8_t* p, const uint8_t* const end)
+{
+    const uint64_t ones = 0x0101010101010101ull;
+    for (; end - p >= 8; p += 8)
+    {
+        uint64_t word;
+        std::memcpy (&word, p, 8);
+        // bytes 0x08, 0x18 .. 0x78 become zero
+        uint64_t x = (word & ones * 0x8F) ^ ones * 8;
+        if ((x - ones) & ~x & ones * 0x80)
+            break;
+    }
+    for (; p != end; ++p)
+        if (8 == (*p & 0x8F))
+            return p;
+    return end;
+}
 
-    z_stream stream = { 0 };
-    stream.next_in = const_cast<uint8_t*> (view.data());
-    stream.avail_in = view.size();
-    static uint8_t dest[0x1000];
-    int err = inflateInit (&stream);
-    if (err != Z_OK)
+// is_zlib_header (P, END)
+// Returns: true if P points to zlib header with window size up to 32K, valid
+// check bits and no preset dictionary, followed by deflate block of valid type.
+// stored block length should match its complement, dynamic block code counts
+// should be within limits.
+
+bool is_zlib_header (const uint8_t* p, const uint8_t* end)
+{
+    if (end - p < 3)
+        return false;
+    unsigned cmf = p[0], flg = p[1];
+    if ((flg & 0x20) || (cmf << 8 | flg) % 31 != 0)
+        return false;
+    unsigned block_type = p[2] >> 1 & 3;
+    if (3 == block_type)
+        return false;
+    if (0 == block_type)
+    {
+        if (end - p < 7)
+            return false;
+        unsigned len = p[3] | p[4] << 8;
+        unsigned nlen = p[5] | p[6] << 8;
+        return len == (~nlen & 0xFFFF);
+    }
+    if (2 == block_type)
     {
-        std::cerr << "zlib initialization error\n";
-        return 2;
+        // dynamic block defines at most 286 literal and 30 distance codes
+        if (end - p < 4)
+            return false;
+        unsigned bits = p[2] | p[3] << 8;
+        return (bits >> 3 & 0x1F) <= 29 && (bits >> 8 & 0x1F) <= 29;
     }
-    std::ofstream out;
-    do
+    return true;
+}
+
+struct carved_stream
+{
+    size_t	offset;
+    size_t	packed_size;
+    size_t	unpacked_size;
+
+    bool operator< (const carved_stream& other) const { return offset < other.offset; }
+};
+
+class carver
+{
+public:
+    carver (const uint8_t* data, size_t size, const std::string& prefix)
+        : m_data (data), m_end (data + size), m_prefix (prefix), m_next_chunk (0)
+        , m_failed (false)
+        { }
+
+    void run (unsigned threads);
+
+    std::vector<carved_stream>& streams () { return m_streams; }
+
+private:
+    // files are scanned in chunks of this size, streams found in one chunk
+    // may extend into the following ones.
+    enum { chunk_size = 0x400000 };
+
+    void worker ();
+    void scan_chunk (const uint8_t* chunk, const uint8_t* chunk_end,
+                     zio::inflater& zs, std::vector<uint8_t>& output);
+    bool try_inflate (const uint8_t* src, zio::inflater& zs, std::vector<uint8_t>& output,
+                      size_t& unpacked_size);
+    void save (const uint8_t* src, size_t packed_size, const uint8_t* data, size_t size);
+    std::string file_name (size_t offset) const;
+
+    const uint8_t*		m_data;
+    const uint8_t*		m_end;
+    std::string			m_prefix;
+    std::atomic<size_t>		m_next_chunk;
+    std::atomic<bool>		m_failed;
+    std::mutex			m_lock;
+    std::vector<carved_stream>	m_streams;
+    std::exception_ptr		m_error;	// first exception thrown by a worker
+};
+
+void carver::run (unsigned threads)
+{
+    size_t chunk_count = (m_end - m_data + chunk_size - 1) / chunk_size;
+    threads = std::max (1u, std::min<unsigned> (threads, chunk_count));
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+        pool.emplace_back (&carver::worker, this);
+    worker();
+    for (auto& t : pool)
+        t.join();
+    if (m_error)
+        std::rethrow_exception (m_error);
+    std::sort (m_streams.begin(), m_streams.end());
+
+    // stream that crosses chunk boundary is skipped only by the thread that
+    // found it, candidates inside it found by other threads are dropped.
+    size_t covered = 0;
+    auto last = m_streams.begin();
+    for (const auto& stream : m_streams)
     {
-        stream.next_out = dest;
-        stream.avail_out = sizeof(dest);
-        err = inflate (&stream, Z_NO_FLUSH);
-        if (Z_STREAM_ERROR == err)
-            throw std::runtime_error ("invalid compressed stream");
-        switch (err)
+        if (stream.offset < covered)
         {
-        case Z_NEED_DICT:
-            err = Z_DATA_ERROR;
-            /* FALL THROUGH */
-        case Z_DATA_ERROR:
-        case Z_MEM_ERROR:
-            inflateEnd (&stream);
-            std::cerr << "zlib data error at " << std::hex << (stream.next_in - view.data()) << '\n';
-            return 3;
+            std::remove (file_name (stream.offset).c_str());
+            continue;
         }
-        if (!out.is_open())
+        covered = stream.offset + stream.packed_size;
+        *last++ = stream;
+    }
+    m_streams.erase (last, m_streams.end());
+}
+
+// exceptions are passed to run(), which rethrows the first one after all
+// threads are joined.
+
+void carver::worker ()
+try
+{
+    zio::inflater zs (m_data, 0);
+    std::vector<uint8_t> output (0x10000);
+    while (!m_failed)
+    {
+        size_t chunk_pos = m_next_chunk++ * chunk_size;
+        if (chunk_pos >= static_cast<size_t> (m_end - m_data))
+            break;
+        const uint8_t* chunk = m_data + chunk_pos;
+        const uint8_t* chunk_end = chunk + std::min<size_t> (chunk_size, m_end - chunk);
+        scan_chunk (chunk, chunk_end, zs, output);
+    }
+}
+catch (std::exception&)
+{
+    std::lock_guard<std::mutex> lock (m_lock);
+    if (!m_error)
+        m_error = std::current_exception();
+    m_failed = true;
+}
+
+void carver::scan_chunk (const uint8_t* p, const uint8_t* chunk_end,
+                         zio::inflater& zs, std::vector<uint8_t>& output)
+{
+    while ((p = find_cmf (p, chunk_end)) != chunk_end)
+    {
+        size_t unpacked_size;
+        if (is_zlib_header (p, m_end) && try_inflate (p, zs, output, unpacked_size))
+        {
+            save (p, zs.consumed(), output.data(), unpacked_size);
+            // don't look for headers inside compressed data
+            p += zs.consumed();
+            if (p >= chunk_end)
+                break;
+        }
+        else
+            ++p;
+    }
+}
+
+// try_inflate (SRC, ZS, OUTPUT, UNPACKED_SIZE)
+// Effects: inflates stream at SRC into OUTPUT, which only grows.
+// Returns: true if stream was decoded up to its end and checksum matched.
+// false candidates are dropped as soon as output exceeds what deflate could
+// produce from consumed input, streams that don't fit into memory are skipped.
+
+bool carver::try_inflate (const uint8_t* src, zio::inflater& zs, std::vector<uint8_t>& output,
+                          size_t& unpacked_size)
+{
+    // deflate expands at most 1032 times, 258 bytes per 2-bit match code
+    const size_t max_ratio = 1032;
+    zs.reset (src, m_end - src);
+    size_t total = 0;
+    try
+    {
+        while (!zs.done())
         {
-            out.open (argv[2], std::ios::out|std::ios::binary);
-            if (!out)
+            if (total == output.size())
             {
-                std::cerr << argv[2] << ": unable to open output file for writing\n";
-                return 4;
+                if (total / max_ratio > zs.consumed())
+                    return false;
+                output.resize (total * 2);
             }
+            total += zs.inflate (output.data() + total, output.size() - total);
         }
-        int have = 0x1000 - stream.avail_out;
-        out.write ((char*)dest, have);
-    } while (0 == stream.avail_out);
-    uint8_t* z_end = stream.next_in;
-    inflateEnd (&stream);
-    std::printf ("%s -> %s [EOF:%08X]\n", argv[1], argv[2], (z_end - view.data()));
+    }
+    catch (zio::data_error&)
+    {
+        return false;
+    }
+    catch (std::bad_alloc&)
+    {
+        std::vector<uint8_t> (0x10000).swap (output);
+        std::lock_guard<std::mutex> lock (m_lock);
+        std::fprintf (stderr, "%08llX: stream too large, skipped\n",
+                      static_cast<unsigned long long> (src - m_data));
+        return false;
+    }
+    unpacked_size = total;
+    return zs.complete() && total != 0;
+}
+
+void carver::save (const uint8_t* src, size_t packed_size, const uint8_t* data, size_t size)
+{
+    carved_stream stream = { static_cast<size_t> (src - m_data), packed_size, size };
+    std::string name = file_name (stream.offset);
+    std::ofstream out (name, std::ios::out|std::ios::binary|std::ios::trunc);
+    out.write (reinterpret_cast<const char*> (data), size);
+    if (!out)
+    {
+        std::lock_guard<std::mutex> lock (m_lock);
+        std::cerr << name << ": write error\n";
+        return;
+    }
+    std::lock_guard<std::mutex> lock (m_lock);
+    m_streams.push_back (stream);
+}
+
+std::string carver::file_name (size_t offset) const
+{
+    char suffix[24];
+    std::snprintf (suffix, sizeof(suffix), ".%08llX", static_cast<unsigned long long> (offset));
+    return m_prefix + suffix;
+}
+
+int carve_file (const char* input, const char* outdir, unsigned threads)
+{
+    sys::mapping::readonly in (input);
+    sys::mapping::const_view<uint8_t> view (in, 0, 0, sys::mapping::sequential);
+
+    std::string name (input);
+    auto slash = name.find_last_of ("/\\");
+    if (slash != std::string::npos)
+        name.erase (0, slash+1);
+    std::string prefix = outdir ? std::string (outdir) + '/' + name : name;
+
+    carver zc (view.data(), view.size(), prefix);
+    zc.run (threads);
+    for (const auto& s : zc.streams())
+        std::printf ("%08llX: %llu -> %llu\n", static_cast<unsigned long long> (s.offset),
+                     static_cast<unsigned long long> (s.packed_size),
+                     static_cast<unsigned long long> (s.unpacked_size));
+    std::printf ("%s: %llu streams found\n", input,
+                 static_cast<unsigned long long> (zc.streams().size()));
     return 0;
 }
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    bool carve = false;
+    unsigned threads = std::thread::hardware_concurrency();
+    int argn = 1;
+    for (; argn < argc && '-' == argv[argn][0]; ++argn)
+    {
+        if (0 == std::strcmp (argv[argn], "-c"))
+            carve = true;
+        else if (0 == std::strcmp (argv[argn], "-j") && argn + 1 < argc)
+            threads = std::strtoul (argv[++argn], nullptr, 10);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (carve && argc - argn >= 1)
+        return carve_file (argv[argn], argn + 1 < argc ? argv[argn+1] : nullptr, threads);
+    if (carve || argc - argn < 2)
+    {
+        usage();
+        return 0;
+    }
+    return inflate_file (argv[argn], argv[argn+1]);
+}
 catch (std::exception& X)
 {
-    std::cerr << argv[1] << ": " << X.what() << '\n';
+    std::cerr << "unzlib: " << X.what() << '\n';
     return 1;
 }
@@ -0,0 +1,594 @@
+// -*- C++ -*-
+//! \file       xform.cc
+//! \date       2026 Oct 16
+//! \brief      run file through a chain of transforms and decoders.
+//
+// pipeline is described by a string like
+//
+//   skip:bytes=12 | xor:key=7C | lzss:frame=4096,init=0xFEE | zlib
+//
+// file is mapped read-only and passed to the first stage in blocks, every
+// stage hands its output to the next one in blocks as well, so intermediate
+// results never exist as a whole.
+
+#include "sysmemmap.h"
+#include "lzssdec.h"
+#include "xform.h"
+#include "zio.h"
+#include "hexkey.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+// blocks passed between stages stay within L2 cache
+enum { block_size = 0x8000 };
+
+void usage ()
+{
+    std::fputs ("usage: xform INPUT OUTPUT PIPELINE\n"
+		"    OUTPUT    output file name, '-' for standard output\n"
+		"    PIPELINE  stages separated by '|', each is NAME[:KEY=VALUE,...]\n"
+		"\n"
+		"    skip:bytes=N           drop first N bytes\n"
+		"    xor:key=HEX            XOR with key of one or more bytes, 'A1B2' is A1 B2\n"
+		"    not                    invert bits\n"
+		"    add:value=N            add N to every byte\n"
+		"    sub:value=N            subtract N from every byte\n"
+		"    rol:shift=N            rotate bits of every byte left\n"
+		"    ror:shift=N            rotate bits of every byte right\n"
+		"    lzss:frame=4096,init=0xFEE,min=3,fill=0,order=lsb,invert=0\n"
+		"                           LZSS with frame of 1K..32K, offset bits are in\n"
+		"                           the high bits of the second reference byte,\n"
+		"                           invert=1 if count bits are stored inverted\n"
+		"    zlib                   inflate zlib stream\n"
+		"\n"
+		"example: xform arc.dat arc.txt \"skip:bytes=12 | xor:key=7C | lzss\"\n", stdout);
+}
+
+typedef std::chrono::steady_clock clock_type;
+
+// --- stages ----------------------------------------------------------------
+
+/// \class stage
+///
+/// pipeline element, receives data through push() and passes its output to
+/// the next stage.  the last stage is a writer.  time spent in every call
+/// is accumulated, time of the stage itself is what remains after time of
+/// the next stage is subtracted.  throughput is reported over the larger of
+/// input and output, which is unpacked size for decoders.
+
+class stage
+{
+public:
+    explicit stage (const std::string& name)
+	: m_name (name), m_next (nullptr), m_in (0), m_out (0), m_elapsed (0)
+	{ }
+    virtual ~stage () { }
+
+    void link (stage* next) { m_next = next; }
+
+    void push (const uint8_t* data, size_t size)
+	{
+	    auto start = clock_type::now();
+	    m_in += size;
+	    process (data, size);
+	    m_elapsed += clock_type::now() - start;
+	}
+
+    void finish ()
+	{
+	    auto start = clock_type::now();
+	    flush();
+	    if (m_next)
+		m_next->finish();
+	    m_elapsed += clock_type::now() - start;
+	}
+
+    const std::string& name () const { return m_name; }
+    const stage* next () const { return m_next; }
+    size_t bytes_in () const { return m_in; }
+    size_t bytes_out () const { return m_out; }
+    double seconds () const { return std::chrono::duration<double> (m_elapsed).count(); }
+
+protected:
+    virtual void process (const uint8_t* data, size_t size) = 0;
+    virtual void flush () { }
+
+    void emit (const uint8_t* data, size_t size)
+	{
+	    m_out += size;
+	    if (m_next)
+		m_next->push (data, size);
+	}
+
+private:
+    std::string		m_name;
+    stage*		m_next;
+    size_t		m_in;
+    size_t		m_out;
+    clock_type::duration m_elapsed;
+};
+
+class skip_stage : public stage
+{
+public:
+    skip_stage (const std::string& name, size_t count) : stage (name), m_left (count) { }
+
+protected:
+    void process (const uint8_t* data, size_t size)
+	{
+	    size_t n = std::min (m_left, size);
+	    m_left -= n;
+	    if (size > n)
+		emit (data + n, size - n);
+	}
+
+private:
+    size_t	m_left;
+};
+
+/// \class byte_stage
+///
+/// byte transform from xform.h.  input belongs to previous stage and may not
+/// be modified, it is transformed into a block buffer of the stage.
+/// Transform (SRC, DST, SIZE, POS) gets POS as stream offset of SRC.
+
+template <class Transform>
+class byte_stage : public stage
+{
+public:
+    byte_stage (const std::string& name, Transform transform)
+	: stage (name), m_transform (transform), m_buffer (block_size)
+	{ }
+
+protected:
+    void process (const uint8_t* data, size_t size)
+	{
+	    while (size)
+	    {
+		size_t n = std::min<size_t> (size, block_size);
+		m_transform (data, m_buffer.data(), n, bytes_in() - size);
+		emit (m_buffer.data(), n);
+		data += n;
+		size -= n;
+	    }
+	}
+
+private:
+    Transform			m_transform;
+    std::vector<uint8_t>	m_buffer;
+};
+
+template <class Transform>
+std::unique_ptr<stage> make_byte_stage (const std::string& name, Transform transform)
+{
+    return std::unique_ptr<stage> (new byte_stage<Transform> (name, transform));
+}
+
+// LZSS layouts of tools in this tree differ in frame size, initial position,
+// minimal match length and frame contents.  match reference is always low
+// byte of offset followed by byte with high bits of offset above the count,
+// count bits are stored either as is or inverted (bcs).
+// frame size and flag order are template parameters of the decoder, the rest
+// is kept in Params instance owned by the decoder.
+
+struct lzss_settings
+{
+    unsigned	frame_bits;
+    unsigned	init_pos;
+    unsigned	min_match;
+    uint8_t	fill;
+    bool	msb_first;
+    bool	invert;
+};
+
+template <unsigned FrameBits, class Order>
+struct runtime_lzss : bin::lzss_params<1u << FrameBits, 0, Order>
+{
+    enum { count_bits = 16 - FrameBits };
+
+    unsigned	init_pos;
+    unsigned	min_match;
+    unsigned	count_xor;	// count bits mask if count is inverted, 0 otherwise
+    uint8_t	fill;
+
+    explicit runtime_lzss (const lzss_settings& s)
+	: init_pos (s.init_pos), min_match (s.min_match)
+	, count_xor (s.invert ? (1u << count_bits) - 1 : 0), fill (s.fill)
+	{ }
+
+    void init_frame (uint8_t* frame) const
+	{ std::memset (frame, fill, 1u << FrameBits); }
+
+    void decode_ref (unsigned lo, unsigned hi, unsigned& offset, unsigned& count) const
+	{
+	    offset = lo | (hi >> count_bits) << 8;
+	    count = ((hi ^ count_xor) & ((1u << count_bits) - 1)) + min_match;
+	}
+};
+
+template <class Params>
+class lzss_stage : public stage
+{
+public:
+    lzss_stage (const std::string& name, const lzss_settings& settings)
+	: stage (name), m_lzss (Params (settings), block_size)
+	{ }
+
+protected:
+    void process (const uint8_t* data, size_t size)
+	{
+	    m_lzss.push (data, size, [this] (const uint8_t* out, size_t n) { emit (out, n); });
+	}
+
+private:
+    bin::lzss_push_decoder<Params> m_lzss;
+};
+
+template <unsigned FrameBits>
+std::unique_ptr<stage> make_lzss_stage (const std::string& name, const lzss_settings& s)
+{
+    if (s.msb_first)
+	return std::unique_ptr<stage> (new lzss_stage<runtime_lzss<FrameBits, bin::msb_first>> (name, s));
+    else
+	return std::unique_ptr<stage> (new lzss_stage<runtime_lzss<FrameBits, bin::lsb_first>> (name, s));
+}
+
+std::unique_ptr<stage> make_lzss_stage (const std::string& name, const lzss_settings& s)
+{
+    switch (s.frame_bits)
+    {
+    case 10: return make_lzss_stage<10> (name, s);
+    case 11: return make_lzss_stage<11> (name, s);
+    case 12: return make_lzss_stage<12> (name, s);
+    case 13: return make_lzss_stage<13> (name, s);
+    case 14: return make_lzss_stage<14> (name, s);
+    case 15: return make_lzss_stage<15> (name, s);
+    default: throw std::runtime_error ("lzss: frame should be power of two from 1024 to 32768");
+    }
+}
+
+class zlib_stage : public stage
+{
+public:
+    explicit zlib_stage (const std::string& name)
+	: stage (name), m_zs (nullptr, 0), m_buffer (block_size)
+	{ }
+
+protected:
+    void process (const uint8_t* data, size_t size)
+	{
+	    if (m_zs.complete())	// data past the end of stream is ignored
+		return;
+	    m_zs.feed (data, size);
+	    size_t n;
+	    do
+	    {
+		n = m_zs.inflate (m_buffer.data(), m_buffer.size());
+		emit (m_buffer.data(), n);
+	    }
+	    while (n == m_buffer.size());
+	}
+
+    void flush ()
+	{
+	    if (!m_zs.complete())
+		std::fprintf (stderr, "%s: unexpected end of stream\n", name().c_str());
+	}
+
+private:
+    zio::inflater		m_zs;
+    std::vector<uint8_t>	m_buffer;
+};
+
+class writer : public stage
+{
+public:
+    explicit writer (std::FILE* out) : stage ("write"), m_out (out) { }
+
+protected:
+    void process (const uint8_t* data, size_t size)
+	{
+	    if (std::fwrite (data, 1, size, m_out) != size)
+		throw std::runtime_error ("write error");
+	}
+
+    void flush ()
+	{
+	    if (std::fflush (m_out) != 0)
+		throw std::runtime_error ("write error");
+	}
+
+private:
+    std::FILE*	m_out;
+};
+
+// --- pipeline description --------------------------------------------------
+
+std::string trim (const std::string& s)
+{
+    const char* const space = " \t";
+    size_t first = s.find_first_not_of (space);
+    if (std::string::npos == first)
+	return std::string();
+    return s.substr (first, s.find_last_not_of (space) - first + 1);
+}
+
+std::vector<std::string> split (const std::string& s, char delim)
+{
+    std::vector<std::string> parts;
+    size_t pos = 0, next;
+    while ((next = s.find (delim, pos)) != std::string::npos)
+    {
+	parts.push_back (trim (s.substr (pos, next - pos)));
+	pos = next + 1;
+    }
+    parts.push_back (trim (s.substr (pos)));
+    return parts;
+}
+
+/// \class stage_spec
+///
+/// name of the stage and its KEY=VALUE parameters.  every parameter should
+/// be retrieved by the stage, leftovers are reported as errors.
+
+class stage_spec
+{
+public:
+    explicit stage_spec (const std::string& text);
+
+    const std::string& name () const { return m_name; }
+    const std::string& text () const { return m_text; }
+
+    /// number (KEY, DEFAULT_VALUE)
+    ///
+    /// Returns: value of parameter KEY in C notation, decimal or hexadecimal
+    /// with 0x prefix, DEFAULT_VALUE if it's not specified.
+
+    unsigned long number (const char* key, unsigned long default_value);
+
+    /// bytes (KEY)
+    ///
+    /// Returns: value of parameter KEY as hex string, bytes in the order they
+    /// are written.  odd number of digits is padded with leading zero.
+
+    std::vector<uint8_t> bytes (const char* key);
+
+    /// word (KEY, DEFAULT_VALUE)
+    ///
+    /// Returns: value of parameter KEY as is.
+
+    std::string word (const char* key, const char* default_value);
+
+    /// check_unused()
+    ///
+    /// Throws: std::runtime_error if some parameter wasn't retrieved.
+
+    void check_unused () const;
+
+private:
+    bool take (const char* key, std::string& value);
+    void error (const std::string& message) const
+	{ throw std::runtime_error (m_name + ": " + message); }
+
+    std::string		m_text;
+    std::string		m_name;
+    std::vector<std::pair<std::string, std::string>> m_params;
+};
+
+stage_spec::
+stage_spec (const std::string& text) : m_text (text)
+{
+    size_t colon = text.find (':');
+    m_name = trim (text.substr (0, colon));
+    if (m_name.empty())
+	throw std::runtime_error ("empty stage in pipeline");
+    if (std::string::npos == colon)
+	return;
+    for (const auto& param : split (text.substr (colon + 1), ','))
+    {
+	size_t eq = param.find ('=');
+	if (std::string::npos == eq)
+	    error ("parameter '" + param + "' should be KEY=VALUE");
+	m_params.emplace_back (trim (param.substr (0, eq)), trim (param.substr (eq + 1)));
+    }
+}
+
+bool stage_spec::
+take (const char* key, std::string& value)
+{
+    auto it = std::find_if (m_params.begin(), m_params.end(),
+			    [key] (const std::pair<std::string, std::string>& p) { return p.first == key; });
+    if (it == m_params.end())
+	return false;
+    value = it->second;
+    m_params.erase (it);
+    return true;
+}
+
+unsigned long stage_spec::
+number (const char* key, unsigned long default_value)
+{
+    std::string value;
+    if (!take (key, value))
+	return default_value;
+    char* end;
+    unsigned long n = std::strtoul (value.c_str(), &end, 0);
+    if (value.empty() || *end)
+	error (std::string ("invalid ") + key + " value '" + value + "'");
+    return n;
+}
+
+std::vector<uint8_t> stage_spec::
+bytes (const char* key)
+{
+    std::string hex;
+    if (!take (key, hex))
+	error (std::string ("missing ") + key);
+    std::vector<uint8_t> data;
+    if (!parse_hex_key (hex.c_str(), data))
+	error (std::string ("invalid ") + key + " '" + hex + "'");
+    return data;
+}
+
+std::string stage_spec::
+word (const char* key, const char* default_value)
+{
+    std::string value;
+    return take (key, value) ? value : std::string (default_value);
+}
+
+void stage_spec::
+check_unused () const
+{
+    if (!m_params.empty())
+	error ("unknown parameter '" + m_params.front().first + "'");
+}
+
+std::unique_ptr<stage> make_stage (stage_spec& spec)
+{
+    const std::string& name = spec.name();
+    std::unique_ptr<stage> st;
+    if ("skip" == name)
+    {
+	st.reset (new skip_stage (spec.text(), spec.number ("bytes", 0)));
+    }
+    else if ("xor" == name)
+    {
+	auto key = spec.bytes ("key");
+	st = make_byte_stage (spec.text(), [key] (const uint8_t* src, uint8_t* dst, size_t size, size_t pos) {
+	    xform::xor_key (src, dst, size, key.data(), key.size(), pos);
+	});
+    }
+    else if ("not" == name)
+    {
+	st = make_byte_stage (spec.text(), [] (const uint8_t* src, uint8_t* dst, size_t size, size_t) {
+	    xform::invert (src, dst, size);
+	});
+    }
+    else if ("add" == name || "sub" == name)
+    {
+	uint8_t value = static_cast<uint8_t> (spec.number ("value", 0));
+	if ("sub" == name)
+	    value = static_cast<uint8_t> (-value);
+	st = make_byte_stage (spec.text(), [value] (const uint8_t* src, uint8_t* dst, size_t size, size_t) {
+	    xform::add (src, dst, size, value);
+	});
+    }
+    else if ("rol" == name || "ror" == name)
+    {
+	unsigned shift = spec.number ("shift", 0) & 7;
+	if ("ror" == name)
+	    shift = (8 - shift) & 7;
+	st = make_byte_stage (spec.text(), [shift] (const uint8_t* src, uint8_t* dst, size_t size, size_t) {
+	    xform::rol (src, dst, size, shift);
+	});
+    }
+    else if ("lzss" == name)
+    {
+	unsigned long frame = spec.number ("frame", 0x1000);
+	lzss_settings s;
+	s.frame_bits = 0;
+	while (s.frame_bits < 16 && (1ul << s.frame_bits) < frame)
+	    ++s.frame_bits;
+	if (frame != 1ul << s.frame_bits)
+	    s.frame_bits = 0;
+	s.init_pos = spec.number ("init", frame - 18) & (frame - 1);
+	s.min_match = spec.number ("min", 3);
+	s.fill = static_cast<uint8_t> (spec.number ("fill", 0));
+	std::string order = spec.word ("order", "lsb");
+	if (order != "lsb" && order != "msb")
+	    throw std::runtime_error ("lzss: order should be lsb or msb");
+	s.msb_first = "msb" == order;
+	s.invert = spec.number ("invert", 0) != 0;
+	st = make_lzss_stage (spec.text(), s);
+    }
+    else if ("zlib" == name)
+    {
+	st.reset (new zlib_stage (spec.text()));
+    }
+    else
+	throw std::runtime_error ("unknown stage '" + name + "'");
+    spec.check_unused();
+    return st;
+}
+
+void report (const stage* first)
+{
+    std::fprintf (stderr, "%-40s %12s %12s %8s %10s\n", "stage", "in", "out", "seconds", "MB/s");
+    for (const stage* st = first; st; st = st->next())
+    {
+	double self = st->seconds() - (st->next() ? st->next()->seconds() : 0);
+	self = std::max (self, 1e-9);
+	std::fprintf (stderr, "%-40s %12llu %12llu %8.3f %10.1f\n", st->name().c_str(),
+		      static_cast<unsigned long long> (st->bytes_in()),
+		      static_cast<unsigned long long> (st->bytes_out()),
+		      self, std::max (st->bytes_in(), st->bytes_out()) / self / (1024*1024));
+    }
+}
+
+} // namespace
+
+int main (int argc, char* argv[])
+try
+{
+    if (argc < 4)
+    {
+	usage();
+	return 0;
+    }
+    std::vector<std::unique_ptr<stage>> pipeline;
+    for (const auto& text : split (argv[3], '|'))
+    {
+	stage_spec spec (text);
+	pipeline.push_back (make_stage (spec));
+    }
+
+    sys::mapping::readonly in (argv[1]);
+    sys::mapping::const_view<uint8_t> view (in, 0, 0, sys::mapping::sequential);
+
+    std::FILE* out = stdout;
+    if (std::strcmp (argv[2], "-") != 0)
+    {
+	out = std::fopen (argv[2], "wb");
+	if (!out)
+	{
+	    std::fprintf (stderr, "%s: error opening output file\n", argv[2]);
+	    return 1;
+	}
+    }
+#ifdef _WIN32
+    else
+	_setmode (_fileno (stdout), _O_BINARY);
+#endif
+    pipeline.emplace_back (new writer (out));
+    for (size_t i = 1; i < pipeline.size(); ++i)
+	pipeline[i-1]->link (pipeline[i].get());
+
+    stage& first = *pipeline.front();
+    for (size_t pos = 0; pos < view.size(); pos += block_size)
+	first.push (view.data() + pos, std::min<size_t> (block_size, view.size() - pos));
+    first.finish();
+    if (out != stdout)
+	std::fclose (out);
+    report (&first);
+    return 0;
+}
+catch (std::exception& X)
+{
+    std::fprintf (stderr, "xform: %s\n", X.what());
+    return 1;
+}
@@ -5,35 +5,37 @@
 //
 
 #include "sysmemmap.h"
+#include "xform.h"
+#include "hexkey.h"
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include <fstream>
-#include <cwchar>
+#include <vector>
 
 int wmain (int argc, wchar_t* argv[])
 try
 {
     if (argc < 3)
     {
-        std::cout << "usage: xordecrypt FILENAME HEXKEY\n";
+        std::cout << "usage: xordecrypt FILENAME HEXKEY\n"
+                     "    HEXKEY of several bytes is repeated over the file, bytes are\n"
+                     "           taken in written order: 007C is two bytes 00 7C\n"
+                     "example: xordecrypt script.dat 007C\n";
         return 0;
     }
-    errno = 0;
-    wchar_t* endptr;
-    long key = std::wcstol (argv[2], &endptr, 16);
-    if (0 != errno)
+    std::vector<uint8_t> key;
+    if (!parse_hex_key (argv[2], key))
         throw std::runtime_error ("invalid key");
-    if (0 == key)
+    if (std::all_of (key.begin(), key.end(), [] (uint8_t b) { return 0 == b; }))
     {
         std::cout << "zero key: X xor 0 = X\n";
         return 0;
     }
 
     sys::mapping::readwrite in (argv[1]);
-    sys::mapping::view<uint8_t> view (in);
-    for (auto it = view.begin(); it != view.end(); ++it)
-    {
-        *it ^= key;
-    }
+    sys::mapping::view<uint8_t> view (in, 0, 0, sys::mapping::populate);
+    xform::xor_key (view.data(), view.size(), key.data(), key.size());
     return 0;
 }
 catch (std::exception& X)
@@ -0,0 +1,51 @@
+// -*- C++ -*-
+//! \file       agsikey.h
+//! \date       2026 Oct 16
+//! \brief      keystream cipher of Agsi32 GSS and AGS files.
+//
+
+#ifndef AGSIKEY_H
+#define AGSIKEY_H
+
+#include "xform.h"
+#include <algorithm>
+
+// rotl_keystream (SRC, DST, SIZE, POS, KEY)
+// Effects: XORs SIZE bytes of SRC with keystream of little-endian dwords,
+// where dword N is KEY + N/31 rotated left by N%31 bits, and stores result
+// into DST.  POS is the offset of SRC within the stream, multiple of 4, so
+// stream could be decrypted in chunks independently.  keystream is generated
+// block by block into buffer that stays in L1 cache.
+
+inline void rotl_keystream (const uint8_t* src, uint8_t* dst, size_t size, size_t pos, uint32_t key)
+{
+    uint8_t stream[0x1000];
+    uint32_t div = static_cast<uint32_t> ((pos >> 2) / 31);
+    unsigned rem = static_cast<unsigned> ((pos >> 2) % 31);
+    for (size_t i = 0; i < size; i += sizeof(stream))
+    {
+        size_t count = std::min (sizeof(stream), size - i);
+        for (size_t j = 0; j < count; j += 4)
+        {
+            uint32_t v = key + div;
+            uint32_t t = v << rem | v >> (-rem & 0x1F);
+            stream[j]   = static_cast<uint8_t> (t);
+            stream[j+1] = static_cast<uint8_t> (t >> 8);
+            stream[j+2] = static_cast<uint8_t> (t >> 16);
+            stream[j+3] = static_cast<uint8_t> (t >> 24);
+            if (31 == ++rem)
+            {
+                rem = 0;
+                ++div;
+            }
+        }
+        xform::xor_stream (src + i, dst + i, count, stream);
+    }
+}
+
+inline void rotl_keystream (uint8_t* data, size_t size, size_t pos, uint32_t key)
+{
+    rotl_keystream (data, data, size, pos, key);
+}
+
+#endif /* AGSIKEY_H */
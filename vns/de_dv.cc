@@ -6,28 +6,11 @@
 //
 
 #include "sysmemmap.h"
+#include "zio.h"
+#include "xform.h"
 #include <iostream>
 #include <fstream>
-#include <zlib.h>
-
-void zlib_unpack (const uint8_t* input, size_t in_size, uint8_t* output, size_t out_size)
-{
-    z_stream stream = { 0 };
-    stream.next_in = const_cast<uint8_t*> (input);
-    stream.avail_in = in_size;
-
-    int err = inflateInit (&stream);
-    if (err != Z_OK)
-        throw std::runtime_error ("zlib initialization error");
-
-    stream.next_out = output;
-    stream.avail_out = out_size;
-    err = inflate (&stream, Z_NO_FLUSH);
-    inflateEnd (&stream);
-
-    if (Z_STREAM_ERROR == err)
-        throw std::runtime_error ("invalid compressed stream");
-}
+#include <memory>
 
 int wmain (int argc, wchar_t* argv[])
 try
@@ -44,9 +27,8 @@ try
 
     size_t unpacked_size = *reinterpret_cast<const uint32_t*> (&view[0xC]);
     std::unique_ptr<uint8_t[]> output (new uint8_t[unpacked_size]);
-    zlib_unpack (&view[0x10], view.size() - 0x10, output.get(), unpacked_size);
-    for (size_t i = 0; i < unpacked_size; ++i)
-        output[i] ^= 0xFF;
+    unpacked_size = zio::inflate_to (&view[0x10], view.size() - 0x10, output.get(), unpacked_size);
+    xform::invert (output.get(), unpacked_size);
 
     std::ofstream out (argv[2], std::ios::binary|std::ios::trunc|std::ios::out);
     if (!out)
@@ -5,54 +5,35 @@
 //
 
 #include <cstdint>
-#include <fstream>
 #include <cstdio>
 #include "sysmemmap.h"
+#include "parallel.h"
+#include "agsikey.h"
 
 const uint32_t g_default_key = 0x20041001;
 
-inline unsigned rotL (unsigned v, int count)
-{
-    count &= 0x1F;
-    return v << count | v >> (32-count);
-}
-
-void decrypt (uint8_t* data, size_t size, uint32_t key)
-{
-    for (size_t i = 0; i < size; i += 4)
-    {
-        int rem = (i >> 2) % 31;
-        int div = (i >> 2) / 31;
-        unsigned t = rotL (key + div, rem);
-        size_t chunk = std::min (4u, size-i);
-        for (int j = 0; j < chunk; ++j)
-            data[i+j] ^= t >> (j << 3);
-    }
-}
-
 int wmain (int argc, wchar_t* argv[])
 try
 {
-    if (argc < 3)
+    int argn = 1;
+    unsigned threads = sys::threads_option (argc, argv, argn);
+    if (argc - argn < 2)
     {
-        std::puts ("usage: deags32i INPUT OUTPUT");
+        std::puts ("usage: deags32i [-j THREADS] INPUT OUTPUT");
         return 0;
     }
-    sys::mapping::readwrite in (argv[1], sys::mapping::writecopy);
+    sys::mapping::readonly in (argv[argn]);
     if (in.size() < 4)
     {
-        std::fprintf (stderr, "%S: invalid input\n", argv[1]);
-        return 1;
-    }
-    sys::mapping::view<uint8_t> view (in);
-    decrypt (view.data(), view.size(), g_default_key);
-    std::ofstream out (argv[2], std::ios::out|std::ios::binary|std::ios::trunc);
-    if (!out)
-    {
-        std::fprintf (stderr, "%S: error opening output file\n", argv[2]);
+        std::fprintf (stderr, "%S: invalid input\n", argv[argn]);
         return 1;
     }
-    out.write (reinterpret_cast<char*> (view.data()), view.size());
+    sys::mapping::const_view<uint8_t> view (in);
+    sys::mapping::output_file out (argv[argn+1], view.size());
+    sys::parallel (view.size(), threads, 0x100000, [&] (size_t pos, size_t size) {
+        rotl_keystream (view.data() + pos, out.data() + pos, size, pos, g_default_key);
+    });
+    out.commit (view.size());
     return 0;
 }
 catch (std::exception& X)
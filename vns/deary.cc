@@ -8,7 +8,7 @@
 #include <fstream>
 #include <sstream>
 #include "sysmemmap.h"
-#include "lzss.h"
+#include "lzssdec.h"
 
 int wmain (int argc, wchar_t* argv[])
 try
@@ -18,23 +18,25 @@ try
         std::puts ("usage: deary INPUT OUTPUT");
         return 0;
     }
-    sys::mapping::readwrite in (argv[1], sys::mapping::writecopy);
+    sys::mapping::readonly in (argv[1]);
     if (in.size() < 12)
     {
         std::fprintf (stderr, "%S: invalid input\n", argv[1]);
         return 1;
     }
-    sys::mapping::view<uint8_t> view (in);
-    size_t packed_size = *reinterpret_cast<uint32_t*> (&view[8]);
+    sys::mapping::const_view<uint8_t> view (in);
+    size_t packed_size = *reinterpret_cast<const uint32_t*> (&view[8]);
     if (packed_size + 12 != view.size())
     {
         std::fprintf (stderr, "%S: invalid input\n", argv[1]);
         return 1;
     }
-    for (auto p = view.begin()+12; p != view.end(); ++p)
-        *p ^= 0x7C;
     std::stringstream strings;
-    lzss_decompress (view.data()+12, packed_size, strings);
+    bin::lzss_decompress<bin::lzss_params<>> (view.data()+12, packed_size, strings,
+        [] (uint8_t* data, size_t size, size_t) {
+            for (size_t i = 0; i < size; ++i)
+                data[i] ^= 0x7C;
+        });
     std::ofstream out (argv[2], std::ios::out|std::ios::trunc);
     if (!out)
     {
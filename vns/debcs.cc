@@ -9,53 +9,13 @@
 #include <vector>
 #include "sysmemmap.h"
 #include "blowfish.h"
+#include "lzssvar.h"
 
 char g_tnk_key[] = "TLibDefKey";
 
 size_t bcs_decompress (const uint8_t* packed, size_t packed_size, std::vector<uint8_t>& output)
 {
-    const size_t FrameSize = 0x1000;
-    const int FrameFill = 0;
-    const int FrameInitPos = 0xFEE;
-    const unsigned frame_mask = FrameSize-1;
-
-    sys::local_buffer<uint8_t> frame (FrameSize);
-    std::fill_n (frame.begin(), FrameSize, FrameFill);
-    int frame_pos = FrameInitPos;
-
-    auto dst = output.begin();
-    auto out_end = output.end();
-    auto const packed_end = packed + packed_size;
-    auto src = packed;
-    while (src != packed_end && dst < out_end)
-    {
-        int ctl = *src++;
-        for (int bit = 1; src != packed_end && bit != 0x100; bit <<= 1)
-        {
-            if (ctl & bit)
-            {
-                uint8_t b = *src++;
-                frame[frame_pos++ & frame_mask] = b;
-                *dst++ = b;
-            }
-            else
-            {
-                if (packed_end - src < 2)
-                    break;
-                int lo = *src++;
-                int hi = *src++;
-                int offset = (hi & 0xF0) << 4 | lo;
-                int count = 3 + (~hi & 0xF);
-                for (int i = 0; i < count && dst < out_end; ++i)
-                {
-                    uint8_t v = frame[offset++ & frame_mask];
-                    frame[frame_pos++ & frame_mask] = v;
-                    *dst++ = v;
-                }
-            }
-        }
-    }
-    return dst - output.begin();
+    return bin::lzss_decompress<bin::bcs_lzss> (packed, packed_size, output.data(), output.size());
 }
 
 void tnk_decrypt (uint8_t* data, size_t length, std::ostream& out)
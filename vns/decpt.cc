@@ -5,9 +5,8 @@
 //
 
 #include <cstdio>
-#include <fstream>
-#include <vector>
 #include "sysmemmap.h"
+#include "parallel.h"
 
 namespace abel {
     int s_seed;
@@ -48,13 +47,15 @@ void init_decrypt_table (unsigned seed)
     }
 }
 
-void decrypt_cpt (uint8_t* data, size_t length)
+// every byte depends on the preceding encrypted byte only, PREV is the byte
+// before SRC, zero at the start of file.
+
+void decrypt_cpt (const uint8_t* src, uint8_t* dst, size_t length, uint8_t prev)
 {
-    uint8_t prev = 0;
     for (size_t i = 0; i < length; ++i)
     {
-        auto x = data[i];
-        data[i] = g_decrypt_table[(x - prev) & 0xFF];
+        auto x = src[i];
+        dst[i] = g_decrypt_table[(x - prev) & 0xFF];
         prev = x;
     }
 }
@@ -62,22 +63,21 @@ void decrypt_cpt (uint8_t* data, size_t length)
 int wmain (int argc, wchar_t* argv[])
 try
 {
-    if (argc < 3)
+    int argn = 1;
+    unsigned threads = sys::threads_option (argc, argv, argn);
+    if (argc - argn < 2)
     {
-        std::puts ("usage: decpt INPUT OUTPUT");
+        std::puts ("usage: decpt [-j THREADS] INPUT OUTPUT");
         return 0;
     }
     init_decrypt_table (0x03429195);
-    sys::mapping::readwrite in (argv[1], sys::mapping::writecopy);
-    sys::mapping::view<uint8_t> view (in);
-    decrypt_cpt (view.data(), view.size());
-    std::ofstream out (argv[2], std::ios::out|std::ios::binary|std::ios::trunc);
-    if (!out)
-    {
-        std::fprintf (stderr, "%S: error opening output file\n", argv[2]);
-        return 1;
-    }
-    out.write (reinterpret_cast<char*> (view.data()), view.size());
+    sys::mapping::readonly in (argv[argn]);
+    sys::mapping::const_view<uint8_t> view (in);
+    sys::mapping::output_file out (argv[argn+1], view.size());
+    sys::parallel (view.size(), threads, 0x100000, [&] (size_t pos, size_t size) {
+        decrypt_cpt (view.data() + pos, out.data() + pos, size, pos ? view[pos-1] : 0);
+    });
+    out.commit (view.size());
     return 0;
 }
 catch (std::exception& X)
@@ -5,6 +5,7 @@
 //
 
 #include "sysmemmap.h"
+#include "xform.h"
 #include <cstdio>
 #include <fstream>
 
@@ -78,8 +79,7 @@ try
             return 0;
     }
     auto start = ptr;
-    for (size_t i = 0; i < size; ++i)
-        ptr[i] ^= 0x7F;
+    xform::xor_byte (ptr, size, 0x7F);
 
     std::ofstream out (out_name, std::ios::out|std::ios::binary|std::ios::trunc);
     if (out)
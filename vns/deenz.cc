@@ -6,49 +6,8 @@
 
 #include <iostream>
 #include <fstream>
-#include <zlib.h>
 #include "sysmemmap.h"
-
-void uncompress (const uint8_t* input, size_t input_size, std::ostream& out)
-{
-    z_stream stream = { 0 };
-    stream.next_in = const_cast<uint8_t*> (input);
-    stream.avail_in = input_size;
-    static uint8_t dest[0x1000];
-    int err = inflateInit (&stream);
-    if (err != Z_OK)
-        throw std::runtime_error ("zlib initialization error");
-    try
-    {
-        do
-        {
-            stream.next_out = dest;
-            stream.avail_out = sizeof(dest);
-            err = inflate (&stream, Z_NO_FLUSH);
-            if (Z_STREAM_ERROR == err)
-                throw std::runtime_error ("invalid compressed stream");
-            switch (err)
-            {
-            case Z_NEED_DICT:
-                err = Z_DATA_ERROR;
-                /* FALL THROUGH */
-            case Z_DATA_ERROR:
-            case Z_MEM_ERROR:
-                inflateEnd (&stream);
-                std::cerr << "zlib data error at " << std::hex << (stream.next_in - input) << '\n';
-                return;
-            }
-            int have = 0x1000 - stream.avail_out;
-            out.write ((char*)dest, have);
-        } while (0 == stream.avail_out);
-    }
-    catch (...)
-    {
-        inflateEnd (&stream);
-        throw;
-    }
-    inflateEnd (&stream);
-}
+#include "zio.h"
 
 int main (int argc, char* argv[])
 try
@@ -78,7 +37,17 @@ try
     if ('Z' != view[3])
         out.write ((char*)view.data()+8, view.size()-8);
     else
-        uncompress (view.data()+8, view.size()-8, out);
+    {
+        // data decoded before error is kept, error is not fatal
+        try
+        {
+            zio::inflate_to (view.data()+8, view.size()-8, out);
+        }
+        catch (zio::data_error& X)
+        {
+            std::cerr << "zlib data error at " << std::hex << X.offset() << '\n';
+        }
+    }
     return 0;
 }
 catch (std::exception& X)
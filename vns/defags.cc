@@ -5,58 +5,11 @@
 //
 
 #include "sysmemmap.h"
+#include "fags.h"
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 
-void decrypt (uint8_t* data, size_t size, uint32_t seed)
-{
-    size /= 4;
-    if (0 == size)
-        return;
-    uint16_t ctl[32];
-    uint32_t key[32];
-
-    for (int i = 0; i < 32; ++i)
-    {
-        uint32_t code = 0;
-        uint32_t k = seed;
-        for (int j = 0; j < 16; ++j)
-        {
-            code = (k ^ (k >> 1)) << 15 | (code & 0xFFFF) >> 1;
-            k >>= 2;
-        }		
-        key[i] = seed;
-        ctl[i] = code;
-        seed = seed << 1 | seed >> 31;
-    }
-    uint32_t* data32 = reinterpret_cast<uint32_t*> (data);
-    for (int i = 0; i < size; ++i)
-    {
-        auto s = *data32;
-        auto code = ctl[i & 0x1F];
-        unsigned d = 0;
-        unsigned v3 = 3;
-        unsigned v2 = 2;
-        unsigned v1 = 1;
-        for (int j = 0; j < 16; ++j)
-        {
-            if (0 != (code & 1))
-            {
-                d |= (s & v1) << 1 | (s >> 1) & (v2 >> 1);
-            }
-            else
-            {
-                d |= s & v3;
-            }
-            code >>= 1;
-            v3 <<= 2;
-            v2 <<= 2;
-            v1 <<= 2;
-        }
-        *data32++ = d ^ key[i & 0x1F];
-    }
-}
-
 void dump_text (const uint8_t* data, size_t size, std::ostream& out)
 {
     size /= 2;
@@ -109,7 +62,7 @@ try
             0 == std::memcmp (ptr, "cFNM", 4))
         {
             uint32_t key = *reinterpret_cast<uint32_t*> (ptr+12);
-            decrypt (data, data_size, key);
+            fags_decrypt (data, data_size, key);
             if (0 == std::memcmp (ptr, "cTEX", 4) && argc > 2)
             {
                 std::ofstream out (argv[2], std::ios::out|std::ios::binary|std::ios::trunc);
@@ -120,7 +73,7 @@ try
         else if (0 == std::memcmp (ptr, "cCOD", 4))
         {
             uint32_t key = *reinterpret_cast<uint32_t*> (ptr+16);
-            decrypt (data, data_size, key);
+            fags_decrypt (data, data_size, key);
         }
         ptr += section_size;
         remaining -= section_size;
@@ -5,55 +5,35 @@
 //
 
 #include <cstdio>
-#include <fstream>
 #include "sysmemmap.h"
+#include "parallel.h"
+#include "agsikey.h"
 
 unsigned g_default_key = 0x20041105;
 
-namespace {
-    unsigned rotl (unsigned arg, int shift)
-    {
-        return arg << shift | arg >> (32 - shift);
-    }
-
-    void decrypt (uint8_t* data, size_t size, unsigned key)
-    {
-        for (size_t i = 0; i < size; )
-        {
-            int rem = (i >> 2) % 31;
-            unsigned div = (i >> 2) / 31;
-            unsigned t = rotl (key + div, rem);
-            data[i++] ^= t;
-            data[i++] ^= t >> 8;
-            data[i++] ^= t >> 16;
-            data[i++] ^= t >> 24;
-        }
-    }
-}
-
 int wmain (int argc, wchar_t* argv[])
 try
 {
-    if (argc < 3)
+    int argn = 1;
+    unsigned threads = sys::threads_option (argc, argv, argn);
+    if (argc - argn < 2)
     {
-        std::puts ("usage: degss INPUT OUTPUT");
+        std::puts ("usage: degss [-j THREADS] INPUT OUTPUT");
         return 0;
     }
-    sys::mapping::readwrite in (argv[1], sys::mapping::writecopy);
+    sys::mapping::readonly in (argv[argn]);
     if (in.size() < 2)
     {
-        std::fprintf (stderr, "%S: invalid input\n", argv[1]);
-        return 1;
-    }
-    sys::mapping::view<uint8_t> view (in);
-    decrypt (view.data(), view.size(), g_default_key);
-    std::ofstream out (argv[2], std::ios::out|std::ios::binary|std::ios::trunc);
-    if (!out)
-    {
-        std::fprintf (stderr, "%S: error opening output file\n", argv[2]);
+        std::fprintf (stderr, "%S: invalid input\n", argv[argn]);
         return 1;
     }
-    out.write (reinterpret_cast<char*> (view.data()), view.size());
+    sys::mapping::const_view<uint8_t> view (in, 0, 0, sys::mapping::populate);
+    sys::mapping::output_file out (argv[argn+1], view.size());
+    // chunks are multiples of dword
+    sys::parallel (view.size(), threads, 0x100000, [&] (size_t pos, size_t count) {
+        rotl_keystream (view.data() + pos, out.data() + pos, count, pos, g_default_key);
+    });
+    out.commit (view.size());
     return 0;
 }
 catch (std::exception& X)
@@ -4,9 +4,11 @@
 //! \brief      decrypt KAAS game script.
 //
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include "sysmemmap.h"
+#include "xform.h"
 
 int wmain (int argc, wchar_t* argv[])
 try
@@ -36,12 +38,10 @@ try
         std::fprintf (stderr, "%S: invalid input [2]\n", argv[1]);
         return 1;
     }
-    uint16_t* data = reinterpret_cast<uint16_t*> (view.data() + 4 * pos);
-    do
-    {
-        *data++ ^= 1;
-    }
-    while (--count > 0);
+    // script consists of little-endian words XOR-ed with 1
+    static const uint8_t key[2] = { 1, 0 };
+    size_t size = std::min (count * 2, view.size() - pos * 4) & ~size_t (1);
+    xform::xor_key (view.data() + 4 * pos, size, key, 2);
     return 0;
 }
 catch (std::exception& X)
@@ -5,6 +5,8 @@
 //
 
 #include "sysmemmap.h"
+#include "xform.h"
+#include <algorithm>
 #include <cstdio>
 
 int main (int argc, char* argv[])
@@ -17,10 +19,13 @@ try
     }
     sys::mapping::readwrite in (argv[1]);
     sys::mapping::view<uint8_t> view (in);
-    for (auto ptr = view.begin(); ptr != view.end(); ++ptr)
+    // both passes over a block that stays in L1 cache
+    const size_t block_size = 0x4000;
+    for (size_t pos = 0; pos < view.size(); pos += block_size)
     {
-        uint8_t v = *ptr ^ 0x39;
-        *ptr = v >> 3 | v << 5;
+        size_t size = std::min (block_size, view.size() - pos);
+        xform::xor_byte (view.data() + pos, size, 0x39);
+        xform::ror (view.data() + pos, size, 3);
     }
     return 0;
 }
@@ -5,9 +5,11 @@
 //
 // [020412][Ciel] Maid Hunter Zero One ~Nora Maid~
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include "sysmemmap.h"
+#include "xform.h"
 
 int wmain (int argc, wchar_t* argv[])
 try
@@ -31,11 +33,8 @@ try
         std::fprintf (stderr, "%S: invalid LW script\n", argv[1]);
         return 1;
     }
-    uint32_t* p = reinterpret_cast<uint32_t*> (&view[text_pos]);
-    for (size_t i = 0; i < text_size; ++i)
-    {
-        p[i] ^= 0xFFFFFFFF;
-    }
+    // text size is in dwords, inversion stops at the end of file
+    xform::invert (&view[text_pos], std::min (text_size * 4, view.size() - text_pos));
     std::ofstream out (argv[2], std::ios::out|std::ios::trunc);
     if (!out)
     {
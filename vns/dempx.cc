@@ -5,6 +5,7 @@
 //
 
 #include "sysmemmap.h"
+#include "xform.h"
 
 int wmain (int argc, wchar_t* argv[])
 try
@@ -34,9 +35,7 @@ try
         std::fprintf (stderr, "%S: invalid MPX file.\n", argv[1]);
         return 1;
     }
-    auto begin = view.data() + offset;
-    for (auto end = begin + size; begin != end; ++begin)
-        *begin ^= 0x24;
+    xform::xor_byte (view.data() + offset, size, 0x24);
     return 0;
 }
 catch (std::exception& X)
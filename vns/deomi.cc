@@ -4,29 +4,47 @@
 //! \brief      decrypt OMI-ScriptEngine files.
 
 #include <cstdio>
-#include <fstream>
 #include "sysmemmap.h"
+#include "lcg.h"
+#include "xform.h"
+#include "parallel.h"
 
-void decrypt (uint8_t* data, size_t length, uint32_t key)
+// key = 5 * key - 3
+const bin::lcg_step<uint32_t> omi_lcg = { 5, 0xFFFFFFFD };
+
+// decrypt (DATA, LENGTH, POS, KEY)
+// POS is the offset of DATA within file, KEY is the key of the first byte of
+// file.  generator is advanced to POS, then keystream is produced in blocks
+// that stay in L1 cache, see bin::lcg_bytes.
+
+void decrypt (uint8_t* data, size_t length, size_t pos, uint32_t key)
 {
-    for (size_t i = 0; i < length; ++i)
+    key = bin::lcg_jump (omi_lcg, pos) (key);
+    uint8_t stream[0x1000];
+    for (size_t i = 0; i < length; i += sizeof(stream))
     {
-        data[i] = ((data[i] << 7) | (data[i] >> 1)) - key;
-        key = 5 * key - 3;
+        size_t count = std::min (sizeof(stream), length - i);
+        bin::lcg_bytes (omi_lcg, key, stream, count);
+        xform::ror (data + i, count, 1);
+        xform::sub_stream (data + i, count, stream);
     }
 }
 
 int wmain (int argc, wchar_t* argv[])
 try
 {
-    if (argc < 2)
+    int argn = 1;
+    unsigned threads = sys::threads_option (argc, argv, argn);
+    if (argc - argn < 1)
     {
-        std::puts ("usage: deomi INPUT");
+        std::puts ("usage: deomi [-j THREADS] INPUT");
         return 0;
     }
-    sys::mapping::readwrite in (argv[1]);
+    sys::mapping::readwrite in (argv[argn]);
     sys::mapping::view<uint8_t> view (in);
-    decrypt (view.data(), view.size(), 7654321);
+    sys::parallel (view.size(), threads, 0x100000, [&] (size_t pos, size_t size) {
+        decrypt (view.data() + pos, size, pos, 7654321);
+    });
     return 0;
 }
 catch (std::exception& X)
@@ -5,7 +5,9 @@
 //
 
 #include <fstream>
+#include <vector>
 #include "sysmemmap.h"
+#include "lzssvar.h"
 
 uint8_t rot_byte_r (uint8_t x, int count)
 {
@@ -13,55 +15,43 @@ uint8_t rot_byte_r (uint8_t x, int count)
     return x >> count | x << (8 - count);
 }
 
-void decrypt_ps2 (uint8_t* data, size_t length)
+// ps2_cipher
+// script body following 0x30-byte header is encrypted with key stored in the
+// header.
+
+class ps2_cipher
 {
-    unsigned key = *reinterpret_cast<uint32_t*> (&data[12]);
-    int shift = static_cast<int> (key >> 20) % 5 + 1;
-    key = (key >> 24) + (key >> 3);
-    for (int i = 0x30; i < length; ++i)
+public:
+    explicit ps2_cipher (const uint8_t* header)
     {
-        data[i] = rot_byte_r (static_cast<uint8_t> (key ^ (data[i] - 0x7Cu)), shift);
+        unsigned key = *reinterpret_cast<const uint32_t*> (&header[12]);
+        m_shift = static_cast<int> (key >> 20) % 5 + 1;
+        m_key = (key >> 24) + (key >> 3);
     }
-}
 
-void unpack_lzss (const uint8_t* data, size_t size, std::ostream& out)
-{
-    static uint8_t frame[0x800];
-    int frame_pos = 0x7DF;
-    int unpacked_size = *reinterpret_cast<const int32_t*> (&data[0x28]);
-    out.write (reinterpret_cast<const char*> (data), 0x30);
-    int src = 0x30;
-    int dst = 0;
-    int ctl = 1;
-    while (dst < unpacked_size && src < size)
+    void operator() (uint8_t* data, size_t length, size_t = 0) const
     {
-        if (1 == ctl)
-            ctl = data[src++] | 0x100;
-        if (0 != (ctl & 1))
-        {
-            auto b = data[src++];
-            out.put (b);
-            frame[frame_pos++] = b;
-            frame_pos &= 0x7FF;
-            dst++;
-        }
-        else
+        for (size_t i = 0; i < length; ++i)
         {
-            int lo = data[src++];
-            int hi = data[src++];
-            int offset = lo | (hi & 0xE0) << 3;
-            int count = (hi & 0x1F) + 2;
-            dst += count;
-            for (int i = 0; i < count; ++i)
-            {
-                auto b = frame[(offset + i) & 0x7FF];
-                out.put (b);
-                frame[frame_pos++] = b;
-                frame_pos &= 0x7FF;
-            }
+            data[i] = rot_byte_r (static_cast<uint8_t> (m_key ^ (data[i] - 0x7Cu)), m_shift);
         }
-        ctl >>= 1;
     }
+
+private:
+    unsigned    m_key;
+    int         m_shift;
+};
+
+// script body is decrypted as decoder reads it.
+
+void unpack_lzss (const uint8_t* data, size_t size, std::ostream& out)
+{
+    size_t unpacked_size = *reinterpret_cast<const uint32_t*> (&data[0x28]);
+    out.write (reinterpret_cast<const char*> (data), 0x30);
+    std::vector<uint8_t> output (unpacked_size);
+    unpacked_size = bin::lzss_decompress<bin::ps2_lzss> (data+0x30, size-0x30, output.data(), output.size(),
+                                                         ps2_cipher (data));
+    out.write (reinterpret_cast<const char*> (output.data()), unpacked_size);
 }
 
 int wmain (int argc, wchar_t* argv[])
@@ -72,14 +62,13 @@ try
         std::puts ("usage: debcs INPUT OUTPUT");
         return 0;
     }
-    sys::mapping::readwrite in (argv[1], sys::mapping::writecopy);
-    sys::mapping::view<uint8_t> view (in);
+    sys::mapping::readonly in (argv[1]);
+    sys::mapping::const_view<uint8_t> view (in);
     if (view.size() < 0x30 || 0 != std::memcmp (view.data(), "PS2A", 4))
     {
         std::fprintf (stderr, "%S: invalid PS2A file\n", argv[1]);
         return 1;
     }
-    decrypt_ps2 (view.data(), view.size());
     std::ofstream out (argv[2], std::ios::out|std::ios::binary);
     if (!out)
     {
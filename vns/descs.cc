@@ -6,7 +6,11 @@
 
 #include <cstdio>
 #include <fstream>
+#include <vector>
 #include "sysmemmap.h"
+#include "lcg.h"
+#include "xform.h"
+#include "parallel.h"
 
 namespace {
     void decrypt (uint8_t* data, size_t size)
@@ -33,46 +37,81 @@ namespace {
             }
         }
     }
+
+    const bin::lcg_step<uint32_t> scs_lcg = { 69069, 0 };
+
+    // every record is XOR-ed with low bytes of KEY * 69069^(i+1).  only low
+    // bits of the product depend on low bits of factors, so 32-bit key gives
+    // the same bytes as size_t one.
+
+    void decrypt_record (uint8_t* data, size_t size, uint32_t key)
+    {
+        uint8_t stream[0x1000];
+        key *= 69069;
+        for (size_t i = 0; i < size; i += sizeof(stream))
+        {
+            size_t count = std::min (sizeof(stream), size - i);
+            bin::lcg_bytes (scs_lcg, key, stream, count);
+            xform::xor_stream (data + i, count, stream);
+        }
+    }
+
+    struct record
+    {
+        size_t  pos;    // offset of record text within file
+        size_t  size;
+    };
 }
 
 int wmain (int argc, wchar_t* argv[])
 try
 {
-    if (argc < 3)
+    int argn = 1;
+    unsigned threads = sys::threads_option (argc, argv, argn);
+    if (argc - argn < 2)
     {
-        std::puts ("usage: descs INPUT OUTPUT");
+        std::puts ("usage: descs [-j THREADS] INPUT OUTPUT");
         return 0;
     }
-    sys::mapping::readwrite in (argv[1], sys::mapping::writecopy);
+    sys::mapping::readwrite in (argv[argn], sys::mapping::writecopy);
     sys::mapping::view<uint8_t> view (in);
     if (in.size() < 4 || 0 != std::memcmp (view.data(), "PE", 2))
     {
-        std::fprintf (stderr, "%S: invalid input\n", argv[1]);
+        std::fprintf (stderr, "%S: invalid input\n", argv[argn]);
         return 1;
     }
     auto data_end = view.data() + view.size();
-    std::ofstream out (argv[2], std::ios::out|std::ios::trunc);
+    std::ofstream out (argv[argn+1], std::ios::out|std::ios::trunc);
     if (!out)
     {
-        std::fprintf (stderr, "%S: error opening output file\n", argv[2]);
+        std::fprintf (stderr, "%S: error opening output file\n", argv[argn+1]);
         return 1;
     }
+    // records are seeded by their own position, so they are decrypted in
+    // parallel once the chain of lengths is walked.
+    std::vector<record> records;
     auto ptr = view.data() + 2;
     while (ptr+1 < data_end)
     {
-        size_t key = (ptr - view.data()) | 1;
         size_t len = *reinterpret_cast<uint16_t*> (ptr);
         ptr += 2;
         if (ptr + len > data_end)
             break;
-        for (size_t i = 0; i < len; ++i)
+        record rec = { static_cast<size_t> (ptr - view.data()), len };
+        records.push_back (rec);
+        ptr += len;
+    }
+    sys::parallel (records.size(), threads, 256, [&] (size_t first, size_t count) {
+        for (size_t i = first; i < first + count; ++i)
         {
-            key *= 69069;
-            ptr[i] ^= key;
+            const record& rec = records[i];
+            decrypt_record (view.data() + rec.pos, rec.size, (rec.pos - 2) | 1);
         }
-        out.write (reinterpret_cast<char*> (ptr), len);
+    });
+    for (const auto& rec : records)
+    {
+        out.write (reinterpret_cast<char*> (view.data() + rec.pos), rec.size);
         out.put ('\n');
-        ptr += len;
     }
     return 0;
 }
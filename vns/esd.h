@@ -0,0 +1,69 @@
+// -*- C++ -*-
+//! \file       esd.h
+//! \date       2026 Oct 16
+//! \brief      decode Huffman-compressed ESD scripts (Tail software).
+//
+// file layout, all numbers are little-endian 32-bit:
+//
+//   0x00  "HP\0\0"
+//   0x08  unpacked size
+//   0x0C  root node of the tree
+//   0x10  number of leaf records
+//   0x14  number of encoded bytes
+//   0x18  tree records (node, left, right), leaves have left = -1
+//         followed by codes, most significant bit first.
+
+#ifndef ESD_H
+#define ESD_H
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "bitreader.h"
+#include "huffman.h"
+
+// esd_decode (DATA, SIZE, OUTPUT)
+// Effects: decodes ESD file of SIZE bytes at DATA into OUTPUT, which is
+// resized to unpacked size.
+// Throws: std::runtime_error if file is invalid.
+
+inline void esd_decode (const uint8_t* data, size_t size, std::vector<uint8_t>& output)
+{
+    if (size < 24 || 0 != std::memcmp (data, "HP\0", 4))
+        throw std::runtime_error ("invalid input file");
+
+    size_t unpacked_size = *reinterpret_cast<const uint32_t*> (&data[8]);
+    std::vector<int> tree_nodes (0xC00);
+
+    int root_token = *reinterpret_cast<const int32_t*> (&data[12]);
+    int dword_46C494 = *reinterpret_cast<const int32_t*> (&data[16]);
+    int packed_size = *reinterpret_cast<const int32_t*> (&data[20]);
+    int64_t node_count = int64_t (dword_46C494) + root_token - 255;
+    const int32_t* tree_src = reinterpret_cast<const int32_t*> (&data[24]);
+    if (node_count < 0 || uint64_t (node_count) > (size - 24) / 12)
+        throw std::runtime_error ("invalid input file");
+    while (node_count --> 0)
+    {
+        if (tree_src[0] < 0 || tree_src[0] >= 0x200)
+            throw std::runtime_error ("invalid input file");
+        int node = 6 * tree_src[0];
+        tree_nodes[node + 1] = tree_src[1];
+        tree_nodes[node + 2] = tree_src[2];
+        tree_src += 3;
+    }
+    bin::huffman_table<bin::msb_first> tree;
+    tree.build (root_token, tree_nodes.size() / 6,
+                [&] (int node, int bit) { return tree_nodes[6 * node + 1 + bit]; },
+                [&] (int node) { return -1 == tree_nodes[6 * node + 1]; });
+    if (packed_size < 0 || static_cast<size_t> (packed_size) > unpacked_size)
+        throw std::runtime_error ("invalid input file");
+
+    output.resize (unpacked_size);
+    bin::bit_reader<bin::msb_first> bits (reinterpret_cast<const uint8_t*> (tree_src), data + size);
+    uint8_t* dst = output.data();
+    for (int i = 0; i < packed_size; ++i)
+        *dst++ = static_cast<uint8_t> (tree.decode (bits));
+}
+
+#endif /* ESD_H */
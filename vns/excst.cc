@@ -6,8 +6,9 @@
 
 #include <iostream>
 #include <fstream>
-#include <zlib.h>
+#include <vector>
 #include "sysmemmap.h"
+#include "zio.h"
 
 int main (int argc, char* argv[])
 try
@@ -23,48 +24,29 @@ try
     if (in.size() <= 0x10)
         throw std::runtime_error ("invalid input file");
 
-    z_stream stream = { 0 };
-    stream.next_in = const_cast<uint8_t*> (view.data()+0x10);
-    stream.avail_in = view.size()-0x10;
-    static uint8_t dest[0x1000];
-    int err = inflateInit (&stream);
-    if (err != Z_OK)
+    std::vector<uint8_t> output;
+    int rc = 0;
+    try
     {
-        std::cerr << "zlib initialization error\n";
-        return 2;
+        zio::inflate_to (view.data()+0x10, view.size()-0x10, output);
     }
-    std::ofstream out;
-    do
+    catch (zio::data_error& X)
     {
-        stream.next_out = dest;
-        stream.avail_out = sizeof(dest);
-        err = inflate (&stream, Z_NO_FLUSH);
-        if (Z_STREAM_ERROR == err)
-            throw std::runtime_error ("invalid compressed stream");
-        switch (err)
-        {
-        case Z_NEED_DICT:
-            err = Z_DATA_ERROR;
-            /* FALL THROUGH */
-        case Z_DATA_ERROR:
-        case Z_MEM_ERROR:
-            inflateEnd (&stream);
-            std::cerr << argv[1] << ": zlib data error at " << std::hex << (stream.next_in - view.data()) << '\n';
+        // offset within file, data decoded before error is still written
+        std::cerr << argv[1] << ": zlib data error at " << std::hex << (X.offset() + 0x10) << '\n';
+        if (output.empty())
             return 3;
-        }
-        if (!out.is_open())
-        {
-            out.open (argv[2], std::ios::out|std::ios::binary|std::ios::trunc);
-            if (!out)
-            {
-                std::cerr << argv[2] << ": unable to open output file for writing\n";
-                return 4;
-            }
-        }
-        int have = 0x1000 - stream.avail_out;
-        out.write ((char*)dest, have);
-    } while (0 == stream.avail_out);
-    inflateEnd (&stream);
+        rc = 3;
+    }
+    std::ofstream out (argv[2], std::ios::out|std::ios::binary|std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << argv[2] << ": unable to open output file for writing\n";
+        return 4;
+    }
+    out.write (reinterpret_cast<const char*> (output.data()), output.size());
+    if (rc)
+        return rc;
     std::cout << argv[1] << " -> " << argv[2] << std::endl;
     return 0;
 }
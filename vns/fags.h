@@ -0,0 +1,86 @@
+// -*- C++ -*-
+//! \file       fags.h
+//! \date       2026 Oct 16
+//! \brief      fAGS script section cipher.
+//
+
+#ifndef FAGS_H
+#define FAGS_H
+
+#include "bindata.h"      // for SYSPP_SSE2, SYSPP_AVX2 and SIMD headers
+#include <cstring>
+
+// fags_decrypt (DATA, SIZE, SEED)
+// Effects: decrypts SIZE bytes at DATA in place, trailing bytes that don't
+// form a whole dword are left intact.
+//
+// every dword is decrypted by one of 32 control words and keys, chosen by
+// dword index modulo 32.  bit J of control word swaps bits 2J and 2J+1 of the
+// dword, which is a delta swap with mask of the lower bits of swapped pairs.
+
+inline void fags_decrypt (uint8_t* data, size_t size, uint32_t seed)
+{
+    size /= 4;
+    if (0 == size)
+        return;
+    uint32_t mask[32];
+    uint32_t key[32];
+
+    for (int i = 0; i < 32; ++i)
+    {
+        uint32_t code = 0;
+        uint32_t k = seed;
+        for (int j = 0; j < 16; ++j)
+        {
+            code = (k ^ (k >> 1)) << 15 | (code & 0xFFFF) >> 1;
+            k >>= 2;
+        }
+        uint32_t m = 0;
+        for (int j = 0; j < 16; ++j)
+            m |= (code >> j & 1) << 2*j;
+        key[i] = seed;
+        mask[i] = m;
+        seed = seed << 1 | seed >> 31;
+    }
+    size_t i = 0;
+#if SYSPP_SSE2
+    // whole cycles of 32 dwords, masks and keys stay in registers
+    for (; i + 32 <= size; i += 32)
+    {
+        uint8_t* block = data + i * 4;
+#if SYSPP_AVX2
+        for (int q = 0; q < 32; q += 8)
+        {
+            __m256i* p = reinterpret_cast<__m256i*> (block + q * 4);
+            __m256i v = _mm256_loadu_si256 (p);
+            __m256i m = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (mask + q));
+            __m256i t = _mm256_and_si256 (_mm256_xor_si256 (v, _mm256_srli_epi32 (v, 1)), m);
+            v = _mm256_xor_si256 (v, _mm256_xor_si256 (t, _mm256_slli_epi32 (t, 1)));
+            v = _mm256_xor_si256 (v, _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (key + q)));
+            _mm256_storeu_si256 (p, v);
+        }
+#else
+        for (int q = 0; q < 32; q += 4)
+        {
+            __m128i* p = reinterpret_cast<__m128i*> (block + q * 4);
+            __m128i v = _mm_loadu_si128 (p);
+            __m128i m = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (mask + q));
+            __m128i t = _mm_and_si128 (_mm_xor_si128 (v, _mm_srli_epi32 (v, 1)), m);
+            v = _mm_xor_si128 (v, _mm_xor_si128 (t, _mm_slli_epi32 (t, 1)));
+            v = _mm_xor_si128 (v, _mm_loadu_si128 (reinterpret_cast<const __m128i*> (key + q)));
+            _mm_storeu_si128 (p, v);
+        }
+#endif
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        uint32_t s;
+        std::memcpy (&s, data + i * 4, 4);
+        uint32_t t = (s ^ s >> 1) & mask[i & 0x1F];
+        s ^= t ^ t << 1 ^ key[i & 0x1F];
+        std::memcpy (data + i * 4, &s, 4);
+    }
+}
+
+#endif /* FAGS_H */
@@ -7,27 +7,30 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include "lzss.h"
+#include "lzssdec.h"
 #include "sysmemmap.h"
-#include "membuf.hpp"
 
 struct scw_script
 {
 public:
-    scw_script (uint8_t* view, size_t view_size);
+    scw_script (const uint8_t* view, size_t view_size);
 
     void extract_text (std::ostream& out);
 
-    static void decrypt (uint8_t* data, size_t size)
+    // decrypt (DATA, SIZE, OFFSET)
+    // data is XORed with its position, OFFSET is position of DATA within
+    // encrypted block.
+
+    static void decrypt (uint8_t* data, size_t size, size_t offset = 0)
     {
         for (size_t i = 0; i < size; ++i)
-            data[i] ^= i;
+            data[i] ^= offset + i;
     }
 
 private:
-    void read_scw4_header (uint8_t* view, size_t view_size);
-    void read_scw5_header (uint8_t* view, size_t view_size);
-    void unpack_data (uint8_t* data, size_t data_size);
+    void read_scw4_header (const uint8_t* view, size_t view_size);
+    void read_scw5_header (const uint8_t* view, size_t view_size);
+    void unpack_data (const uint8_t* data, size_t data_size);
 
 private:
     int         version;
@@ -44,7 +47,7 @@ private:
 };
 
 scw_script::
-scw_script (uint8_t* view, size_t view_size)
+scw_script (const uint8_t* view, size_t view_size)
 {
     if (0 == std::memcmp (view, "Scw4.x", 7))
         read_scw4_header (view, view_size);
@@ -63,49 +66,50 @@ scw_script (uint8_t* view, size_t view_size)
 }
 
 void scw_script::
-read_scw4_header (uint8_t* view, size_t view_size)
+read_scw4_header (const uint8_t* view, size_t view_size)
 {
     version = 4;
-    compressed = -1 == *(int32_t*)&view[0x14];
-    unpacked_size = *(uint32_t*)&view[0x18];
-    packed_size = *(uint32_t*)&view[0x1c];
-    number_of_commands = *(uint32_t*)&view[0x24];
-    number_of_strings = *(uint32_t*)&view[0x28];
-    number_of_extra = *(uint32_t*)&view[0x2C];
-    command_table_size = *(uint32_t*)&view[0x30];
-    string_table_size = *(uint32_t*)&view[0x34];
+    compressed = -1 == *(const int32_t*)&view[0x14];
+    unpacked_size = *(const uint32_t*)&view[0x18];
+    packed_size = *(const uint32_t*)&view[0x1c];
+    number_of_commands = *(const uint32_t*)&view[0x24];
+    number_of_strings = *(const uint32_t*)&view[0x28];
+    number_of_extra = *(const uint32_t*)&view[0x2C];
+    command_table_size = *(const uint32_t*)&view[0x30];
+    string_table_size = *(const uint32_t*)&view[0x34];
     data_offset = 0x1c4;
 }
 
 void scw_script::
-read_scw5_header (uint8_t* view, size_t view_size)
+read_scw5_header (const uint8_t* view, size_t view_size)
 {
     version = 5;
-    compressed = -1 == *(int32_t*)&view[0x14];
-    unpacked_size = *(uint32_t*)&view[0x18];
-    packed_size = *(uint32_t*)&view[0x1c];
-    number_of_commands = *(uint32_t*)&view[0x24];
-    number_of_strings = *(uint32_t*)&view[0x28];
-    number_of_extra = *(uint32_t*)&view[0x2C];
-    command_table_size = *(uint32_t*)&view[0x30];
-    string_table_size = *(uint32_t*)&view[0x34];
+    compressed = -1 == *(const int32_t*)&view[0x14];
+    unpacked_size = *(const uint32_t*)&view[0x18];
+    packed_size = *(const uint32_t*)&view[0x1c];
+    number_of_commands = *(const uint32_t*)&view[0x24];
+    number_of_strings = *(const uint32_t*)&view[0x28];
+    number_of_extra = *(const uint32_t*)&view[0x2C];
+    command_table_size = *(const uint32_t*)&view[0x30];
+    string_table_size = *(const uint32_t*)&view[0x34];
     data_offset = 0x1c8;
 }
 
 void scw_script::
-unpack_data (uint8_t* data, size_t data_size)
+unpack_data (const uint8_t* data, size_t data_size)
 {
-    decrypt (data, data_size);
-
     script_data.resize (unpacked_size);
     if (compressed)
     {
-        sys::memory_buf mem_buf ((char*)script_data.data(), script_data.size(), std::ios::out);
-        std::ostream out (&mem_buf);
-        lzss_decompress (data, data_size, out);
+        // input is decrypted chunk by chunk as decoder reads it
+        bin::lzss_decompress<bin::lzss_params<>> (data, data_size, script_data.data(), script_data.size(),
+            [] (uint8_t* chunk, size_t n, size_t offset) { decrypt (chunk, n, offset); });
     }
     else
+    {
         std::copy_n (data, data_size, script_data.data());
+        decrypt (script_data.data(), data_size);
+    }
 }
 
 void scw_script::
@@ -129,7 +133,7 @@ extract_text (std::ostream& out)
     }
 }
 
-void extract_scw3_text (const uint32_t* offset_table, size_t count, char* data, size_t size, std::ostream& out)
+void extract_scw3_text (const uint32_t* offset_table, size_t count, const char* data, size_t size, std::ostream& out)
 {
     for (size_t i = 0; i < count; ++i)
     {
@@ -140,47 +144,57 @@ void extract_scw3_text (const uint32_t* offset_table, size_t count, char* data,
     }
 }
 
-void extract_scw3 (uint8_t* view, size_t size, std::ostream& out)
+// decrypts a copy of encrypted strings block, so that input could be mapped
+// read-only.
+
+void extract_scw3_strings (const uint32_t* offset_table, size_t count, const uint8_t* data, size_t size,
+                           std::ostream& out)
+{
+    std::vector<uint8_t> text (data, data + size);
+    scw_script::decrypt (text.data(), size);
+    text.push_back (0);
+    extract_scw3_text (offset_table, count, reinterpret_cast<const char*> (text.data()), size, out);
+}
+
+void extract_scw3 (const uint8_t* view, size_t size, std::ostream& out)
 {
-    if (0x03000000 != *reinterpret_cast<uint32_t*> (&view[0x10]))
+    if (0x03000000 != *reinterpret_cast<const uint32_t*> (&view[0x10]))
         throw std::runtime_error ("invalid SCW file version");
 
-    size_t num1 = *(uint32_t*)&view[0x20];
-    size_t num2 = *(uint32_t*)&view[0x24];
-    size_t num3 = *(uint32_t*)&view[0x28];
-    size_t num4 = *(uint32_t*)&view[0x38];
-    size_t num5 = *(uint32_t*)&view[0x3C];
+    size_t num1 = *(const uint32_t*)&view[0x20];
+    size_t num2 = *(const uint32_t*)&view[0x24];
+    size_t num3 = *(const uint32_t*)&view[0x28];
+    size_t num4 = *(const uint32_t*)&view[0x38];
+    size_t num5 = *(const uint32_t*)&view[0x3C];
     size_t data_offset = 0x100;
     data_offset += num1 * 16;
-    uint32_t* string_table1 = reinterpret_cast<uint32_t*> (view + data_offset);
+    const uint32_t* string_table1 = reinterpret_cast<const uint32_t*> (view + data_offset);
     data_offset += num2 * 16;
-    uint32_t* string_table2 = reinterpret_cast<uint32_t*> (view + data_offset);
+    const uint32_t* string_table2 = reinterpret_cast<const uint32_t*> (view + data_offset);
     data_offset += num3 * 16;
     data_offset += num4 * 8;
     data_offset += num5 * 8;
     if (num1)
     {
-        data_offset += *reinterpret_cast<uint32_t*> (&view[0x2C]);
+        data_offset += *reinterpret_cast<const uint32_t*> (&view[0x2C]);
     }
     if (num2)
     {
         auto data = view + data_offset;
-        size_t size = *reinterpret_cast<uint32_t*> (&view[0x30]);
+        size_t size = *reinterpret_cast<const uint32_t*> (&view[0x30]);
         if (size)
         {
-            scw_script::decrypt (data, size);
-            extract_scw3_text (string_table1, num2, reinterpret_cast<char*> (data), size, out);
+            extract_scw3_strings (string_table1, num2, data, size, out);
             data_offset += size;
         }
     }
     if (num3)
     {
         auto data = view + data_offset;
-        size_t size = *reinterpret_cast<uint32_t*> (&view[0x34]);
+        size_t size = *reinterpret_cast<const uint32_t*> (&view[0x34]);
         if (size)
         {
-            scw_script::decrypt (data, size);
-            extract_scw3_text (string_table1, num2, reinterpret_cast<char*> (data), size, out);
+            extract_scw3_strings (string_table1, num2, data, size, out);
             data_offset += size;
         }
     }
@@ -194,10 +208,10 @@ try
         std::cout << "usage: scwextract INPUT OUTPUT\n";
         return 0;
     }
-    sys::mapping::readwrite in (argv[1], sys::mapping::writecopy);
-    sys::mapping::view<uint8_t> view (in);
+    sys::mapping::readonly in (argv[1]);
+    sys::mapping::const_view<uint8_t> view (in);
     if (view.size() > 0x14 && 0 == std::memcmp (view.data(), "SCW for GsWin", 13)
-        && 0x03000000 == *reinterpret_cast<uint32_t*> (&view[0x10]))
+        && 0x03000000 == *reinterpret_cast<const uint32_t*> (&view[0x10]))
     {
         std::ofstream out (argv[2], std::ios::out|std::ios::trunc);
         extract_scw3 (view.data(), view.size(), out);